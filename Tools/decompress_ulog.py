@@ -0,0 +1,145 @@
+#!/usr/bin/env python3
+"""
+Decompress a compressed ULog file (.ulgz, written by the logger with SDLOG_COMPRESS enabled)
+into a regular .ulg file, which can then be used with pyulog and the other ULog tools.
+
+The file consists of a header followed by independently compressed (heatshrink) blocks.
+Truncated or partially corrupted files are decompressed as far as possible.
+"""
+
+import argparse
+import struct
+import sys
+import zlib
+from pathlib import Path
+
+FILE_HEADER = struct.Struct('<7sBQBBBB')  # ulog_compressed_header_s
+BLOCK_HEADER = struct.Struct('<2sHHBBI')  # ulog_compressed_block_s
+
+FILE_MAGIC = b'ULogCmp'
+BLOCK_MAGIC = b'ZB'
+COMPRESSION_HEATSHRINK = 1
+BLOCK_FLAG_STORED = 1
+
+
+def heatshrink_decompress(data, window_bits, lookahead_bits, size):
+    """ Decode a heatshrink stream (MSB first: tag bit 1 = literal byte,
+    0 = backref with window_bits index and lookahead_bits count) """
+    out = bytearray()
+    num_bits = len(data) * 8
+    bit_pos = 0
+
+    def get_bits(count):
+        nonlocal bit_pos
+        if bit_pos + count > num_bits:
+            return None
+        value = 0
+        for _ in range(count):
+            value = (value << 1) | ((data[bit_pos >> 3] >> (7 - (bit_pos & 7))) & 1)
+            bit_pos += 1
+        return value
+
+    while len(out) < size:
+        tag = get_bits(1)
+        if tag is None:
+            break
+        if tag:
+            literal = get_bits(8)
+            if literal is None:
+                break
+            out.append(literal)
+        else:
+            index = get_bits(window_bits)
+            count = get_bits(lookahead_bits)
+            if index is None or count is None:
+                break
+            offset = index + 1
+            for _ in range(count + 1):
+                # the window is zero-initialized, so references before the start of the block are zeros
+                out.append(out[-offset] if offset <= len(out) else 0)
+
+    if len(out) < size:
+        raise ValueError('block too short')
+
+    return bytes(out[:size])
+
+
+def decompress(data):
+    """ Decompress the file content, returns (ulog data, number of corrupt blocks, skipped bytes) """
+    if len(data) < FILE_HEADER.size:
+        raise ValueError('file too short')
+
+    magic, version, _, algorithm, window_bits, lookahead_bits, _ = FILE_HEADER.unpack_from(data, 0)
+
+    if magic != FILE_MAGIC:
+        raise ValueError('not a compressed ULog file')
+
+    if version != 1 or algorithm != COMPRESSION_HEATSHRINK:
+        raise ValueError('unsupported version ({}) or algorithm ({})'.format(version, algorithm))
+
+    out = bytearray()
+    corrupt_blocks = 0
+    skipped = 0
+    pos = FILE_HEADER.size
+
+    while pos + BLOCK_HEADER.size <= len(data):
+        magic, data_size, decompressed_size, flags, _, crc = BLOCK_HEADER.unpack_from(data, pos)
+
+        if magic != BLOCK_MAGIC:
+            # resync on the next block
+            pos += 1
+            skipped += 1
+            continue
+
+        start = pos + BLOCK_HEADER.size
+        block = data[start:start + data_size]
+
+        # ulog_compressed_block_crc(): the header fields from data_size on, followed by the data
+        block_crc = zlib.crc32(block, zlib.crc32(data[pos + 2:pos + BLOCK_HEADER.size - 4], 0xffffffff))
+
+        if len(block) < data_size or block_crc ^ 0xffffffff != crc:
+            # truncated, corrupt, or the magic is part of other data: resync after the magic
+            pos += 1
+            corrupt_blocks += 1
+            continue
+
+        pos = start + data_size
+
+        if flags & BLOCK_FLAG_STORED:
+            out += block
+        else:
+            try:
+                out += heatshrink_decompress(block, window_bits, lookahead_bits, decompressed_size)
+            except ValueError:
+                corrupt_blocks += 1
+
+    return bytes(out), corrupt_blocks, skipped
+
+
+if __name__ == "__main__":
+
+    parser = argparse.ArgumentParser(description="""CLI tool to decompress a .ulgz log file\n""")
+    parser.add_argument("ulog_file", help=".ulgz, compressed log file")
+    parser.add_argument("-o", "--output", help="output .ulg file (default: input file name with .ulg extension)",
+                        default=None)
+
+    args = parser.parse_args()
+
+    with open(args.ulog_file, 'rb') as f:
+        compressed = f.read()
+
+    try:
+        ulog, corrupt_blocks, skipped = decompress(compressed)
+    except ValueError as e:
+        print('Error: ' + str(e))
+        sys.exit(1)
+
+    if corrupt_blocks > 0 or skipped > 0:
+        print('Warning: log is corrupt ({} corrupt blocks, {} bytes skipped)'.format(corrupt_blocks, skipped))
+
+    outfilename = args.output or str(Path(args.ulog_file).with_suffix('.ulg'))
+    with open(outfilename, 'wb') as out:
+        out.write(ulog)
+
+    print('Wrote {} ({} bytes, compression ratio {:.2f})'.format(outfilename, len(ulog),
+                                                                len(ulog) / max(len(compressed), 1)))
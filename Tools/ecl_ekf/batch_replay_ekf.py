@@ -0,0 +1,207 @@
+#! /usr/bin/env python3
+"""
+Replays several .ulg files, or one .ulg file with several parameter sets, through the EKF in parallel.
+The replays use the offline EKF replay (ekf2_batch_replay, the EKF library driven by the sensor simulator
+of the EKF unit tests) instead of px4 SITL instances: the logs are converted to sensor data files once, and
+all the runs are isolated EKF instances on a thread pool of a single process, running as fast as possible.
+Each run starts from the EKF2 parameters of its log, followed by the parameter overrides, and writes
+replay.ulg (states, variances and aid source samples) to its output directory. The innovation test ratios of
+the aid sources (the largest of the axes for vector aid sources) are summarized at the end, and written to
+summary.csv in the output directory.
+"""
+# -*- coding: utf-8 -*-
+
+import argparse
+import concurrent.futures
+import csv
+import glob
+import os
+import subprocess
+import sys
+import time
+
+from pyulog import ULog
+
+
+def get_arguments():
+    file_dir = os.path.dirname(os.path.realpath(__file__))
+    parser = argparse.ArgumentParser(description='Replay .ulg files through the EKF in parallel and summarize the'
+                                                 ' innovation test ratios')
+    parser.add_argument('logs', nargs='+', help='.ulg files, sensor data .csv files or directories containing them')
+    parser.add_argument('-p', '--params', action='append', default=[],
+                        help='EKF2 parameter override file (replay_params.txt format: <param_name> <value> per line),'
+                             ' applied on top of the parameters of the log. Can be given several times, every log is'
+                             ' replayed with every parameter set.')
+    parser.add_argument('-b', '--build-dir', default=os.path.join(file_dir, '../../build/px4_sitl_test'),
+                        help='unit test build directory containing ekf2_batch_replay (default: '
+                             'build/px4_sitl_test)')
+    parser.add_argument('-o', '--output-dir', default='replay_batch',
+                        help='output directory, a subdirectory is created for each replay (default: replay_batch)')
+    parser.add_argument('-j', '--jobs', type=int, default=os.cpu_count(),
+                        help='number of replays running in parallel (default: number of cores)')
+    parser.add_argument('--timeout', type=float, default=None,
+                        help='timeout of the whole batch in seconds (default: none)')
+    return parser.parse_args()
+
+
+def find_log_files(paths):
+    log_files = []
+
+    for path in paths:
+        if os.path.isdir(path):
+            log_files += sorted(glob.glob(os.path.join(path, '**/*.ulg'), recursive=True))
+        else:
+            log_files.append(path)
+
+    return [os.path.abspath(log_file) for log_file in log_files]
+
+
+def find_replay_binary(build_dir):
+    for path in [os.path.join(build_dir, 'src/modules/ekf2/test/ekf2_batch_replay'),
+                 os.path.join(build_dir, 'ekf2_batch_replay')]:
+        if os.path.isfile(path):
+            return path
+
+    return None
+
+
+def convert_log(log_file, sensor_data_file, params_file):
+    """
+    converts a .ulg file to a sensor data file of the sensor simulator, and its initial EKF2 parameters to a
+    parameter file, returns (sensor data file, parameter file) or (None, None)
+    """
+    if not log_file.endswith('.ulg'):
+        return log_file, None
+
+    converter = os.path.join(os.path.dirname(os.path.realpath(__file__)),
+                             '../../src/modules/ekf2/test/sensor_simulator/createSensorDataFile.py')
+
+    result = subprocess.run([sys.executable, converter, log_file, sensor_data_file],
+                            cwd=os.path.dirname(converter), stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                            universal_newlines=True)
+
+    if result.returncode != 0 or not os.path.isfile(sensor_data_file):
+        print('{:s}: conversion failed\n{:s}'.format(log_file, result.stdout))
+        return None, None
+
+    # parameters only, no topic data
+    ulog = ULog(log_file, message_name_filter_list=[])
+
+    with open(params_file, 'w') as params:
+        for name, value in sorted(ulog.initial_parameters.items()):
+            if name.startswith('EKF2_'):
+                params.write('{:s} {:.9g}\n'.format(name, value))
+
+    return sensor_data_file, params_file
+
+
+def read_test_ratios(test_ratios_file):
+    """
+    returns [(aid source, samples, mean, max, fraction of samples > 1)] of a replay
+    """
+    with open(test_ratios_file, newline='') as csv_file:
+        return [(row['aid_source'], int(row['samples']), float(row['mean']), float(row['max']),
+                 float(row['fraction_above_1'])) for row in csv.DictReader(csv_file)]
+
+
+def main() -> None:
+
+    args = get_arguments()
+
+    output_dir = os.path.abspath(args.output_dir)
+    replay_binary = find_replay_binary(os.path.abspath(args.build_dir))
+
+    if replay_binary is None:
+        print('ekf2_batch_replay not found in {:s}, build it with: cmake --build {:s} --target '
+              'ekf2_batch_replay'.format(args.build_dir, args.build_dir))
+        sys.exit(1)
+
+    log_files = find_log_files(args.logs)
+    params_files = [os.path.abspath(params_file) for params_file in args.params] or [None]
+
+    os.makedirs(os.path.join(output_dir, 'sensor_data'), exist_ok=True)
+
+    start = time.monotonic()
+
+    # convert every log once, the sensor data is shared by all the parameter sets
+    sensor_data_files = {}
+
+    with concurrent.futures.ThreadPoolExecutor(max_workers=args.jobs) as executor:
+        futures = {}
+
+        for index, log_file in enumerate(log_files):
+            name = '{:d}_{:s}'.format(index, os.path.splitext(os.path.basename(log_file))[0])
+            futures[executor.submit(convert_log, log_file, os.path.join(output_dir, 'sensor_data', name + '.csv'),
+                                    os.path.join(output_dir, 'sensor_data', name + '_params.txt'))] = log_file
+
+        for future in concurrent.futures.as_completed(futures):
+            sensor_data_files[futures[future]] = future.result()
+
+    print('converted {:d} logs in {:.1f} s'.format(len(log_files), time.monotonic() - start))
+
+    runs = []
+
+    for log_file in log_files:
+        if sensor_data_files[log_file][0] is None:
+            continue
+
+        for params_file in params_files:
+            name = os.path.splitext(os.path.basename(log_file))[0]
+
+            if params_file is not None:
+                name += '_' + os.path.splitext(os.path.basename(params_file))[0]
+
+            # logs with the same name in different directories
+            if any(os.path.basename(run_dir) == name for _, _, run_dir in runs):
+                name += '_{:d}'.format(len(runs))
+
+            runs.append((log_file, params_file, os.path.join(output_dir, name)))
+
+    # one run per line: output directory, sensor data, parameters of the log, parameter overrides
+    runs_file = os.path.join(output_dir, 'runs.txt')
+
+    with open(runs_file, 'w') as runs_out:
+        for log_file, params_file, run_dir in runs:
+            os.makedirs(run_dir, exist_ok=True)
+
+            for stale_file in ['replay.ulg', 'test_ratios.csv']:
+                if os.path.isfile(os.path.join(run_dir, stale_file)):
+                    os.remove(os.path.join(run_dir, stale_file))
+
+            sensor_data_file, log_params_file = sensor_data_files[log_file]
+            fields = [run_dir, sensor_data_file] + [f for f in [log_params_file, params_file] if f is not None]
+            runs_out.write('\t'.join(fields) + '\n')
+
+    start = time.monotonic()
+
+    try:
+        subprocess.run([replay_binary, '-j', str(args.jobs), runs_file], timeout=args.timeout)
+    except subprocess.TimeoutExpired:
+        print('timeout')
+
+    print('total {:.1f} s'.format(time.monotonic() - start))
+
+    # summary of the innovation test ratios: mean / max / fraction above 1 (rejected)
+    with open(os.path.join(output_dir, 'summary.csv'), 'w', newline='') as summary_file:
+        writer = csv.writer(summary_file)
+        writer.writerow(['run', 'log', 'params', 'aid_source', 'samples', 'mean', 'max', 'fraction_above_1'])
+
+        for log_file, params_file, run_dir in runs:
+            name = os.path.basename(run_dir)
+            test_ratios_file = os.path.join(run_dir, 'test_ratios.csv')
+            print('')
+            print(name)
+
+            if not os.path.isfile(test_ratios_file):
+                print('  replay failed')
+                continue
+
+            for aid_source, samples, mean, maximum, rejected in read_test_ratios(test_ratios_file):
+                print('  {:14s} mean {:6.3f} max {:8.3f} >1 {:5.1f}%'.format(aid_source, mean, maximum,
+                                                                           100.0 * rejected))
+                writer.writerow([name, log_file, params_file or '', aid_source, samples,
+                                 '{:.4f}'.format(mean), '{:.4f}'.format(maximum), '{:.4f}'.format(rejected)])
+
+
+if __name__ == '__main__':
+    main()
@@ -75,14 +75,17 @@ struct_size, padding_end_size = add_padding_bytes(sorted_fields, search_path)
 
 @{
 queue_length = 1
+orb_flags = '0'
 for constant in spec.constants:
 	if constant.name == 'ORB_QUEUE_LENGTH':
 		queue_length = constant.val
+	elif constant.name == 'ORB_SEQLOCK' and constant.val:
+		orb_flags = 'ORB_FLAG_SEQLOCK'
 }@
 
 @[for topic in topics]@
 static_assert(static_cast<orb_id_size_t>(ORB_ID::@topic) == @(all_topics.index(topic)), "ORB_ID index mismatch");
-ORB_DEFINE(@topic, struct @uorb_struct, @(struct_size-padding_end_size), @(message_hash)u, static_cast<orb_id_size_t>(ORB_ID::@topic), @queue_length);
+ORB_DEFINE(@topic, struct @uorb_struct, @(struct_size-padding_end_size), @(message_hash)u, static_cast<orb_id_size_t>(ORB_ID::@topic), @queue_length, @orb_flags);
 @[end for]
 
 void print_message(const orb_metadata *meta, const @uorb_struct& message)
@@ -35,9 +35,11 @@
 
 #include "WorkQueueManager.hpp"
 #include "WorkQueue.hpp"
+#include "WorkQueueTrace.hpp"
 
 #include <containers/IntrusiveQueue.hpp>
 #include <containers/IntrusiveSortedList.hpp>
+#include <px4_platform_common/atomic.h>
 #include <px4_platform_common/defines.h>
 #include <drivers/drv_hrt.h>
 #include <lib/mathlib/mathlib.h>
@@ -72,6 +74,52 @@ public:
 
 	virtual void print_run_status();
 
+#if defined(CONFIG_PX4_WORK_QUEUE_TRACE)
+	/**
+	 * Record what scheduled the item (use PX4_WQ_TRACE_WAKEUP(), which compiles to nothing without tracing).
+	 * @param orb_id	ORB_ID of the publication, or WorkQueueTrace::ORB_ID_TIMER
+	 */
+	void TraceWakeup(uint16_t orb_id)
+	{
+		WorkQueue *wq = _wq;
+
+		if (wq != nullptr) {
+			wq->trace().record(WorkQueueTrace::EventType::Wakeup, _trace_id, orb_id);
+		}
+	}
+#endif // CONFIG_PX4_WORK_QUEUE_TRACE
+
+	/**
+	 * Scheduling parameters for the priority scheduler (CONFIG_PX4_WORK_QUEUE_PRIORITY_SCHEDULER).
+	 * Runnable items of a WorkQueue are ordered by priority (higher first), then by deadline
+	 * (time scheduled + relative deadline, earliest first). Items with equal keys run in FIFO order.
+	 * ScheduleOnInterval() sets the relative deadline to the interval. Without an explicit deadline
+	 * (e.g. callback driven items) the time since the previous scheduling is used (implicit deadline,
+	 * the item should run before its next activation), at most 1 s.
+	 * Without the priority scheduler items always run in FIFO order.
+	 *
+	 * @param priority		Priority within the WorkQueue, default 0.
+	 * @param relative_deadline_us	Deadline relative to the time the item was scheduled, 0 for the implicit deadline.
+	 */
+	void SetSchedulingPriority(int8_t priority)
+	{
+#if defined(CONFIG_PX4_WORK_QUEUE_PRIORITY_SCHEDULER)
+		_sched_priority = priority;
+#endif
+	}
+
+	void SetSchedulingDeadline(uint32_t relative_deadline_us)
+	{
+#if defined(CONFIG_PX4_WORK_QUEUE_PRIORITY_SCHEDULER)
+		_sched_relative_deadline = relative_deadline_us;
+#endif
+	}
+
+	/**
+	 * Print the schedule-to-run latency histogram (priority scheduler only) and reset it.
+	 */
+	void print_latency_status();
+
 	/**
 	 * Switch to a different WorkQueue.
 	 * NOTE: Caller is responsible for synchronization.
@@ -108,7 +156,7 @@ protected:
 		}
 	}
 
-	friend void WorkQueue::Run();
+	friend class WorkQueue;
 	virtual void Run() = 0;
 
 	/**
@@ -132,8 +180,41 @@ protected:
 
 private:
 
+#if defined(CONFIG_PX4_WORK_QUEUE_PRIORITY_SCHEDULER)
+	// schedule-to-run latency histogram, bucket i counts latencies < 2^(i + 4) us, the last one everything above
+	static constexpr int LATENCY_BUCKETS = 10;
+
+	void record_latency(hrt_abstime latency)
+	{
+		int bucket = 0;
+
+		for (hrt_abstime bound = latency >> 4; (bound > 0) && (bucket < LATENCY_BUCKETS - 1); bound >>= 1) {
+			bucket++;
+		}
+
+		_latency_histogram[bucket]++;
+		_latency_max = math::max(_latency_max, (uint32_t)math::min(latency, (hrt_abstime)UINT32_MAX));
+	}
+
+	WorkItem		*_sched_next{nullptr};		// next item in the WorkQueue inbox or ready list
+	px4::atomic_bool	_sched_queued{false};		// in the WorkQueue inbox or ready list
+	hrt_abstime		_time_scheduled{0};		// time of the ScheduleNow() that queued the item
+	hrt_abstime		_sched_deadline{0};		// absolute deadline, valid in the ready list
+	uint32_t		_sched_period{1000000};		// time between the last two schedulings (implicit deadline)
+
+	uint32_t		_latency_histogram[LATENCY_BUCKETS] {};
+	uint32_t		_latency_max{0};
+
+	uint32_t		_sched_relative_deadline{0};	// 0: implicit (ScheduleOnInterval() uses the interval)
+	int8_t			_sched_priority{0};
+#endif
+
 	WorkQueue	*_wq{nullptr};
 
+#if defined(CONFIG_PX4_WORK_QUEUE_TRACE)
+	const uint16_t	_trace_id{WorkQueueTrace::register_item(_item_name)};
+#endif
+
 };
 
 } // namespace px4
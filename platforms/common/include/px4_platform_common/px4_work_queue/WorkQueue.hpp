@@ -34,6 +34,7 @@
 #pragma once
 
 #include "WorkQueueManager.hpp"
+#include "WorkQueueTrace.hpp"
 
 #include <containers/BlockingList.hpp>
 #include <containers/List.hpp>
@@ -51,7 +52,14 @@ class WorkItem;
 class WorkQueue : public IntrusiveSortedListNode<WorkQueue *>
 {
 public:
+#if defined(CONFIG_PX4_WORK_QUEUE_POOL)
+	/**
+	 * @param pooled	serviced by the shared work queue pool instead of a dedicated thread running Run()
+	 */
+	explicit WorkQueue(const wq_config_t &wq_config, bool pooled = false);
+#else
 	explicit WorkQueue(const wq_config_t &wq_config);
+#endif
 	WorkQueue() = delete;
 
 	~WorkQueue();
@@ -69,10 +77,37 @@ public:
 
 	void Run();
 
+#if defined(CONFIG_PX4_WORK_QUEUE_POOL)
+	enum class PoolRunResult {
+		Idle,		///< released, will be queued to the pool again on the next work
+		Reschedule,	///< more work arrived, still owned by the caller and needs to be queued to the pool again
+		Exit,		///< stopped, the caller is responsible for deleting the queue
+	};
+
+	/**
+	 * Run all pending work on the calling pool thread.
+	 * Only one pool thread at a time runs a given queue, which keeps the work items serialized.
+	 */
+	PoolRunResult RunPooled();
+
+	bool pooled() const { return _pooled; }
+
+	/**
+	 * SCHED_FIFO priority a pool thread runs this queue with, the configured
+	 * priority of the queue name (px4_thread_affinity) or the priority of its own thread.
+	 */
+	int pool_priority() const { return _pool_priority; }
+#endif // CONFIG_PX4_WORK_QUEUE_POOL
+
 	void request_stop() { _should_exit.store(true); }
 
 	void print_status(bool last = false);
 
+#if defined(CONFIG_PX4_WORK_QUEUE_TRACE)
+	WorkQueueTrace &trace() { return _trace; }
+	const WorkQueueTrace &trace() const { return _trace; }
+#endif
+
 	// WorkQueues sorted numerically by relative priority (-1 to -255)
 	bool operator<=(const WorkQueue &rhs) const { return _config.relative_priority >= rhs.get_config().relative_priority; }
 
@@ -82,6 +117,17 @@ private:
 
 	inline void SignalWorkerThread();
 
+	// run everything queued (work_lock held)
+	void ProcessPending();
+
+#if defined(CONFIG_PX4_WORK_QUEUE_PRIORITY_SCHEDULER)
+	// move everything from the lock-free inbox into the ordered ready list (work_lock held)
+	void CollectInbox();
+
+	// insert into the ready list by priority, then deadline (work_lock held)
+	void InsertReady(WorkItem *item);
+#endif
+
 #ifdef __PX4_NUTTX
 	// In NuttX work can be enqueued from an ISR
 	void work_lock() { _flags = enter_critical_section(); }
@@ -94,13 +140,34 @@ private:
 	px4_sem_t _qlock;
 #endif
 
+#if defined(CONFIG_PX4_WORK_QUEUE_PRIORITY_SCHEDULER)
+	// Items are pushed lock-free (multiple producers) onto the inbox stack, and moved into the
+	// ready list by whoever holds work_lock (the worker thread, or Remove()/Clear()).
+	px4::atomic<WorkItem *>		_inbox{nullptr};
+	WorkItem			*_ready{nullptr};
+#else
 	IntrusiveQueue<WorkItem *>	_q;
+#endif
 	px4_sem_t			_process_lock;
 	px4_sem_t			_exit_lock;
 	const wq_config_t		&_config;
 	BlockingList<WorkItem *>	_work_items;
 	px4::atomic_bool		_should_exit{false};
 
+#if defined(CONFIG_PX4_WORK_QUEUE_POOL)
+	const bool			_pooled;
+	px4::atomic_bool		_pool_scheduled{false}; // queued to or running on the pool
+	int				_pool_priority{0};
+#endif
+
+#if defined(__PX4_LINUX)
+	pid_t				_tid {0}; // kernel thread id, 0 if pooled
+#endif
+
+#if defined(CONFIG_PX4_WORK_QUEUE_TRACE)
+	WorkQueueTrace			_trace;
+#endif
+
 #if defined(ENABLE_LOCKSTEP_SCHEDULER)
 	int _lockstep_component {-1};
 #endif // ENABLE_LOCKSTEP_SCHEDULER
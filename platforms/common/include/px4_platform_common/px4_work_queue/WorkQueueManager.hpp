@@ -137,5 +137,36 @@ const wq_config_t &serial_port_to_wq(const char *serial);
 
 const wq_config_t &ins_instance_to_wq(uint8_t instance);
 
+#if defined(CONFIG_PX4_WORK_QUEUE_TRACE)
+typedef void (*wq_trace_callback)(const WorkQueue &wq, int index, void *user);
+
+/**
+ * Iterate over all work queues, to read their trace (WorkQueue::trace()).
+ * The work queue list is locked during the iteration, so no work queue can be removed.
+ *
+ * @param cb		callback, index is the position of the work queue in the list
+ * @param user		custom argument for the callback
+ */
+void WorkQueueManagerTraceIterate(wq_trace_callback cb, void *user);
+#endif // CONFIG_PX4_WORK_QUEUE_TRACE
+
+#if defined(CONFIG_PX4_WORK_QUEUE_POOL)
+/**
+ * Check if a work queue is serviced by the shared pool instead of its own thread.
+ * Only the non real-time queues (lp_default, hp_default, serial ports and I2C buses) are pooled.
+ *
+ * @param config		The work queue configuration.
+ * @return		true if the work queue is pooled.
+ */
+bool WorkQueuePoolEligible(const wq_config_t &config);
+
+/**
+ * Queue a pooled work queue to be run by one of the pool threads.
+ *
+ * @param wq		The work queue, marked as scheduled by the caller.
+ */
+void WorkQueuePoolSchedule(WorkQueue *wq);
+#endif // CONFIG_PX4_WORK_QUEUE_POOL
+
 
 } // namespace px4
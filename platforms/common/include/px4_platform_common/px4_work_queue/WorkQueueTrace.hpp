@@ -0,0 +1,138 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2025 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file WorkQueueTrace.hpp
+ *
+ * Optional (CONFIG_PX4_WORK_QUEUE_TRACE) timeline tracing of work item wakeups and runs.
+ *
+ * Each WorkQueue has a ring buffer of trace events. Run events are only written by the
+ * work queue thread, wakeup events by whichever thread schedules an item (uORB publisher,
+ * hrt callout), so writers claim slots with an atomic increment and readers validate
+ * each slot by its sequence number. Events may be overwritten before they are read.
+ *
+ * With tracing disabled the PX4_WQ_TRACE_* macros compile to nothing.
+ */
+
+#pragma once
+
+#include <px4_platform_common/atomic.h>
+#include <drivers/drv_hrt.h>
+
+#include <stdint.h>
+
+#if defined(CONFIG_PX4_WORK_QUEUE_TRACE)
+# define PX4_WQ_TRACE_WAKEUP(work_item, orb_id) (work_item)->TraceWakeup(orb_id)
+#else
+# define PX4_WQ_TRACE_WAKEUP(work_item, orb_id)
+#endif
+
+#if defined(CONFIG_PX4_WORK_QUEUE_TRACE)
+
+namespace px4
+{
+
+class WorkQueueTrace
+{
+public:
+	enum class EventType : uint8_t {
+		Wakeup = 0,	///< scheduled by a publication (orb_id) or the timer (ORB_ID_TIMER)
+		RunBegin = 1,
+		RunEnd = 2,
+	};
+
+	static constexpr uint16_t ORB_ID_TIMER = UINT16_MAX - 1;
+	static constexpr uint16_t ORB_ID_NONE = UINT16_MAX;
+
+	static constexpr int MAX_ITEMS = 256;	///< item ids, further items share the last id
+
+	struct Event {
+		hrt_abstime timestamp;
+		uint32_t sequence;	///< index + 1 of the event written to the slot, 0 while being written
+		uint16_t item_id;
+		uint16_t orb_id;
+		EventType type;
+	};
+
+	void record(EventType type, uint16_t item_id, uint16_t orb_id = ORB_ID_NONE)
+	{
+		const uint32_t index = _head.fetch_add(1);
+		Event &event = _events[index % EVENTS];
+
+		__atomic_store_n(&event.sequence, 0, __ATOMIC_RELAXED);
+		__atomic_thread_fence(__ATOMIC_RELEASE);
+
+		event.timestamp = hrt_absolute_time();
+		event.item_id = item_id;
+		event.orb_id = orb_id;
+		event.type = type;
+
+		__atomic_store_n(&event.sequence, index + 1, __ATOMIC_RELEASE);
+	}
+
+	/**
+	 * Read the event at index. If it was already overwritten, index is advanced to the oldest
+	 * event still available.
+	 * @return false if there's no (complete) event at index yet
+	 */
+	bool read(uint32_t &index, Event &event) const;
+
+	/** index of the next event to be written */
+	uint32_t head() const { return _head.load(); }
+
+	/** index of the oldest event that may still be available */
+	uint32_t tail() const
+	{
+		const uint32_t head = _head.load();
+		return (head > EVENTS) ? head - EVENTS : 0;
+	}
+
+	/** assign an id to a work item name */
+	static uint16_t register_item(const char *name);
+
+	/** name of the work item with the given id (the last registered one if shared) */
+	static const char *item_name(uint16_t item_id);
+
+	/** number of ids in use */
+	static uint16_t item_count();
+
+private:
+	static constexpr uint32_t EVENTS = CONFIG_PX4_WORK_QUEUE_TRACE_EVENTS;
+
+	Event _events[EVENTS] {};
+	px4::atomic<uint32_t> _head{0};
+};
+
+} // namespace px4
+
+#endif // CONFIG_PX4_WORK_QUEUE_TRACE
@@ -47,6 +47,7 @@ ScheduledWorkItem::~ScheduledWorkItem()
 void ScheduledWorkItem::schedule_trampoline(void *arg)
 {
 	ScheduledWorkItem *dev = static_cast<ScheduledWorkItem *>(arg);
+	PX4_WQ_TRACE_WAKEUP(dev, WorkQueueTrace::ORB_ID_TIMER);
 	dev->ScheduleNow();
 }
 
@@ -57,6 +58,9 @@ void ScheduledWorkItem::ScheduleDelayed(uint32_t delay_us)
 
 void ScheduledWorkItem::ScheduleOnInterval(uint32_t interval_us, uint32_t delay_us)
 {
+	// a periodic item should run before its next activation
+	SetSchedulingDeadline(interval_us);
+
 	hrt_call_every(&_call, delay_us, interval_us, (hrt_callout)&ScheduledWorkItem::schedule_trampoline, this);
 }
 
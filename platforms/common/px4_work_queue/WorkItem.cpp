@@ -132,6 +132,43 @@ float WorkItem::average_interval() const
 	return 0.f;
 }
 
+void WorkItem::print_latency_status()
+{
+#if defined(CONFIG_PX4_WORK_QUEUE_PRIORITY_SCHEDULER)
+	uint32_t total = 0;
+
+	for (int i = 0; i < LATENCY_BUCKETS; i++) {
+		total += _latency_histogram[i];
+	}
+
+	if (total == 0) {
+		PX4_INFO_RAW("latency: -\n");
+		return;
+	}
+
+	// percentiles as bucket upper bounds
+	static constexpr float percentiles[] {0.5f, 0.9f, 0.99f};
+	uint32_t bounds[3] {};
+	uint32_t count = 0;
+	int p = 0;
+
+	for (int i = 0; (i < LATENCY_BUCKETS) && (p < 3); i++) {
+		count += _latency_histogram[i];
+
+		while ((p < 3) && (count >= percentiles[p] * total)) {
+			bounds[p++] = (i < LATENCY_BUCKETS - 1) ? (1u << (i + 4)) : _latency_max;
+		}
+	}
+
+	PX4_INFO_RAW("latency: p50 <%4" PRIu32 " us, p90 <%4" PRIu32 " us, p99 <%5" PRIu32 " us, max %5" PRIu32 " us\n",
+		     bounds[0], bounds[1], bounds[2], _latency_max);
+
+	// reset statistics
+	memset(_latency_histogram, 0, sizeof(_latency_histogram));
+	_latency_max = 0;
+#endif
+}
+
 void WorkItem::print_run_status()
 {
 	PX4_INFO_RAW("%-29s %8.1f Hz %12.0f us\n", _item_name, (double)average_rate(), (double)average_interval());
@@ -41,18 +41,54 @@
 #include <px4_platform_common/time.h>
 #include <drivers/drv_hrt.h>
 
+#if defined(__PX4_LINUX)
+#include <inttypes.h>
+#include <px4_platform/thread_affinity.h>
+#endif
+
 namespace px4
 {
 
+#if defined(CONFIG_PX4_WORK_QUEUE_POOL)
+WorkQueue::WorkQueue(const wq_config_t &config, bool pooled) :
+	_config(config),
+	_pooled(pooled)
+#else
 WorkQueue::WorkQueue(const wq_config_t &config) :
 	_config(config)
+#endif
 {
-	// set the threads name
+#if defined(CONFIG_PX4_WORK_QUEUE_POOL)
+
+	if (_pooled) {
+		_pool_priority = sched_get_priority_max(SCHED_FIFO) + _config.relative_priority;
+
+#if defined(__PX4_LINUX)
+		const int configured_priority = px4_thread_affinity_priority(_config.name);
+
+		if (configured_priority > 0) {
+			_pool_priority = configured_priority;
+		}
+
+#endif
+	}
+
+	if (!_pooled)
+#endif
+	{
+		// set the threads name
 #ifdef __PX4_DARWIN
-	pthread_setname_np(_config.name);
+		pthread_setname_np(_config.name);
 #else
-	pthread_setname_np(pthread_self(), _config.name);
+		pthread_setname_np(pthread_self(), _config.name);
+#endif
+
+#if defined(__PX4_LINUX)
+		// pin to the configured CPUs (and priority) if any
+		px4_thread_affinity_apply(_config.name);
+		_tid = px4_thread_gettid();
 #endif
+	}
 
 #ifndef __PX4_NUTTX
 	px4_sem_init(&_qlock, 0, 1);
@@ -128,6 +164,44 @@ void WorkQueue::Detach(WorkItem *item)
 
 void WorkQueue::Add(WorkItem *item)
 {
+#if defined(CONFIG_PX4_WORK_QUEUE_PRIORITY_SCHEDULER)
+
+#if defined(ENABLE_LOCKSTEP_SCHEDULER)
+	// register and push under the lock: Run() unregisters the lockstep component once it finds the queue empty,
+	// which must not happen in between (lockstep could advance the time past the runnable item)
+	work_lock();
+
+	if (_lockstep_component == -1) {
+		_lockstep_component = px4_lockstep_register_component();
+	}
+
+#endif // ENABLE_LOCKSTEP_SCHEDULER
+
+	// only queue once, the item is already runnable otherwise
+	bool queued = false;
+
+	if (item->_sched_queued.compare_exchange(&queued, true)) {
+		const hrt_abstime now = hrt_absolute_time();
+
+		if (item->_time_scheduled != 0) {
+			item->_sched_period = math::min(now - item->_time_scheduled, (hrt_abstime)1000000);
+		}
+
+		item->_time_scheduled = now;
+
+		// lock-free push onto the inbox stack
+		WorkItem *head = _inbox.load();
+
+		do {
+			item->_sched_next = head;
+		} while (!_inbox.compare_exchange(&head, item));
+	}
+
+#if defined(ENABLE_LOCKSTEP_SCHEDULER)
+	work_unlock();
+#endif // ENABLE_LOCKSTEP_SCHEDULER
+
+#else
 	work_lock();
 
 #if defined(ENABLE_LOCKSTEP_SCHEDULER)
@@ -140,12 +214,28 @@ void WorkQueue::Add(WorkItem *item)
 
 	_q.push(item);
 	work_unlock();
+#endif // CONFIG_PX4_WORK_QUEUE_PRIORITY_SCHEDULER
 
 	SignalWorkerThread();
 }
 
 void WorkQueue::SignalWorkerThread()
 {
+#if defined(CONFIG_PX4_WORK_QUEUE_POOL)
+
+	if (_pooled) {
+		// queue to the pool once, the serving pool thread picks up any further work
+		bool scheduled = false;
+
+		if (_pool_scheduled.compare_exchange(&scheduled, true)) {
+			WorkQueuePoolSchedule(this);
+		}
+
+		return;
+	}
+
+#endif // CONFIG_PX4_WORK_QUEUE_POOL
+
 	int sem_val;
 
 	if (px4_sem_getvalue(&_process_lock, &sem_val) == 0 && sem_val <= 0) {
@@ -153,10 +243,71 @@ void WorkQueue::SignalWorkerThread()
 	}
 }
 
+#if defined(CONFIG_PX4_WORK_QUEUE_PRIORITY_SCHEDULER)
+void WorkQueue::CollectInbox()
+{
+	// take the whole inbox
+	WorkItem *head = _inbox.load();
+
+	while ((head != nullptr) && !_inbox.compare_exchange(&head, nullptr)) {}
+
+	// the inbox is LIFO, reverse it to keep the scheduling order for items with equal keys
+	WorkItem *fifo = nullptr;
+
+	while (head != nullptr) {
+		WorkItem *next = head->_sched_next;
+		head->_sched_next = fifo;
+		fifo = head;
+		head = next;
+	}
+
+	while (fifo != nullptr) {
+		WorkItem *next = fifo->_sched_next;
+		InsertReady(fifo);
+		fifo = next;
+	}
+}
+
+void WorkQueue::InsertReady(WorkItem *item)
+{
+	const uint32_t relative_deadline = (item->_sched_relative_deadline != 0) ? item->_sched_relative_deadline
+					   : item->_sched_period;
+	item->_sched_deadline = item->_time_scheduled + relative_deadline;
+
+	WorkItem **position = &_ready;
+
+	// skip all items which run before (higher priority, or same priority and earlier or equal deadline)
+	while ((*position != nullptr)
+	       && (((*position)->_sched_priority > item->_sched_priority)
+		   || (((*position)->_sched_priority == item->_sched_priority)
+		       && ((*position)->_sched_deadline <= item->_sched_deadline)))) {
+
+		position = &(*position)->_sched_next;
+	}
+
+	item->_sched_next = *position;
+	*position = item;
+}
+#endif // CONFIG_PX4_WORK_QUEUE_PRIORITY_SCHEDULER
+
 void WorkQueue::Remove(WorkItem *item)
 {
 	work_lock();
+#if defined(CONFIG_PX4_WORK_QUEUE_PRIORITY_SCHEDULER)
+	CollectInbox();
+
+	for (WorkItem **position = &_ready; *position != nullptr; position = &(*position)->_sched_next) {
+		if (*position == item) {
+			*position = item->_sched_next;
+			item->_sched_next = nullptr;
+			item->_sched_queued.store(false);
+			break;
+		}
+	}
+
+#else
 	_q.remove(item);
+#endif
 	work_unlock();
 }
 
@@ -164,10 +315,24 @@ void WorkQueue::Clear()
 {
 	work_lock();
 
+#if defined(CONFIG_PX4_WORK_QUEUE_PRIORITY_SCHEDULER)
+	CollectInbox();
+
+	while (_ready != nullptr) {
+		WorkItem *item = _ready;
+		_ready = item->_sched_next;
+		item->_sched_next = nullptr;
+		item->_sched_queued.store(false);
+	}
+
+#else
+
 	while (!_q.empty()) {
 		_q.pop();
 	}
 
+#endif
+
 	work_unlock();
 }
 
@@ -178,37 +343,142 @@ void WorkQueue::Run()
 		do {} while (px4_sem_wait(&_process_lock) != 0);
 
 		work_lock();
+		ProcessPending();
+		work_unlock();
+	}
 
-		// process queued work
-		while (!_q.empty()) {
-			WorkItem *work = _q.pop();
+	PX4_DEBUG("%s: exiting", _config.name);
+}
 
-			work_unlock(); // unlock work queue to run (item may requeue itself)
-			work->RunPreamble();
-			work->Run();
-			// Note: after Run() we cannot access work anymore, as it might have been deleted
-			work_lock(); // re-lock
-		}
+void WorkQueue::ProcessPending()
+{
+#if defined(CONFIG_PX4_WORK_QUEUE_PRIORITY_SCHEDULER)
+	CollectInbox();
+
+	// process queued work, highest priority and earliest deadline first
+	while (_ready != nullptr) {
+		WorkItem *work = _ready;
+		_ready = work->_sched_next;
+		work->_sched_next = nullptr;
+
+		const hrt_abstime time_scheduled = work->_time_scheduled;
+
+		// from here on the item can be queued again (eg by itself in Run())
+		work->_sched_queued.store(false);
+
+		work_unlock(); // unlock work queue to run (item may requeue itself)
+		work->record_latency(hrt_elapsed_time(&time_scheduled));
+		work->RunPreamble();
+#if defined(CONFIG_PX4_WORK_QUEUE_TRACE)
+		const uint16_t trace_id = work->_trace_id;
+		_trace.record(WorkQueueTrace::EventType::RunBegin, trace_id);
+#endif
+		work->Run();
+		// Note: after Run() we cannot access work anymore, as it might have been deleted
+#if defined(CONFIG_PX4_WORK_QUEUE_TRACE)
+		_trace.record(WorkQueueTrace::EventType::RunEnd, trace_id);
+#endif
+		work_lock(); // re-lock
+
+		// pick up anything scheduled in the meantime
+		CollectInbox();
+	}
 
 #if defined(ENABLE_LOCKSTEP_SCHEDULER)
 
-		if (_q.empty()) {
-			px4_lockstep_unregister_component(_lockstep_component);
-			_lockstep_component = -1;
-		}
+	if (_ready == nullptr) {
+		px4_lockstep_unregister_component(_lockstep_component);
+		_lockstep_component = -1;
+	}
 
 #endif // ENABLE_LOCKSTEP_SCHEDULER
 
+#else
+
+	// process queued work
+	while (!_q.empty()) {
+		WorkItem *work = _q.pop();
+
+		work_unlock(); // unlock work queue to run (item may requeue itself)
+		work->RunPreamble();
+#if defined(CONFIG_PX4_WORK_QUEUE_TRACE)
+		const uint16_t trace_id = work->_trace_id;
+		_trace.record(WorkQueueTrace::EventType::RunBegin, trace_id);
+#endif
+		work->Run();
+		// Note: after Run() we cannot access work anymore, as it might have been deleted
+#if defined(CONFIG_PX4_WORK_QUEUE_TRACE)
+		_trace.record(WorkQueueTrace::EventType::RunEnd, trace_id);
+#endif
+		work_lock(); // re-lock
+	}
+
+#if defined(ENABLE_LOCKSTEP_SCHEDULER)
+
+	if (_q.empty()) {
+		px4_lockstep_unregister_component(_lockstep_component);
+		_lockstep_component = -1;
+	}
+
+#endif // ENABLE_LOCKSTEP_SCHEDULER
+
+#endif // CONFIG_PX4_WORK_QUEUE_PRIORITY_SCHEDULER
+}
+
+#if defined(CONFIG_PX4_WORK_QUEUE_POOL)
+WorkQueue::PoolRunResult WorkQueue::RunPooled()
+{
+	work_lock();
+	ProcessPending();
+
+	if (should_exit()) {
+		// stays marked as scheduled, nothing can queue it to the pool again
 		work_unlock();
+		return PoolRunResult::Exit;
 	}
 
-	PX4_DEBUG("%s: exiting", _config.name);
+	_pool_scheduled.store(false);
+
+	// work added after the queue was drained, but before it was released, wasn't scheduled
+#if defined(CONFIG_PX4_WORK_QUEUE_PRIORITY_SCHEDULER)
+	const bool pending = (_inbox.load() != nullptr) || (_ready != nullptr);
+#else
+	const bool pending = !_q.empty();
+#endif
+
+	bool scheduled = false;
+	const bool reschedule = pending && _pool_scheduled.compare_exchange(&scheduled, true);
+
+	work_unlock();
+
+	return reschedule ? PoolRunResult::Reschedule : PoolRunResult::Idle;
 }
+#endif // CONFIG_PX4_WORK_QUEUE_POOL
 
 void WorkQueue::print_status(bool last)
 {
 	const size_t num_items = _work_items.size();
-	PX4_INFO_RAW("%-16s\n", get_name());
+	PX4_INFO_RAW("%-16s", get_name());
+
+#if defined(CONFIG_PX4_WORK_QUEUE_POOL)
+
+	if (_pooled) {
+		PX4_INFO_RAW(" (pool)");
+	}
+
+#endif
+
+#if defined(__PX4_LINUX)
+	px4_thread_stats_s stats;
+
+	if ((_tid > 0) && (px4_thread_stats(_tid, &stats) == 0)) {
+		PX4_INFO_RAW(" cpus: %-8s ctx switches: %" PRIu64 " voluntary, %" PRIu64 " involuntary",
+			     stats.cpus_allowed, stats.voluntary_ctxt_switches, stats.nonvoluntary_ctxt_switches);
+	}
+
+#endif
+
+	PX4_INFO_RAW("\n");
 	unsigned i = 0;
 
 	for (WorkItem *item : _work_items) {
@@ -229,6 +499,12 @@ void WorkQueue::print_status(bool last)
 		}
 
 		item->print_run_status();
+
+#if defined(CONFIG_PX4_WORK_QUEUE_PRIORITY_SCHEDULER)
+		PX4_INFO_RAW(last ? "    " : "|   ");
+		PX4_INFO_RAW((i < num_items) ? "|       " : "        ");
+		item->print_latency_status();
+#endif
 	}
 }
 
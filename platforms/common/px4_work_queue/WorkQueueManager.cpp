@@ -46,7 +46,13 @@
 #include <lib/drivers/device/Device.hpp>
 #include <lib/mathlib/mathlib.h>
 
+#if defined(__PX4_LINUX)
+#include <px4_platform/thread_affinity.h>
+#endif
+
+#include <inttypes.h>
 #include <limits.h>
+#include <stdio.h>
 #include <string.h>
 
 using namespace time_literals;
@@ -226,6 +232,291 @@ const wq_config_t &ins_instance_to_wq(uint8_t instance)
 	return wq_configurations::INS0;
 }
 
+#if defined(CONFIG_PX4_WORK_QUEUE_POOL)
+// Pool of threads shared by the non real-time work queues. Each thread owns a deque of work queues
+// with pending work. A thread serves its own deque first (FIFO), and steals from the back of the
+// other deques when its own is empty. A work queue is in at most one deque (or running) at a time.
+
+static constexpr int WQ_POOL_MAX_THREADS = 8;
+static constexpr int WQ_POOL_DEQUE_SIZE = 32;
+
+struct WorkQueuePoolThread {
+	pthread_mutex_t mutex;
+	pthread_t thread;
+	WorkQueue *deque[WQ_POOL_DEQUE_SIZE];
+	uint8_t head;
+	uint8_t count;
+	uint32_t runs;
+	uint32_t steals;
+};
+
+static WorkQueuePoolThread _wq_pool_threads[WQ_POOL_MAX_THREADS] {};
+static int _wq_pool_num_threads{0};
+static px4_sem_t _wq_pool_pending; // number of work queues in all deques
+static px4::atomic_bool _wq_pool_should_exit{false};
+static px4::atomic<unsigned> _wq_pool_next_thread{0};
+static thread_local int _wq_pool_thread_index{-1};
+
+bool
+WorkQueuePoolEligible(const wq_config_t &config)
+{
+	static constexpr const char *pooled_prefixes[] {
+		"wq:lp_default",
+		"wq:hp_default",
+		"wq:tty",
+		"wq:I2C",
+	};
+
+	for (const char *prefix : pooled_prefixes) {
+		if (strncmp(config.name, prefix, strlen(prefix)) == 0) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static bool
+WorkQueuePoolPush(WorkQueuePoolThread &pool_thread, WorkQueue *wq)
+{
+	bool ret = false;
+	pthread_mutex_lock(&pool_thread.mutex);
+
+	if (pool_thread.count < WQ_POOL_DEQUE_SIZE) {
+		pool_thread.deque[(pool_thread.head + pool_thread.count) % WQ_POOL_DEQUE_SIZE] = wq;
+		pool_thread.count++;
+		ret = true;
+	}
+
+	pthread_mutex_unlock(&pool_thread.mutex);
+	return ret;
+}
+
+void
+WorkQueuePoolSchedule(WorkQueue *wq)
+{
+	// prefer the calling pool thread (work queued from a pooled work item), otherwise distribute
+	int index = _wq_pool_thread_index;
+
+	if (index < 0) {
+		index = _wq_pool_next_thread.fetch_add(1) % _wq_pool_num_threads;
+	}
+
+	for (int i = 0; i < _wq_pool_num_threads; i++) {
+		if (WorkQueuePoolPush(_wq_pool_threads[(index + i) % _wq_pool_num_threads], wq)) {
+			px4_sem_post(&_wq_pool_pending);
+			return;
+		}
+	}
+
+	// can't happen as long as there are fewer pooled work queues than deque entries
+	PX4_ERR("pool full, dropping %s", wq->get_name());
+}
+
+static WorkQueue *
+WorkQueuePoolTake(int index)
+{
+	WorkQueuePoolThread &own = _wq_pool_threads[index];
+	WorkQueue *wq = nullptr;
+
+	pthread_mutex_lock(&own.mutex);
+
+	if (own.count > 0) {
+		wq = own.deque[own.head];
+		own.head = (own.head + 1) % WQ_POOL_DEQUE_SIZE;
+		own.count--;
+	}
+
+	pthread_mutex_unlock(&own.mutex);
+
+	for (int i = 1; (wq == nullptr) && (i < _wq_pool_num_threads); i++) {
+		WorkQueuePoolThread &victim = _wq_pool_threads[(index + i) % _wq_pool_num_threads];
+
+		pthread_mutex_lock(&victim.mutex);
+
+		if (victim.count > 0) {
+			victim.count--;
+			wq = victim.deque[(victim.head + victim.count) % WQ_POOL_DEQUE_SIZE];
+			own.steals++;
+		}
+
+		pthread_mutex_unlock(&victim.mutex);
+	}
+
+	return wq;
+}
+
+static void *
+WorkQueuePoolRunner(void *context)
+{
+	const int index = (int)(intptr_t)context;
+	_wq_pool_thread_index = index;
+
+	char name[16];
+	snprintf(name, sizeof(name), "wq:pool%d", index);
+#ifdef __PX4_DARWIN
+	pthread_setname_np(name);
+#else
+	pthread_setname_np(pthread_self(), name);
+#endif
+
+#if defined(__PX4_LINUX)
+	// a priority configured for the pool threads themselves is kept, otherwise they take the priority of each queue
+	const bool fixed_priority = (px4_thread_affinity_apply(name) > 0);
+#else
+	const bool fixed_priority = false;
+#endif
+
+	// only change the priority when a queue needs a different one than the thread already has
+	int current_priority = INT_MIN;
+	int policy = SCHED_OTHER;
+	sched_param current_param{};
+
+	if ((pthread_getschedparam(pthread_self(), &policy, &current_param) == 0) && (policy == SCHED_FIFO)) {
+		current_priority = current_param.sched_priority;
+	}
+
+	while (!_wq_pool_should_exit.load()) {
+		// loop as the wait may be interrupted by a signal
+		do {} while (px4_sem_wait(&_wq_pool_pending) != 0);
+
+		// each post is matched by exactly one queued work queue, keep looking until it's found
+		WorkQueue *wq = nullptr;
+
+		while ((wq == nullptr) && !_wq_pool_should_exit.load()) {
+			wq = WorkQueuePoolTake(index);
+		}
+
+		if (wq == nullptr) {
+			break;
+		}
+
+		// run with the priority the work queue would have on its own thread
+		const int priority = wq->pool_priority();
+
+		if (!fixed_priority && (priority != current_priority)) {
+			sched_param param{};
+			param.sched_priority = priority;
+			pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+			// also on failure (e.g. no permission), so it's not retried on every run
+			current_priority = priority;
+		}
+
+		_wq_pool_threads[index].runs++;
+
+		switch (wq->RunPooled()) {
+		case WorkQueue::PoolRunResult::Idle:
+			break;
+
+		case WorkQueue::PoolRunResult::Reschedule:
+			WorkQueuePoolSchedule(wq);
+			break;
+
+		case WorkQueue::PoolRunResult::Exit:
+			_wq_manager_wqs_list->remove(wq);
+			delete wq;
+			break;
+		}
+	}
+
+	return nullptr;
+}
+
+static int
+WorkQueuePoolStart()
+{
+	if (_wq_pool_num_threads > 0) {
+		return PX4_OK;
+	}
+
+#if CONFIG_PX4_WORK_QUEUE_POOL_THREADS > 0
+	int num_threads = CONFIG_PX4_WORK_QUEUE_POOL_THREADS;
+#else
+	int num_threads = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+	num_threads = math::constrain(num_threads, 1, WQ_POOL_MAX_THREADS);
+
+	px4_sem_init(&_wq_pool_pending, 0, 0);
+	px4_sem_setprotocol(&_wq_pool_pending, SEM_PRIO_NONE);
+	_wq_pool_should_exit.store(false);
+
+	// large enough for any of the pooled work queues
+	static constexpr uint16_t pool_stacksize = math::max(math::max(wq_configurations::hp_default.stacksize,
+			wq_configurations::lp_default.stacksize), math::max(wq_configurations::I2C0.stacksize,
+					wq_configurations::ttyS0.stacksize));
+
+	const unsigned int page_size = sysconf(_SC_PAGESIZE);
+	const size_t stacksize_adj = math::max((int)PTHREAD_STACK_MIN, PX4_STACK_ADJUSTED(pool_stacksize));
+	const size_t stacksize = (stacksize_adj + page_size - (stacksize_adj % page_size));
+
+	for (int i = 0; i < num_threads; i++) {
+		WorkQueuePoolThread &pool_thread = _wq_pool_threads[i];
+		pthread_mutex_init(&pool_thread.mutex, nullptr);
+		pool_thread.head = 0;
+		pool_thread.count = 0;
+
+		pthread_attr_t attr;
+		pthread_attr_init(&attr);
+		pthread_attr_setstacksize(&attr, stacksize);
+
+		// the threads need to exist before anything can be scheduled on them
+		_wq_pool_num_threads = i + 1;
+
+		int ret_create = pthread_create(&pool_thread.thread, &attr, WorkQueuePoolRunner, (void *)(intptr_t)i);
+		pthread_attr_destroy(&attr);
+
+		if (ret_create != 0) {
+			PX4_ERR("failed to create pool thread %d (%i): %s", i, ret_create, strerror(ret_create));
+			pthread_mutex_destroy(&pool_thread.mutex);
+			_wq_pool_num_threads = i;
+			break;
+		}
+	}
+
+	PX4_DEBUG("work queue pool: %d threads, stack: %zu bytes", _wq_pool_num_threads, stacksize);
+
+	return (_wq_pool_num_threads > 0) ? PX4_OK : PX4_ERROR;
+}
+
+static void
+WorkQueuePoolStop()
+{
+	if (_wq_pool_num_threads == 0) {
+		return;
+	}
+
+	_wq_pool_should_exit.store(true);
+
+	for (int i = 0; i < _wq_pool_num_threads; i++) {
+		px4_sem_post(&_wq_pool_pending);
+	}
+
+	for (int i = 0; i < _wq_pool_num_threads; i++) {
+		pthread_join(_wq_pool_threads[i].thread, nullptr);
+		pthread_mutex_destroy(&_wq_pool_threads[i].mutex);
+	}
+
+	_wq_pool_num_threads = 0;
+	px4_sem_destroy(&_wq_pool_pending);
+}
+
+static void
+WorkQueuePoolStatus()
+{
+	if (_wq_pool_num_threads == 0) {
+		return;
+	}
+
+	PX4_INFO_RAW("\nWork Queue Pool: %d threads\n", _wq_pool_num_threads);
+
+	for (int i = 0; i < _wq_pool_num_threads; i++) {
+		const WorkQueuePoolThread &pool_thread = _wq_pool_threads[i];
+		PX4_INFO_RAW("%s wq:pool%d  runs: %" PRIu32 "  steals: %" PRIu32 "  queued: %d\n",
+			     (i < _wq_pool_num_threads - 1) ? "|__" : "\\__", i, pool_thread.runs, pool_thread.steals, pool_thread.count);
+	}
+}
+#endif // CONFIG_PX4_WORK_QUEUE_POOL
+
 static void *
 WorkQueueRunner(void *context)
 {
@@ -266,6 +557,16 @@ WorkQueueManagerRun(int, char **)
 		const wq_config_t *wq = _wq_manager_create_queue->pop();
 
 		if (wq != nullptr) {
+#if defined(CONFIG_PX4_WORK_QUEUE_POOL)
+
+			if (WorkQueuePoolEligible(*wq) && (WorkQueuePoolStart() == PX4_OK)) {
+				// no dedicated thread, served by the pool
+				_wq_manager_wqs_list->add(new WorkQueue(*wq, true));
+				continue;
+			}
+
+#endif // CONFIG_PX4_WORK_QUEUE_POOL
+
 			// create new work queue
 
 			// stack size
@@ -437,6 +738,10 @@ WorkQueueManagerStop()
 				px4_usleep(1000);
 			}
 
+#if defined(CONFIG_PX4_WORK_QUEUE_POOL)
+			WorkQueuePoolStop();
+#endif // CONFIG_PX4_WORK_QUEUE_POOL
+
 			delete _wq_manager_wqs_list;
 			_wq_manager_wqs_list = nullptr;
 		}
@@ -461,6 +766,23 @@ WorkQueueManagerStop()
 	return PX4_OK;
 }
 
+#if defined(CONFIG_PX4_WORK_QUEUE_TRACE)
+void
+WorkQueueManagerTraceIterate(wq_trace_callback cb, void *user)
+{
+	if (!_wq_manager_running.load()) {
+		return;
+	}
+
+	LockGuard lg{_wq_manager_wqs_list->mutex()};
+	int index = 0;
+
+	for (WorkQueue *wq : *_wq_manager_wqs_list) {
+		cb(*wq, index++, user);
+	}
+}
+#endif // CONFIG_PX4_WORK_QUEUE_TRACE
+
 int
 WorkQueueManagerStatus()
 {
@@ -487,6 +809,10 @@ WorkQueueManagerStatus()
 			wq->print_status(last_wq);
 		}
 
+#if defined(CONFIG_PX4_WORK_QUEUE_POOL)
+		WorkQueuePoolStatus();
+#endif // CONFIG_PX4_WORK_QUEUE_POOL
+
 	} else {
 		PX4_INFO("not running");
 	}
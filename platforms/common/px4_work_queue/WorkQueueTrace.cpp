@@ -0,0 +1,98 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2025 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include <px4_platform_common/px4_work_queue/WorkQueueTrace.hpp>
+
+#if defined(CONFIG_PX4_WORK_QUEUE_TRACE)
+
+namespace px4
+{
+
+static const char *trace_item_names[WorkQueueTrace::MAX_ITEMS] {};
+static px4::atomic<uint16_t> trace_item_count{0};
+
+uint16_t WorkQueueTrace::register_item(const char *name)
+{
+	uint16_t id = trace_item_count.fetch_add(1);
+
+	if (id >= MAX_ITEMS) {
+		id = MAX_ITEMS - 1;
+		trace_item_count.store(MAX_ITEMS);
+	}
+
+	__atomic_store_n(&trace_item_names[id], name, __ATOMIC_RELEASE);
+	return id;
+}
+
+const char *WorkQueueTrace::item_name(uint16_t item_id)
+{
+	const char *name = nullptr;
+
+	if (item_id < MAX_ITEMS) {
+		name = __atomic_load_n(&trace_item_names[item_id], __ATOMIC_ACQUIRE);
+	}
+
+	return (name != nullptr) ? name : "unknown";
+}
+
+uint16_t WorkQueueTrace::item_count()
+{
+	const uint16_t count = trace_item_count.load();
+	return (count < MAX_ITEMS) ? count : MAX_ITEMS;
+}
+
+bool WorkQueueTrace::read(uint32_t &index, Event &event) const
+{
+	if (index < tail()) {
+		index = tail();
+	}
+
+	const Event &slot = _events[index % EVENTS];
+
+	const uint32_t sequence = __atomic_load_n(&slot.sequence, __ATOMIC_ACQUIRE);
+
+	if (sequence != index + 1) {
+		// not written yet, being written, or already overwritten by a newer event
+		return false;
+	}
+
+	event = slot;
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+	// check it wasn't overwritten while copying
+	return __atomic_load_n(&slot.sequence, __ATOMIC_RELAXED) == sequence;
+}
+
+} // namespace px4
+
+#endif // CONFIG_PX4_WORK_QUEUE_TRACE
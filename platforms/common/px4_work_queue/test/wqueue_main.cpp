@@ -32,6 +32,7 @@
  ****************************************************************************/
 
 #include "wqueue_test.h"
+#include "wqueue_priority_test.h"
 #include "wqueue_scheduled_test.h"
 
 #include <px4_platform_common/log.h>
@@ -51,6 +52,10 @@ int PX4_MAIN(int argc, char **argv)
 	WQueueScheduledTest wq2;
 	wq2.main();
 
+	PX4_INFO("wqueue test 3 (priority)");
+	WQueuePriorityTest wq3;
+	wq3.main();
+
 	PX4_INFO("wqueue test complete, exiting");
 
 	return 0;
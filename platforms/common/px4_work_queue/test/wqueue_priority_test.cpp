@@ -0,0 +1,94 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2025 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "wqueue_priority_test.h"
+
+#include <px4_platform_common/log.h>
+#include <px4_platform_common/time.h>
+
+using namespace px4;
+
+void WQueuePriorityTest::Item::Run()
+{
+	if (_id == 0) {
+		// block the queue so that the other items are all pending at the same time
+		px4_usleep(50000);
+	}
+
+	const int index = _parent._run_count.fetch_add(1);
+
+	if (index < NUM_ITEMS) {
+		_parent._run_order[index] = _id;
+	}
+}
+
+int WQueuePriorityTest::main()
+{
+	Item blocker{*this, 0};
+	Item low{*this, 1};
+	Item medium{*this, 2};
+	Item high{*this, 3};
+
+	low.SetSchedulingPriority(-10);
+	medium.SetSchedulingPriority(0);
+	high.SetSchedulingPriority(10);
+
+	blocker.ScheduleNow();
+	px4_usleep(10000);
+
+	// queued in reverse priority order while the blocker is running
+	low.ScheduleNow();
+	medium.ScheduleNow();
+	high.ScheduleNow();
+
+	while (_run_count.load() < NUM_ITEMS) {
+		px4_usleep(10000);
+	}
+
+#if defined(CONFIG_PX4_WORK_QUEUE_PRIORITY_SCHEDULER)
+	static constexpr int expected_order[NUM_ITEMS] {0, 3, 2, 1};
+#else
+	static constexpr int expected_order[NUM_ITEMS] {0, 1, 2, 3};
+#endif
+
+	for (int i = 0; i < NUM_ITEMS; i++) {
+		if (_run_order[i] != expected_order[i]) {
+			PX4_ERR("WQueuePriorityTest FAILED: position %d ran item %d, expected %d", i, _run_order[i], expected_order[i]);
+			return 1;
+		}
+	}
+
+	PX4_INFO("WQueuePriorityTest finished");
+
+	return 0;
+}
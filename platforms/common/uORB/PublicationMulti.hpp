@@ -92,6 +92,25 @@ public:
 		return (orb_publish(get_topic(), _handle, &data) == PX4_OK);
 	}
 
+	/**
+	 * Loan the next message slot of the topic queue to fill it in place (zero-copy).
+	 * The whole struct must be written, then published with commit().
+	 * @return pointer to the slot, nullptr if loaning isn't possible (use publish() instead)
+	 */
+	T *loan()
+	{
+		if (!advertised()) {
+			advertise();
+		}
+
+		return static_cast<T *>(Manager::orb_loan(get_topic(), _handle));
+	}
+
+	/**
+	 * Publish the struct previously returned by loan()
+	 */
+	bool commit() { return (Manager::orb_commit(get_topic(), _handle) == PX4_OK); }
+
 	int get_instance()
 	{
 		// advertise if not already advertised
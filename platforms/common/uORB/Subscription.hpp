@@ -163,6 +163,32 @@ public:
 		return false;
 	}
 
+	/**
+	 * Borrow the next update in place instead of copying it (zero-copy)
+	 * The message stays in the topic queue and can be overwritten by the publisher at
+	 * any time, so anything read from it must be discarded if release() fails.
+	 * @param borrowed_generation The generation of the borrowed message, to pass to release().
+	 * @return Pointer to the message, nullptr if not updated (or borrowing isn't supported).
+	 */
+	const void *borrow(unsigned &borrowed_generation)
+	{
+		if (subscribe()) {
+			return Manager::orb_data_borrow(_node, _last_generation, borrowed_generation, true);
+		}
+
+		return nullptr;
+	}
+
+	/**
+	 * Finish borrowing a message
+	 * @param borrowed_generation The generation returned by borrow().
+	 * @return true if the message was not overwritten while borrowed.
+	 */
+	bool release(unsigned borrowed_generation)
+	{
+		return (_node != nullptr) && Manager::orb_data_release(_node, borrowed_generation);
+	}
+
 	/**
 	 * Change subscription instance
 	 * @param instance The new multi-Subscription instance
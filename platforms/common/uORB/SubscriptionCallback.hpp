@@ -166,6 +166,7 @@ public:
 		if ((_required_updates == 0)
 		    || (Manager::updates_available(_subscription.get_node(), _subscription.get_last_generation()) >= _required_updates)) {
 			if (updated()) {
+				PX4_WQ_TRACE_WAKEUP(_work_item, _subscription.get_topic()->o_id);
 				_work_item->ScheduleNow();
 			}
 		}
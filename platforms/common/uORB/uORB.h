@@ -54,9 +54,17 @@ struct orb_metadata {
 	uint32_t message_hash;	/**< Hash over all fields for message compatibility checks */
 	orb_id_size_t  o_id;                /**< ORB_ID enum */
 	uint8_t o_queue;					/**< queue size */
+	uint8_t o_flags;					/**< ORB_FLAG_* bitmask */
 
 };
 
+/**
+ * Publish and copy through a lock-free sequence lock instead of the node lock.
+ * Readers retry on torn reads, the (single) publisher never blocks.
+ * Selected with the ORB_SEQLOCK constant in the message definition.
+ */
+#define ORB_FLAG_SEQLOCK (1 << 0)
+
 typedef const struct orb_metadata *orb_id_t;
 
 /**
@@ -105,15 +113,17 @@ typedef const struct orb_metadata *orb_id_t;
  * @param _message_hash	32 bit message hash over all fields
  * @param _orb_id_enum	ORB ID enum e.g.: ORB_ID::vehicle_status
  * @param _queue_size Queue size from topic definition
+ * @param _flags	ORB_FLAG_* bitmask from topic definition
  */
-#define ORB_DEFINE(_name, _struct, _size_no_padding, _message_hash, _orb_id_enum, _queue_size)               \
+#define ORB_DEFINE(_name, _struct, _size_no_padding, _message_hash, _orb_id_enum, _queue_size, _flags)       \
 	const struct orb_metadata __orb_##_name = {     \
 		#_name,                                 \
 		sizeof(_struct),                \
 		_size_no_padding,                       \
 		_message_hash,                          \
 		_orb_id_enum,                           \
-		_queue_size                             \
+		_queue_size,                            \
+		_flags                                  \
 	}; struct hack
 
 __BEGIN_DECLS
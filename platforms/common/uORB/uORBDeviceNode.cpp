@@ -138,6 +138,73 @@ uORB::DeviceNode::read(cdev::file_t *filp, char *buffer, size_t buflen)
 
 ssize_t
 uORB::DeviceNode::write(cdev::file_t *filp, const char *buffer, size_t buflen)
+{
+	/*
+	 * Note that filp will usually be NULL.
+	 */
+	const bool seqlock = _meta->o_flags & ORB_FLAG_SEQLOCK;
+
+	if (!allocate_data(seqlock)) {
+		return -ENOMEM;
+	}
+
+	/* If write size does not match, that is an error */
+	if (_meta->o_size != buflen) {
+		return -EIO;
+	}
+
+	if (seqlock) {
+		/*
+		 * Lock-free write: announce the write, fill the spare slot (not readable
+		 * by subscribers yet), then publish it. Readers detect overwrites of the
+		 * slot they are copying through _write_generation and retry.
+		 */
+		_write_generation.fetch_add(1);
+		memcpy(slot(_generation.load()), buffer, _meta->o_size);
+		_generation.fetch_add(1);
+
+		/* Mark at least one data has been published */
+		_data_valid = true;
+
+		// callbacks, only lock if there are any
+		if (!_callbacks.empty()) {
+			ATOMIC_ENTER;
+
+			for (auto item : _callbacks) {
+				item->call();
+			}
+
+			ATOMIC_LEAVE;
+		}
+
+	} else {
+		/* Perform an atomic copy. */
+		ATOMIC_ENTER;
+		_write_generation.fetch_add(1);
+		/* wrap-around happens after ~49 days, assuming a publisher rate of 1 kHz */
+		unsigned generation = _generation.fetch_add(1);
+
+		memcpy(slot(generation), buffer, _meta->o_size);
+
+		// callbacks
+		for (auto item : _callbacks) {
+			item->call();
+		}
+
+		/* Mark at least one data has been published */
+		_data_valid = true;
+
+		ATOMIC_LEAVE;
+	}
+
+	/* notify any poll waiters */
+	poll_notify(POLLIN);
+
+	return _meta->o_size;
+}
+
+bool
+uORB::DeviceNode::allocate_data(bool spare_slot)
 {
 	/*
 	 * Writes are legal from interrupt context as long as the
@@ -145,8 +212,6 @@ uORB::DeviceNode::write(cdev::file_t *filp, const char *buffer, size_t buflen)
 	 *
 	 * Writes outside interrupt context will allocate the object
 	 * if it has not yet been allocated.
-	 *
-	 * Note that filp will usually be NULL.
 	 */
 	if (nullptr == _data) {
 
@@ -159,11 +224,16 @@ uORB::DeviceNode::write(cdev::file_t *filp, const char *buffer, size_t buflen)
 
 			/* re-check size */
 			if (nullptr == _data) {
-				const size_t data_size = _meta->o_size * _meta->o_queue;
-				_data = (uint8_t *) px4_cache_aligned_alloc(data_size);
+				const uint8_t slots = _meta->o_queue + (spare_slot ? 1 : 0);
+				const size_t data_size = _meta->o_size * slots;
+				uint8_t *data = (uint8_t *) px4_cache_aligned_alloc(data_size);
+
+				if (data) {
+					memset(data, 0, data_size);
+					_slots = slots;
 
-				if (_data) {
-					memset(_data, 0, data_size);
+					// lock-free readers (seqlock, borrow) must see _slots once _data is set
+					__atomic_store_n(&_data, data, __ATOMIC_RELEASE);
 				}
 			}
 
@@ -173,39 +243,38 @@ uORB::DeviceNode::write(cdev::file_t *filp, const char *buffer, size_t buflen)
 		}
 
 #endif /* __PX4_NUTTX */
-
-		/* failed or could not allocate */
-		if (nullptr == _data) {
-			return -ENOMEM;
-		}
 	}
 
-	/* If write size does not match, that is an error */
-	if (_meta->o_size != buflen) {
-		return -EIO;
-	}
+	/* failed or could not allocate */
+	return (nullptr != _data);
+}
 
-	/* Perform an atomic copy. */
-	ATOMIC_ENTER;
-	/* wrap-around happens after ~49 days, assuming a publisher rate of 1 kHz */
-	unsigned generation = _generation.fetch_add(1);
+bool
+uORB::DeviceNode::copy_seqlock(void *dst, unsigned &generation)
+{
+	for (;;) {
+		const unsigned current_generation = _generation.load();
+		unsigned copy_generation = current_generation - 1;
 
-	memcpy(_data + (_meta->o_size * (generation % _meta->o_queue)), buffer, _meta->o_size);
+		if (_meta->o_queue > 1) {
+			/* same selection as copy(): next unread, or the last one again if nothing new */
+			copy_generation = (current_generation == generation) ? generation - 1 : generation;
 
-	// callbacks
-	for (auto item : _callbacks) {
-		item->call();
-	}
+			if (!is_in_range(current_generation - _meta->o_queue, copy_generation, current_generation - 1)) {
+				// Reader is too far behind: some messages are lost
+				copy_generation = current_generation - _meta->o_queue;
+			}
+		}
 
-	/* Mark at least one data has been published */
-	_data_valid = true;
+		memcpy(dst, slot(copy_generation), _meta->o_size);
 
-	ATOMIC_LEAVE;
-
-	/* notify any poll waiters */
-	poll_notify(POLLIN);
+		if (release(copy_generation)) {
+			generation = (_meta->o_queue == 1) ? current_generation : copy_generation + 1;
+			return true;
+		}
 
-	return _meta->o_size;
+		// torn read, the publisher started overwriting the slot: retry
+	}
 }
 
 int
@@ -291,6 +360,114 @@ uORB::DeviceNode::publish(const orb_metadata *meta, orb_advert_t handle, const v
 	return PX4_OK;
 }
 
+void *
+uORB::DeviceNode::loan(const orb_metadata *meta, orb_advert_t handle)
+{
+	uORB::DeviceNode *devnode = (uORB::DeviceNode *)handle;
+
+	/* check if the device handle is initialized */
+	if ((devnode == nullptr) || (meta == nullptr)) {
+		errno = EFAULT;
+		return nullptr;
+	}
+
+	/* check if the orb meta data matches the publication */
+	if (devnode->_meta->o_id != meta->o_id) {
+		errno = EINVAL;
+		return nullptr;
+	}
+
+	return devnode->loan_slot();
+}
+
+void *
+uORB::DeviceNode::loan_slot()
+{
+	if (!allocate_data(true)) {
+		errno = ENOMEM;
+		return nullptr;
+	}
+
+	/* without a spare slot the loaned slot could be the one a subscriber is copying */
+	if (_slots == _meta->o_queue) {
+		errno = EBUSY;
+		return nullptr;
+	}
+
+	/*
+	 * Start the write before handing out the slot, so that subscribers which
+	 * borrowed the message previously stored in this slot detect the overwrite.
+	 * Copying subscribers never read this slot, it is not part of the queue yet.
+	 */
+	ATOMIC_ENTER;
+	_write_generation.fetch_add(1);
+	uint8_t *loaned = slot(_generation.load());
+	ATOMIC_LEAVE;
+
+	return loaned;
+}
+
+ssize_t
+uORB::DeviceNode::commit(const orb_metadata *meta, orb_advert_t handle)
+{
+	uORB::DeviceNode *devnode = (uORB::DeviceNode *)handle;
+
+	/* check if the device handle is initialized and a slot was loaned */
+	if ((devnode == nullptr) || (meta == nullptr) || (devnode->_data == nullptr)) {
+		errno = EFAULT;
+		return PX4_ERROR;
+	}
+
+	/* check if the orb meta data matches the publication */
+	if (devnode->_meta->o_id != meta->o_id) {
+		errno = EINVAL;
+		return PX4_ERROR;
+	}
+
+	const uint8_t *data = devnode->commit_slot();
+
+#ifdef CONFIG_ORB_COMMUNICATOR
+	/*
+	 * send the committed slot over the Multi-ORB link
+	 */
+	uORBCommunicator::IChannel *ch = uORB::Manager::get_instance()->get_uorb_communicator();
+
+	if (ch != nullptr) {
+		if (ch->send_message(meta->o_name, meta->o_size, (uint8_t *)data) != 0) {
+			PX4_ERR("Error Sending [%s] topic data over comm_channel", meta->o_name);
+			return PX4_ERROR;
+		}
+	}
+
+#else
+	(void)data;
+#endif /* CONFIG_ORB_COMMUNICATOR */
+
+	return PX4_OK;
+}
+
+const uint8_t *
+uORB::DeviceNode::commit_slot()
+{
+	ATOMIC_ENTER;
+	const unsigned generation = _generation.fetch_add(1);
+
+	// callbacks
+	for (auto item : _callbacks) {
+		item->call();
+	}
+
+	/* Mark at least one data has been published */
+	_data_valid = true;
+
+	ATOMIC_LEAVE;
+
+	/* notify any poll waiters */
+	poll_notify(POLLIN);
+
+	return slot(generation);
+}
+
 int uORB::DeviceNode::unadvertise(orb_advert_t handle)
 {
 	if (handle == nullptr) {
@@ -414,7 +591,7 @@ int16_t uORB::DeviceNode::process_add_subscription()
 	if (_data != nullptr && ch != nullptr) { // _data will not be null if there is a publisher.
 		// Only send the most recent data to initialize the remote end.
 		if (_data_valid) {
-			ch->send_message(_meta->o_name, _meta->o_size, _data + (_meta->o_size * ((_generation.load() - 1) % _meta->o_queue)));
+			ch->send_message(_meta->o_name, _meta->o_size, slot(_generation.load() - 1));
 		}
 	}
 
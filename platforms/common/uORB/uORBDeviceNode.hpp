@@ -121,6 +121,19 @@ public:
 	 */
 	static ssize_t    publish(const orb_metadata *meta, orb_advert_t handle, const void *data);
 
+	/**
+	 * Loan the next queue slot to the publisher so the message can be filled in place (zero-copy).
+	 * The loan must be completed with commit(). Only a single publisher and a single
+	 * outstanding loan per node are supported.
+	 * @return pointer to the slot, nullptr if the buffer was already allocated without a spare slot
+	 */
+	static void      *loan(const orb_metadata *meta, orb_advert_t handle);
+
+	/**
+	 * Publish the slot previously handed out by loan().
+	 */
+	static ssize_t    commit(const orb_metadata *meta, orb_advert_t handle);
+
 	static int        unadvertise(orb_advert_t handle);
 
 #ifdef CONFIG_ORB_COMMUNICATOR
@@ -225,10 +238,13 @@ public:
 	bool copy(void *dst, unsigned &generation)
 	{
 		if ((dst != nullptr) && (_data != nullptr)) {
-			if (_meta->o_queue == 1) {
+			if (_meta->o_flags & ORB_FLAG_SEQLOCK) {
+				return copy_seqlock(dst, generation);
+
+			} else if (_meta->o_queue == 1) {
 				ATOMIC_ENTER;
-				memcpy(dst, _data, _meta->o_size);
 				generation = _generation.load();
+				memcpy(dst, slot(generation - 1), _meta->o_size);
 				ATOMIC_LEAVE;
 				return true;
 
@@ -249,7 +265,7 @@ public:
 					generation = current_generation - _meta->o_queue;
 				}
 
-				memcpy(dst, _data + (_meta->o_size * (generation % _meta->o_queue)), _meta->o_size);
+				memcpy(dst, slot(generation), _meta->o_size);
 				ATOMIC_LEAVE;
 
 				++generation;
@@ -262,6 +278,61 @@ public:
 
 	}
 
+	/**
+	 * Borrows a message in place instead of copying it out (zero-copy).
+	 * The queue slot may be overwritten by the publisher while borrowed, so the reader
+	 * must call release() once done and discard what it read if that returns false.
+	 *
+	 * @param generation
+	 *   The subscriber generation, updated the same way as by copy().
+	 * @param borrowed_generation
+	 *   The generation of the borrowed message, to be passed to release().
+	 * @return
+	 *   Pointer to the message in the queue, nullptr if there is no data.
+	 */
+	const void *borrow(unsigned &generation, unsigned &borrowed_generation)
+	{
+		if (_data == nullptr) {
+			return nullptr;
+		}
+
+		ATOMIC_ENTER;
+		const unsigned current_generation = _generation.load();
+
+		if (current_generation == generation) {
+			--generation;
+		}
+
+		if ((_meta->o_queue == 1)
+		    || !is_in_range(current_generation - _meta->o_queue, generation, current_generation - 1)) {
+			// single element queue or reader too far behind: take the oldest still valid
+			generation = current_generation - _meta->o_queue;
+		}
+
+		borrowed_generation = generation;
+		ATOMIC_LEAVE;
+
+		++generation;
+
+		return slot(borrowed_generation);
+	}
+
+	/**
+	 * Ends a borrow() and checks that the message was not overwritten in the meantime.
+	 * @param borrowed_generation
+	 *   The generation returned by borrow().
+	 * @return bool
+	 *   true if the borrowed data is consistent
+	 */
+	bool release(unsigned borrowed_generation) const
+	{
+		// order the reads of the borrowed slot before checking the write generation
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+		// the slot is reused by generation borrowed_generation + _slots
+		return (_write_generation.load() - borrowed_generation) <= _slots;
+	}
+
 	// add item to list of work items to schedule on node update
 	bool register_callback(SubscriptionCallback *callback_sub);
 
@@ -281,7 +352,9 @@ private:
 
 	uint8_t *_data{nullptr};   /**< allocated object buffer */
 	bool _data_valid{false}; /**< At least one valid data */
+	uint8_t _slots{0};         /**< number of message slots in _data (queue size, +1 if allocated for loans) */
 	px4::atomic<unsigned>  _generation{0};  /**< object generation count */
+	px4::atomic<unsigned>  _write_generation{0};  /**< number of started writes (including an outstanding loan) */
 	List<uORB::SubscriptionCallback *>	_callbacks;
 
 	const uint8_t _instance; /**< orb multi instance identifier */
@@ -290,6 +363,25 @@ private:
 	int8_t _subscriber_count{0};
 
 
+	/**
+	 * Allocate the message buffer if it does not exist yet.
+	 * @param spare_slot allocate one more slot than the queue size, so that a loaned
+	 *                   (or seqlock written) slot never aliases a message which can
+	 *                   still be copied out
+	 */
+	bool allocate_data(bool spare_slot);
+
+	/**
+	 * Lock-free copy for ORB_FLAG_SEQLOCK topics, retries if the publisher
+	 * started overwriting the slot during the copy.
+	 */
+	bool copy_seqlock(void *dst, unsigned &generation);
+
+	void *loan_slot();
+	const uint8_t *commit_slot();
+
+	uint8_t *slot(unsigned generation) const { return _data + (_meta->o_size * (generation % _slots)); }
+
 // Determine the data range
 	static inline bool is_in_range(unsigned left, unsigned value, unsigned right)
 	{
@@ -375,6 +375,33 @@ int uORB::Manager::orb_publish(const struct orb_metadata *meta, orb_advert_t han
 	return uORB::DeviceNode::publish(meta, handle, data);
 }
 
+void *uORB::Manager::orb_loan(const struct orb_metadata *meta, orb_advert_t handle)
+{
+#ifdef ORB_USE_PUBLISHER_RULES
+
+	if (handle == _Instance) {
+		errno = EPERM;
+		return nullptr; // publishing is not allowed, caller falls back to orb_publish
+	}
+
+#endif /* ORB_USE_PUBLISHER_RULES */
+
+	return uORB::DeviceNode::loan(meta, handle);
+}
+
+int uORB::Manager::orb_commit(const struct orb_metadata *meta, orb_advert_t handle)
+{
+#ifdef ORB_USE_PUBLISHER_RULES
+
+	if (handle == _Instance) {
+		return PX4_OK; //pretend success
+	}
+
+#endif /* ORB_USE_PUBLISHER_RULES */
+
+	return uORB::DeviceNode::commit(meta, handle);
+}
+
 int uORB::Manager::orb_copy(const struct orb_metadata *meta, int handle, void *buffer)
 {
 	int ret;
@@ -458,6 +485,25 @@ bool uORB::Manager::orb_data_copy(void *node_handle, void *dst, unsigned &genera
 	return static_cast<DeviceNode *>(node_handle)->copy(dst, generation);
 }
 
+const void *uORB::Manager::orb_data_borrow(void *node_handle, unsigned &generation, unsigned &borrowed_generation,
+		bool only_if_updated)
+{
+	if (!is_advertised(node_handle)) {
+		return nullptr;
+	}
+
+	if (only_if_updated && !static_cast<const uORB::DeviceNode *>(node_handle)->updates_available(generation)) {
+		return nullptr;
+	}
+
+	return static_cast<DeviceNode *>(node_handle)->borrow(generation, borrowed_generation);
+}
+
+bool uORB::Manager::orb_data_release(const void *node_handle, unsigned borrowed_generation)
+{
+	return static_cast<const DeviceNode *>(node_handle)->release(borrowed_generation);
+}
+
 // add item to list of work items to schedule on node update
 bool uORB::Manager::register_callback(void *node_handle, SubscriptionCallback *callback_sub)
 {
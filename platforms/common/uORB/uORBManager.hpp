@@ -279,6 +279,32 @@ public:
 	 */
 	static int  orb_publish(const struct orb_metadata *meta, orb_advert_t handle, const void *data);
 
+	/**
+	 * Loan the next message slot of a topic for in-place (zero-copy) publication.
+	 *
+	 * The returned buffer must be filled completely and then published with
+	 * orb_commit(). Subscribers are not notified until the commit.
+	 * Only one outstanding loan per topic instance is allowed, and loaning cannot
+	 * be mixed with orb_publish() for the same topic instance.
+	 *
+	 * @param meta    The uORB metadata (usually from the ORB_ID() macro)
+	 *      for the topic.
+	 * @param handle  The handle returned from orb_advertise.
+	 * @return    Pointer to the message slot, nullptr if loaning is not possible
+	 *      (errno set accordingly). Use orb_publish() in that case.
+	 */
+	static void *orb_loan(const struct orb_metadata *meta, orb_advert_t handle);
+
+	/**
+	 * Publish the message slot previously loaned with orb_loan().
+	 *
+	 * @param meta    The uORB metadata (usually from the ORB_ID() macro)
+	 *      for the topic.
+	 * @param handle  The handle returned from orb_advertise.
+	 * @return    OK on success, PX4_ERROR otherwise with errno set accordingly.
+	 */
+	static int  orb_commit(const struct orb_metadata *meta, orb_advert_t handle);
+
 	/**
 	 * Subscribe to a topic.
 	 *
@@ -442,6 +468,11 @@ public:
 
 	static bool orb_data_copy(void *node_handle, void *dst, unsigned &generation, bool only_if_updated);
 
+	static const void *orb_data_borrow(void *node_handle, unsigned &generation, unsigned &borrowed_generation,
+					   bool only_if_updated);
+
+	static bool orb_data_release(const void *node_handle, unsigned borrowed_generation);
+
 	static bool register_callback(void *node_handle, SubscriptionCallback *callback_sub);
 
 	static void unregister_callback(void *node_handle, SubscriptionCallback *callback_sub);
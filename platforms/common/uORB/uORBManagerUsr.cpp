@@ -155,6 +155,19 @@ int uORB::Manager::orb_publish(const struct orb_metadata *meta, orb_advert_t han
 	return d.ret;
 }
 
+void *uORB::Manager::orb_loan(const struct orb_metadata *meta, orb_advert_t handle)
+{
+	// the message buffers live in kernel memory, fall back to orb_publish()
+	errno = ENOTSUP;
+	return nullptr;
+}
+
+int uORB::Manager::orb_commit(const struct orb_metadata *meta, orb_advert_t handle)
+{
+	errno = ENOTSUP;
+	return PX4_ERROR;
+}
+
 int uORB::Manager::orb_copy(const struct orb_metadata *meta, int handle, void *buffer)
 {
 	int ret;
@@ -302,6 +315,18 @@ bool uORB::Manager::orb_data_copy(void *node_handle, void *dst, unsigned &genera
 	return data.ret;
 }
 
+const void *uORB::Manager::orb_data_borrow(void *node_handle, unsigned &generation, unsigned &borrowed_generation,
+		bool only_if_updated)
+{
+	// the message buffers live in kernel memory, fall back to orb_data_copy()
+	return nullptr;
+}
+
+bool uORB::Manager::orb_data_release(const void *node_handle, unsigned borrowed_generation)
+{
+	return false;
+}
+
 bool uORB::Manager::register_callback(void *node_handle, SubscriptionCallback *callback_sub)
 {
 	orbiocdevregcallback_t data = {node_handle, callback_sub, false};
@@ -39,7 +39,9 @@
 #include <errno.h>
 #include <math.h>
 #include <lib/cdev/CDev.hpp>
+#include <uORB/Publication.hpp>
 #include <uORB/PublicationMulti.hpp>
+#include <uORB/Subscription.hpp>
 #include <uORB/SubscriptionMultiArray.hpp>
 
 uORBTest::UnitTest &uORBTest::UnitTest::instance()
@@ -213,7 +215,25 @@ int uORBTest::UnitTest::test()
 		return ret;
 	}
 
-	return test_queue_poll_notify();
+	ret = test_queue_poll_notify();
+
+	if (ret != OK) {
+		return ret;
+	}
+
+	ret = test_loan();
+
+	if (ret != OK) {
+		return ret;
+	}
+
+	ret = test_loan_queue();
+
+	if (ret != OK) {
+		return ret;
+	}
+
+	return test_seqlock();
 }
 
 int uORBTest::UnitTest::test_unadvertise()
@@ -1092,6 +1112,399 @@ int uORBTest::UnitTest::latency_test(bool print)
 	return pubsubtest_res;
 }
 
+int uORBTest::UnitTest::test_loan()
+{
+	test_note("Testing zero-copy loan/borrow");
+
+	uORB::Publication<orb_test_large_s> pub{ORB_ID(orb_test_large_loan)};
+	uORB::Subscription sub{ORB_ID(orb_test_large_loan)};
+
+	orb_test_large_s *loaned = pub.loan();
+
+	if (loaned == nullptr) {
+		return test_fail("loan failed: %d", errno);
+	}
+
+	if (sub.updated()) {
+		return test_fail("updated before commit");
+	}
+
+	loaned->timestamp = hrt_absolute_time();
+	loaned->val = 1;
+
+	if (!pub.commit()) {
+		return test_fail("commit failed: %d", errno);
+	}
+
+	orb_test_large_s copied{};
+
+	if (!sub.copy(&copied) || copied.val != 1) {
+		return test_fail("copy after commit mismatch: %d", copied.val);
+	}
+
+	// a new subscription starts at the latest message
+	uORB::Subscription sub_borrow{ORB_ID(orb_test_large_loan)};
+	unsigned borrowed_generation = 0;
+	const orb_test_large_s *borrowed = static_cast<const orb_test_large_s *>(sub_borrow.borrow(borrowed_generation));
+
+	if (borrowed == nullptr || borrowed->val != 1 || !sub_borrow.release(borrowed_generation)) {
+		return test_fail("borrow failed");
+	}
+
+	if (sub_borrow.borrow(borrowed_generation) != nullptr) {
+		return test_fail("borrow without update");
+	}
+
+	// one loan is allowed while borrowed (spare slot), the next one overwrites the borrowed message
+	loaned = pub.loan();
+	loaned->val = 2;
+	pub.commit();
+
+	borrowed = static_cast<const orb_test_large_s *>(sub_borrow.borrow(borrowed_generation));
+
+	if (borrowed == nullptr || borrowed->val != 2) {
+		return test_fail("borrow(2) failed");
+	}
+
+	loaned = pub.loan();
+
+	if (!sub_borrow.release(borrowed_generation)) {
+		return test_fail("borrow invalidated by loan of the spare slot");
+	}
+
+	loaned->val = 3;
+	pub.commit();
+
+	loaned = pub.loan();
+
+	if (sub_borrow.release(borrowed_generation)) {
+		return test_fail("overwrite of borrowed message not detected");
+	}
+
+	loaned->val = 4;
+	pub.commit();
+
+	if (!sub.copy(&copied) || copied.val != 4) {
+		return test_fail("copy after loan mismatch: %d", copied.val);
+	}
+
+	// a topic already allocated by a regular publish has no spare slot and can't be loaned
+	uORB::Publication<orb_test_large_s> pub_copy{ORB_ID(orb_test_large_copy)};
+	pub_copy.publish(copied);
+
+	if (pub_copy.loan() != nullptr) {
+		return test_fail("loan on topic without spare slot");
+	}
+
+	return test_note("PASS zero-copy loan/borrow");
+}
+
+int uORBTest::UnitTest::test_loan_queue()
+{
+	test_note("Testing zero-copy loan/borrow with queue");
+
+	uORB::Publication<orb_test_medium_s> pub{ORB_ID(orb_test_medium_queue_loan)};
+	uORB::Subscription sub{ORB_ID(orb_test_medium_queue_loan)};
+
+	const int queue_size = orb_get_queue_size(ORB_ID(orb_test_medium_queue_loan));
+	const int overflow_by = 3;
+
+	for (int i = 0; i < queue_size + overflow_by; ++i) {
+		orb_test_medium_s *loaned = pub.loan();
+
+		if (loaned == nullptr) {
+			return test_fail("loan failed: %d", errno);
+		}
+
+		loaned->val = i;
+		pub.commit();
+	}
+
+	for (int i = 0; i < queue_size; ++i) {
+		unsigned borrowed_generation = 0;
+		const orb_test_medium_s *borrowed = static_cast<const orb_test_medium_s *>(sub.borrow(borrowed_generation));
+
+		if (borrowed == nullptr) {
+			return test_fail("borrow failed, element %i", i);
+		}
+
+		if (borrowed->val != i + overflow_by) {
+			return test_fail("got wrong element from the queue (got %i, should be %i)", borrowed->val, i + overflow_by);
+		}
+
+		if (!sub.release(borrowed_generation)) {
+			return test_fail("release failed, element %i", i);
+		}
+	}
+
+	unsigned borrowed_generation = 0;
+
+	if (sub.borrow(borrowed_generation) != nullptr) {
+		return test_fail("borrow without update");
+	}
+
+	return test_note("PASS zero-copy loan/borrow with queue");
+}
+
+int uORBTest::UnitTest::zero_copy_benchmark()
+{
+	test_note("---------------- ZERO-COPY BENCHMARK ------------------");
+
+	static constexpr int RUNS = 10000;
+
+	uORB::Publication<orb_test_large_s> pub_copy{ORB_ID(orb_test_large_copy)};
+	uORB::Subscription sub_copy{ORB_ID(orb_test_large_copy)};
+
+	uORB::Publication<orb_test_large_s> pub_loan{ORB_ID(orb_test_large_loan)};
+	uORB::Subscription sub_loan{ORB_ID(orb_test_large_loan)};
+
+	orb_test_large_s msg{};
+	orb_test_large_s received{};
+	int32_t checksum = 0;
+
+	// memcpy path: fill a local struct, publish() copies it in, copy() copies it out
+	const hrt_abstime copy_start = hrt_absolute_time();
+
+	for (int i = 0; i < RUNS; i++) {
+		msg.timestamp = hrt_absolute_time();
+		msg.val = i;
+		memset(msg.junk, i, sizeof(msg.junk));
+		pub_copy.publish(msg);
+
+		if (sub_copy.update(&received)) {
+			checksum += received.val + received.junk[sizeof(received.junk) - 1];
+		}
+	}
+
+	const hrt_abstime copy_elapsed = hrt_elapsed_time(&copy_start);
+
+	// zero-copy path: fill the loaned slot, read the message in place
+	const hrt_abstime loan_start = hrt_absolute_time();
+	unsigned failed_borrows = 0;
+
+	for (int i = 0; i < RUNS; i++) {
+		orb_test_large_s *loaned = pub_loan.loan();
+
+		if (loaned == nullptr) {
+			return test_fail("loan failed: %d", errno);
+		}
+
+		loaned->timestamp = hrt_absolute_time();
+		loaned->val = i;
+		memset(loaned->junk, i, sizeof(loaned->junk));
+		pub_loan.commit();
+
+		unsigned borrowed_generation = 0;
+		const orb_test_large_s *borrowed = static_cast<const orb_test_large_s *>(sub_loan.borrow(borrowed_generation));
+
+		if (borrowed != nullptr) {
+			const int32_t value = borrowed->val + borrowed->junk[sizeof(borrowed->junk) - 1];
+
+			if (sub_loan.release(borrowed_generation)) {
+				checksum -= value;
+
+			} else {
+				failed_borrows++;
+			}
+		}
+	}
+
+	const hrt_abstime loan_elapsed = hrt_elapsed_time(&loan_start);
+
+	PX4_INFO("message size: %u bytes, %d runs", (unsigned)sizeof(orb_test_large_s), RUNS);
+	PX4_INFO("memcpy publish/copy:  %8.4f us/msg", static_cast<double>((float)copy_elapsed / RUNS));
+	PX4_INFO("loan commit/borrow:   %8.4f us/msg", static_cast<double>((float)loan_elapsed / RUNS));
+	PX4_INFO("failed borrows: %u", failed_borrows);
+
+	if (checksum != 0) {
+		return test_fail("zero-copy data mismatch");
+	}
+
+	return PX4_OK;
+}
+
+int uORBTest::UnitTest::test_seqlock()
+{
+	test_note("Testing seqlock topic");
+
+	if (!((ORB_ID(orb_test_seqlock))->o_flags & ORB_FLAG_SEQLOCK)) {
+		return test_fail("ORB_FLAG_SEQLOCK not set");
+	}
+
+	uORB::Subscription sub{ORB_ID(orb_test_seqlock)};
+	uORB::Publication<orb_test_seqlock_s> pub{ORB_ID(orb_test_seqlock)};
+
+	orb_test_seqlock_s t{};
+	orb_test_seqlock_s u{};
+
+	for (int i = 0; i < 5; i++) {
+		t.val = i;
+		memset(t.junk, i, sizeof(t.junk));
+		pub.publish(t);
+
+		if (!sub.updated()) {
+			return test_fail("update flag not set, element %i", i);
+		}
+
+		if (!sub.update(&u) || (u.val != i) || (u.junk[sizeof(u.junk) - 1] != i)) {
+			return test_fail("copy mismatch: %d expected %d", u.val, i);
+		}
+
+		if (sub.updated()) {
+			return test_fail("spurious updated flag, element %i", i);
+		}
+	}
+
+	// several publications without reading: only the latest is returned
+	for (int i = 5; i < 10; i++) {
+		t.val = i;
+		pub.publish(t);
+	}
+
+	if (!sub.update(&u) || (u.val != 9)) {
+		return test_fail("copy mismatch: %d expected %d", u.val, 9);
+	}
+
+	return test_note("PASS seqlock topic");
+}
+
+int uORBTest::UnitTest::seqlock_benchmark()
+{
+	test_note("---------------- SEQLOCK BENCHMARK ------------------");
+
+	int ret = seqlock_benchmark_run(ORB_ID(orb_test_large));
+
+	if (ret == PX4_OK) {
+		ret = seqlock_benchmark_run(ORB_ID(orb_test_seqlock));
+	}
+
+	return ret;
+}
+
+int uORBTest::UnitTest::seqlock_benchmark_run(const orb_metadata *meta)
+{
+	static_assert(sizeof(orb_test_large_s) == sizeof(orb_test_seqlock_s), "orb_test_large and orb_test_seqlock differ");
+	static constexpr int RUNS = 100000;
+
+	orb_test_seqlock_s t{};
+	orb_advert_t ptopic = orb_advertise(meta, &t);
+
+	if (ptopic == nullptr) {
+		return test_fail("advertise failed: %d", errno);
+	}
+
+	_seqlock_meta = meta;
+	_thread_should_exit = false;
+
+	for (int i = 0; i < SEQLOCK_READERS; i++) {
+		_seqlock_reader_stats[i] = {};
+
+		char index[4];
+		snprintf(index, sizeof(index), "%d", i);
+		char *const args[2] = { index, nullptr };
+
+		if (px4_task_spawn_cmd("uorb_seqlock_reader",
+				       SCHED_DEFAULT,
+				       SCHED_PRIORITY_MAX - 5,
+				       2000,
+				       (px4_main_t)&uORBTest::UnitTest::seqlock_reader_entry,
+				       args) < 0) {
+			_thread_should_exit = true;
+			return test_fail("failed launching task");
+		}
+	}
+
+	// let the readers start
+	px4_usleep(100 * 1000);
+
+	uint64_t publish_time_total = 0;
+	hrt_abstime publish_time_max = 0;
+
+	for (int i = 1; i <= RUNS; i++) {
+		t.val = i;
+		memset(t.junk, i, sizeof(t.junk));
+
+		const hrt_abstime publish_start = hrt_absolute_time();
+		orb_publish(meta, ptopic, &t);
+		const hrt_abstime publish_time = hrt_elapsed_time(&publish_start);
+
+		publish_time_total += publish_time;
+		publish_time_max = math::max(publish_time_max, publish_time);
+	}
+
+	_thread_should_exit = true;
+
+	for (int i = 0; i < SEQLOCK_READERS; i++) {
+		while (!_seqlock_reader_stats[i].done) {
+			px4_usleep(10 * 1000);
+		}
+	}
+
+	orb_unadvertise(ptopic);
+
+	PX4_INFO("%s (%s), %d readers", meta->o_name, (meta->o_flags & ORB_FLAG_SEQLOCK) ? "seqlock" : "locked",
+		 SEQLOCK_READERS);
+	PX4_INFO("  publish: mean %8.4f us, max %4" PRIu64 " us", static_cast<double>((float)publish_time_total / RUNS),
+		 publish_time_max);
+
+	unsigned inconsistent = 0;
+
+	for (int i = 0; i < SEQLOCK_READERS; i++) {
+		const SeqlockReaderStats &stats = _seqlock_reader_stats[i];
+		const float copy_time_mean = (stats.copies > 0) ? (float)stats.copy_time_total / stats.copies : 0.f;
+
+		PX4_INFO("  copy %d: mean %8.4f us, max %4" PRIu64 " us, %u copies", i, static_cast<double>(copy_time_mean),
+			 stats.copy_time_max, stats.copies);
+		inconsistent += stats.inconsistent;
+	}
+
+	if (inconsistent > 0) {
+		return test_fail("%s: %u inconsistent copies", meta->o_name, inconsistent);
+	}
+
+	return PX4_OK;
+}
+
+int uORBTest::UnitTest::seqlock_reader_entry(int argc, char *argv[])
+{
+	if (argc < 2) {
+		return -1;
+	}
+
+	uORBTest::UnitTest &t = uORBTest::UnitTest::instance();
+	return t.seqlock_reader_main(atoi(argv[1]));
+}
+
+int uORBTest::UnitTest::seqlock_reader_main(int index)
+{
+	SeqlockReaderStats &stats = _seqlock_reader_stats[index];
+	uORB::Subscription sub{_seqlock_meta};
+	orb_test_seqlock_s u{};
+
+	while (!_thread_should_exit) {
+		const hrt_abstime copy_start = hrt_absolute_time();
+
+		if (sub.update(&u)) {
+			const hrt_abstime copy_time = hrt_elapsed_time(&copy_start);
+			stats.copy_time_total += copy_time;
+			stats.copy_time_max = math::max(stats.copy_time_max, copy_time);
+			stats.copies++;
+
+			// every message is filled with its own value, a torn copy mixes two of them
+			for (size_t i = 0; i < sizeof(u.junk); i++) {
+				if (u.junk[i] != (uint8_t)u.val) {
+					stats.inconsistent++;
+					break;
+				}
+			}
+		}
+	}
+
+	stats.done = true;
+
+	return 0;
+}
+
 int uORBTest::UnitTest::test_fail(const char *fmt, ...)
 {
 	va_list ap;
@@ -41,6 +41,7 @@
 #include <uORB/topics/orb_test.h>
 #include <uORB/topics/orb_test_medium.h>
 #include <uORB/topics/orb_test_large.h>
+#include <uORB/topics/orb_test_seqlock.h>
 
 #include <px4_platform_common/defines.h>
 #include <px4_platform_common/posix.h>
@@ -67,6 +68,8 @@ public:
 
 	int test();
 	int latency_test(bool print);
+	int zero_copy_benchmark();
+	int seqlock_benchmark();
 	int info();
 
 	// Disallow copy
@@ -115,6 +118,28 @@ private:
 	int test_queue_poll_notify();
 	volatile int _num_messages_sent = 0;
 
+	/* zero-copy loan/borrow tests */
+	int test_loan();
+	int test_loan_queue();
+
+	/* seqlock tests */
+	int test_seqlock();
+	int seqlock_benchmark_run(const orb_metadata *meta);
+	static int seqlock_reader_entry(int argc, char *argv[]);
+	int seqlock_reader_main(int index);
+
+	struct SeqlockReaderStats {
+		uint64_t copy_time_total{0};
+		hrt_abstime copy_time_max{0};
+		unsigned copies{0};
+		unsigned inconsistent{0};
+		volatile bool done{false};
+	};
+
+	static constexpr int SEQLOCK_READERS = 3;
+	SeqlockReaderStats _seqlock_reader_stats[SEQLOCK_READERS] {};
+	const orb_metadata *_seqlock_meta{nullptr};
+
 	int test_fail(const char *fmt, ...);
 	int test_note(const char *fmt, ...);
 };
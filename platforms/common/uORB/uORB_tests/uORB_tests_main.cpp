@@ -39,7 +39,7 @@ extern "C" { __EXPORT int uorb_tests_main(int argc, char *argv[]); }
 
 static void usage()
 {
-	PX4_INFO("Usage: uorb_tests [latency_test]");
+	PX4_INFO("Usage: uorb_tests [latency_test|zero_copy_benchmark|seqlock_benchmark]");
 }
 
 int
@@ -70,6 +70,22 @@ uorb_tests_main(int argc, char *argv[])
 		return t.latency_test(true);
 	}
 
+	/*
+	 * Compare the zero-copy loan/borrow path against publish/copy.
+	 */
+	if (argc > 1 && !strcmp(argv[1], "zero_copy_benchmark")) {
+		uORBTest::UnitTest &t = uORBTest::UnitTest::instance();
+		return t.zero_copy_benchmark();
+	}
+
+	/*
+	 * Compare publish/copy latency of a locked and a seqlock topic under contention.
+	 */
+	if (argc > 1 && !strcmp(argv[1], "seqlock_benchmark")) {
+		uORBTest::UnitTest &t = uORBTest::UnitTest::instance();
+		return t.seqlock_benchmark();
+	}
+
 	usage();
 	return -EINVAL;
 }
@@ -0,0 +1,92 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2025 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file thread_affinity.h
+ *
+ * CPU affinity and SCHED_FIFO priority configuration for threads (tasks and work queues),
+ * and per thread scheduling statistics.
+ *
+ * The configuration is read once from the file set in the PX4_CPU_AFFINITY_FILE environment
+ * variable, or etc/cpu_affinity.conf in the working directory. Each line is
+ *
+ *   <thread name> <cpus> [<SCHED_FIFO priority>]
+ *
+ * where the name may end with '*' to match a prefix, cpus is a list like "2" or "0-1,4"
+ * (or "-" to keep the affinity) and the priority (1-99) replaces the default one.
+ * The first matching line applies, '#' starts a comment.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <sys/types.h>
+
+struct px4_thread_stats_s {
+	char cpus_allowed[32];			///< affinity as cpu list, eg "0-3"
+	int last_cpu;				///< cpu the thread last ran on
+	int priority;				///< scheduling priority (kernel view)
+	uint64_t run_time_ticks;		///< user + system time in clock ticks
+	uint64_t voluntary_ctxt_switches;
+	uint64_t nonvoluntary_ctxt_switches;
+};
+
+__BEGIN_DECLS
+
+/**
+ * Apply the configured affinity and priority to the calling thread.
+ * @param name thread name to match against the configuration
+ * @return the configured SCHED_FIFO priority, 0 if none is configured
+ */
+__EXPORT int px4_thread_affinity_apply(const char *name);
+
+/**
+ * Get the configured SCHED_FIFO priority of a thread name without applying anything.
+ * @param name thread name to match against the configuration
+ * @return the configured SCHED_FIFO priority, 0 if none is configured
+ */
+__EXPORT int px4_thread_affinity_priority(const char *name);
+
+/**
+ * Kernel thread id of the calling thread.
+ */
+__EXPORT pid_t px4_thread_gettid(void);
+
+/**
+ * Get the scheduling statistics of a thread of this process.
+ * @param tid kernel thread id (see px4_thread_gettid())
+ * @return 0 on success, -1 otherwise (or if not supported)
+ */
+__EXPORT int px4_thread_stats(pid_t tid, struct px4_thread_stats_s *stats);
+
+__END_DECLS
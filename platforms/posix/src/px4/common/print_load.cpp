@@ -54,6 +54,13 @@
 #include <mach/mach.h>
 #endif
 
+#ifdef __PX4_LINUX
+#include <dirent.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <px4_platform/thread_affinity.h>
+#endif
+
 #ifdef __PX4_QURT
 // dprintf is not available on QURT. Use the usual output to mini-dm.
 #define dprintf(_fd, _text, ...) ((_fd) == 1 ? PX4_INFO((_text), ##__VA_ARGS__) : (void)(_fd))
@@ -92,8 +99,76 @@ void print_load(int fd, struct print_load_s *print_state)
 		memset(clear_line, 0, sizeof(clear_line));
 	}
 
-#if defined(__PX4_LINUX) || defined(__PX4_CYGWIN) || defined(__PX4_QURT)
-	dprintf(fd, "%sTOP NOT IMPLEMENTED ON LINUX, QURT, WINDOWS (ONLY ON NUTTX, APPLE)\n", clear_line);
+#if defined(__PX4_LINUX)
+	const hrt_abstime now = hrt_absolute_time();
+	print_state->interval_time_us = now - print_state->new_time;
+	print_state->new_time = now;
+
+	const float ticks_per_us = sysconf(_SC_CLK_TCK) / 1e6f;
+
+	DIR *task_dir = opendir("/proc/self/task");
+
+	if (task_dir == nullptr) {
+		return;
+	}
+
+	dprintf(fd, "%s%-6s %-16s %5s %3s %-12s %4s %12s %12s\n", clear_line,
+		"TID", "COMMAND", "CPU(%)", "CPU", "AFFINITY", "PRIO", "CTX VOL", "CTX INVOL");
+
+	// previous run times, stored as (tid << 40 | ticks) to match threads across calls
+	uint64_t last_times[CONFIG_FS_PROCFS_MAX_TASKS] {};
+	int num_threads = 0;
+	struct dirent *entry;
+
+	while ((entry = readdir(task_dir)) != nullptr && num_threads < CONFIG_FS_PROCFS_MAX_TASKS) {
+		const pid_t tid = atoi(entry->d_name);
+		px4_thread_stats_s stats;
+
+		if (tid <= 0 || px4_thread_stats(tid, &stats) != 0) {
+			continue;
+		}
+
+		char name[24] {};
+		char path[64];
+		snprintf(path, sizeof(path), "/proc/self/task/%d/comm", (int)tid);
+		FILE *comm = fopen(path, "r");
+
+		if (comm != nullptr) {
+			if (fgets(name, sizeof(name), comm) != nullptr) {
+				name[strcspn(name, "\n")] = '\0';
+			}
+
+			fclose(comm);
+		}
+
+		const uint64_t ticks = stats.run_time_ticks & 0xFFFFFFFFFFull;
+		uint64_t ticks_prev = ticks;
+
+		for (uint64_t last : print_state->last_times) {
+			if ((last >> 40) == (uint64_t)tid) {
+				ticks_prev = last & 0xFFFFFFFFFFull;
+				break;
+			}
+		}
+
+		last_times[num_threads++] = ((uint64_t)tid << 40) | ticks;
+
+		const float load = (print_state->interval_time_us > 0.f) ?
+				   100.f * (ticks - ticks_prev) / (print_state->interval_time_us * ticks_per_us) : 0.f;
+
+		dprintf(fd, "%s%-6d %-16s %5.1f %3d %-12s %4d %12" PRIu64 " %12" PRIu64 "\n", clear_line,
+			(int)tid, name, (double)load, stats.last_cpu, stats.cpus_allowed, stats.priority,
+			stats.voluntary_ctxt_switches, stats.nonvoluntary_ctxt_switches);
+	}
+
+	closedir(task_dir);
+
+	memcpy(print_state->last_times, last_times, sizeof(last_times));
+
+	dprintf(fd, "%sThreads: %d total\n", clear_line, num_threads);
+
+#elif defined(__PX4_CYGWIN) || defined(__PX4_QURT)
+	dprintf(fd, "%sTOP NOT IMPLEMENTED ON QURT, WINDOWS (ONLY ON NUTTX, LINUX, APPLE)\n", clear_line);
 
 #elif defined(__PX4_DARWIN)
 	pid_t pid = getpid();   //-- this is the process id you need info for
@@ -57,6 +57,7 @@
 
 #include <px4_platform_common/tasks.h>
 #include <px4_platform_common/posix.h>
+#include <px4_platform/thread_affinity.h>
 #include <systemlib/err.h>
 
 #define PX4_MAX_TASKS 50
@@ -95,6 +96,9 @@ static void *entry_adapter(void *ptr)
 		PX4_ERR("px4_task_spawn_cmd: failed to set name of thread %d %d\n", rv, errno);
 	}
 
+	// pin to the configured CPUs (and priority) if any
+	px4_thread_affinity_apply(data->name);
+
 	data->entry(data->argc, data->argv);
 	free(ptr);
 	PX4_DEBUG("Before px4_task_exit");
@@ -0,0 +1,307 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2025 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file thread_affinity.cpp
+ *
+ * CPU affinity and priority configuration for threads, see px4_platform/thread_affinity.h.
+ */
+
+#include <px4_platform/thread_affinity.h>
+
+#include <px4_platform_common/log.h>
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#if defined(__PX4_LINUX)
+#include <sys/syscall.h>
+
+static constexpr int MAX_AFFINITY_RULES = 32;
+
+struct affinity_rule_s {
+	char pattern[24];
+	cpu_set_t cpus;
+	bool set_cpus;
+	int priority;
+};
+
+static affinity_rule_s affinity_rules[MAX_AFFINITY_RULES];
+static int affinity_rules_count = 0;
+static pthread_once_t affinity_rules_once = PTHREAD_ONCE_INIT;
+
+static bool parse_cpu_list(const char *list, cpu_set_t *cpus)
+{
+	CPU_ZERO(cpus);
+
+	while (*list != '\0') {
+		char *end;
+		const long first = strtol(list, &end, 10);
+		long last = first;
+
+		if (end == list || first < 0) {
+			return false;
+		}
+
+		if (*end == '-') {
+			list = end + 1;
+			last = strtol(list, &end, 10);
+
+			if (end == list || last < first) {
+				return false;
+			}
+		}
+
+		for (long cpu = first; cpu <= last && cpu < CPU_SETSIZE; cpu++) {
+			CPU_SET(cpu, cpus);
+		}
+
+		if (*end == ',') {
+			end++;
+
+		} else if (*end != '\0') {
+			return false;
+		}
+
+		list = end;
+	}
+
+	return CPU_COUNT(cpus) > 0;
+}
+
+static void load_affinity_rules()
+{
+	const char *path = getenv("PX4_CPU_AFFINITY_FILE");
+
+	if (path == nullptr) {
+		path = "etc/cpu_affinity.conf";
+	}
+
+	FILE *file = fopen(path, "r");
+
+	if (file == nullptr) {
+		return;
+	}
+
+	char line[128];
+	int line_number = 0;
+
+	while (fgets(line, sizeof(line), file) != nullptr && affinity_rules_count < MAX_AFFINITY_RULES) {
+		line_number++;
+
+		char *comment = strchr(line, '#');
+
+		if (comment != nullptr) {
+			*comment = '\0';
+		}
+
+		char cpus[64];
+		affinity_rule_s &rule = affinity_rules[affinity_rules_count];
+		rule.priority = 0;
+
+		const int fields = sscanf(line, "%23s %63s %d", rule.pattern, cpus, &rule.priority);
+
+		if (fields <= 0) {
+			continue; // empty line
+		}
+
+		rule.set_cpus = (fields >= 2) && (strcmp(cpus, "-") != 0);
+
+		if ((fields < 2) || (rule.set_cpus && !parse_cpu_list(cpus, &rule.cpus))
+		    || (rule.priority < 0) || (rule.priority > sched_get_priority_max(SCHED_FIFO))) {
+
+			PX4_ERR("%s:%d: invalid line", path, line_number);
+			continue;
+		}
+
+		affinity_rules_count++;
+	}
+
+	fclose(file);
+
+	PX4_INFO("CPU affinity: %d rules loaded from %s", affinity_rules_count, path);
+}
+
+static bool match(const char *pattern, const char *name)
+{
+	const size_t len = strlen(pattern);
+
+	if (len > 0 && pattern[len - 1] == '*') {
+		return strncmp(pattern, name, len - 1) == 0;
+	}
+
+	return strcmp(pattern, name) == 0;
+}
+
+static const affinity_rule_s *find_rule(const char *name)
+{
+	pthread_once(&affinity_rules_once, load_affinity_rules);
+
+	for (int i = 0; i < affinity_rules_count; i++) {
+		if (match(affinity_rules[i].pattern, name)) {
+			return &affinity_rules[i];
+		}
+	}
+
+	return nullptr;
+}
+
+int px4_thread_affinity_apply(const char *name)
+{
+	const affinity_rule_s *rule = find_rule(name);
+
+	if (rule == nullptr) {
+		return 0;
+	}
+
+	if (rule->set_cpus) {
+		int ret = pthread_setaffinity_np(pthread_self(), sizeof(rule->cpus), &rule->cpus);
+
+		if (ret != 0) {
+			PX4_WARN("%s: setting CPU affinity failed (%s)", name, strerror(ret));
+		}
+	}
+
+	if (rule->priority > 0) {
+		sched_param param{};
+		param.sched_priority = rule->priority;
+		int ret = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+
+		if (ret != 0) {
+			PX4_WARN("%s: setting SCHED_FIFO priority %d failed (%s)", name, rule->priority, strerror(ret));
+		}
+	}
+
+	return rule->priority;
+}
+
+int px4_thread_affinity_priority(const char *name)
+{
+	const affinity_rule_s *rule = find_rule(name);
+	return (rule != nullptr) ? rule->priority : 0;
+}
+
+pid_t px4_thread_gettid()
+{
+	return (pid_t)syscall(SYS_gettid);
+}
+
+int px4_thread_stats(pid_t tid, px4_thread_stats_s *stats)
+{
+	char path[64];
+	char line[256];
+
+	memset(stats, 0, sizeof(*stats));
+
+	// stat: "tid (comm) state ppid ...", the fields counted after the comm
+	snprintf(path, sizeof(path), "/proc/self/task/%d/stat", (int)tid);
+	FILE *file = fopen(path, "r");
+
+	if (file == nullptr) {
+		return -1;
+	}
+
+	const bool stat_read = (fgets(line, sizeof(line), file) != nullptr);
+	fclose(file);
+
+	const char *fields = stat_read ? strrchr(line, ')') : nullptr;
+
+	if (fields == nullptr) {
+		return -1;
+	}
+
+	unsigned long long utime = 0;
+	unsigned long long stime = 0;
+
+	// state(3) ... utime(14) stime(15) cutime cstime priority(18) ... processor(39)
+	if (sscanf(fields + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %llu %llu %*d %*d %d %*d %*d %*d %*u %*u %*d "
+		   "%*u %*u %*u %*u %*u %*u %*u %*u %*u %*u %*u %*u %*u %*d %d",
+		   &utime, &stime, &stats->priority, &stats->last_cpu) != 4) {
+		return -1;
+	}
+
+	stats->run_time_ticks = utime + stime;
+
+	snprintf(path, sizeof(path), "/proc/self/task/%d/status", (int)tid);
+	file = fopen(path, "r");
+
+	if (file == nullptr) {
+		return -1;
+	}
+
+	while (fgets(line, sizeof(line), file) != nullptr) {
+		unsigned long long value;
+
+		if (sscanf(line, "Cpus_allowed_list: %31s", stats->cpus_allowed) == 1) {
+			continue;
+
+		} else if (sscanf(line, "voluntary_ctxt_switches: %llu", &value) == 1) {
+			stats->voluntary_ctxt_switches = value;
+
+		} else if (sscanf(line, "nonvoluntary_ctxt_switches: %llu", &value) == 1) {
+			stats->nonvoluntary_ctxt_switches = value;
+		}
+	}
+
+	fclose(file);
+
+	return 0;
+}
+
+#else
+
+int px4_thread_affinity_apply(const char *name)
+{
+	return 0;
+}
+
+int px4_thread_affinity_priority(const char *name)
+{
+	return 0;
+}
+
+pid_t px4_thread_gettid()
+{
+	return 0;
+}
+
+int px4_thread_stats(pid_t tid, px4_thread_stats_s *stats)
+{
+	return -1;
+}
+
+#endif // __PX4_LINUX
@@ -0,0 +1,249 @@
+/****************************************************************************
+ *
+ *   Copyright (C) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/*
+ * @file BiquadBank3.hpp
+ *
+ * @brief Biquad filters of the 3 axes of a sensor applied together.
+ *
+ * The samples of the 3 axes are interleaved, so that on targets with SIMD (NEON, SSE) every filter stage
+ * processes all the axes with one instruction. Without SIMD (e.g. Cortex-M7) the axes are filtered one after the
+ * other with the coefficients and state in local variables, like the CMSIS-DSP biquad cascade
+ * (arm_biquad_cascade_df1_f32) does for every stage.
+ *
+ * The filters are applied stage by stage over the whole array, and not all the stages sample by sample: a
+ * sample-major cascade has to load and store the state of every stage for every sample, and was not faster on
+ * any of the measured array sizes (1 to 32 samples, 2 to 29 stages).
+ *
+ * The coefficients and state remain in the NotchFilter and LowPassFilter2p instances of each axis, and every
+ * axis goes through the same operations in the same order as with applyArray(), so the results are the same as
+ * filtering each axis on its own.
+ */
+
+#pragma once
+
+#include "LowPassFilter2p.hpp"
+#include "NotchFilter.hpp"
+
+namespace math
+{
+
+class BiquadBank3
+{
+public:
+
+#if defined(__ARM_NEON) || defined(__SSE__)
+	// x, y, z and an unused lane to fill a 128 bit register
+	typedef float Sample __attribute__((vector_size(sizeof(float) * 4)));
+#else
+	struct Sample {
+		float v[3];
+
+		float &operator[](int i) { return v[i]; }
+		float operator[](int i) const { return v[i]; }
+	};
+#endif
+
+	/**
+	 * Filter array of samples in place with the notch filters of the 3 axes (Direct Form I).
+	 * Axes with a disabled notch filter (notch frequency 0) are not filtered.
+	 */
+	static void applyNotch(NotchFilter<float> &filter_x, NotchFilter<float> &filter_y, NotchFilter<float> &filter_z,
+			       Sample samples[], int num_samples)
+	{
+		NotchFilter<float> *filters[3] {&filter_x, &filter_y, &filter_z};
+
+		bool active = false;
+
+		for (int axis = 0; axis < 3; axis++) {
+			if (filters[axis]->getNotchFreq() > 0.f) {
+				if (!filters[axis]->initialized()) {
+					// same as NotchFilter::applyArray()
+					filters[axis]->reset(samples[0][axis]);
+				}
+
+				active = true;
+
+			} else {
+				filters[axis] = nullptr;
+			}
+		}
+
+		if (!active) {
+			return;
+		}
+
+#if defined(__ARM_NEON) || defined(__SSE__)
+		// disabled axes go through a pass through filter (b0 = 1, zero state) which is not written back
+		const NotchFilter<float> pass_through{};
+		const NotchFilter<float> &fx = filters[0] ? *filters[0] : pass_through;
+		const NotchFilter<float> &fy = filters[1] ? *filters[1] : pass_through;
+		const NotchFilter<float> &fz = filters[2] ? *filters[2] : pass_through;
+
+		const Sample b0{fx._b0, fy._b0, fz._b0};
+		const Sample b1{fx._b1, fy._b1, fz._b1};
+		const Sample b2{fx._b2, fy._b2, fz._b2};
+		const Sample a1{fx._a1, fy._a1, fz._a1};
+		const Sample a2{fx._a2, fy._a2, fz._a2};
+
+		Sample x1{fx._delay_element_1, fy._delay_element_1, fz._delay_element_1};
+		Sample x2{fx._delay_element_2, fy._delay_element_2, fz._delay_element_2};
+		Sample y1{fx._delay_element_output_1, fy._delay_element_output_1, fz._delay_element_output_1};
+		Sample y2{fx._delay_element_output_2, fy._delay_element_output_2, fz._delay_element_output_2};
+
+		for (int n = 0; n < num_samples; n++) {
+			const Sample input = samples[n];
+			const Sample output = b0 * input + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2;
+
+			x2 = x1;
+			x1 = input;
+
+			y2 = y1;
+			y1 = output;
+
+			samples[n] = output;
+		}
+
+		for (int axis = 0; axis < 3; axis++) {
+			if (filters[axis]) {
+				filters[axis]->_delay_element_1 = x1[axis];
+				filters[axis]->_delay_element_2 = x2[axis];
+				filters[axis]->_delay_element_output_1 = y1[axis];
+				filters[axis]->_delay_element_output_2 = y2[axis];
+			}
+		}
+
+#else
+
+		for (int axis = 0; axis < 3; axis++) {
+			if (filters[axis]) {
+				NotchFilter<float> &f = *filters[axis];
+
+				const float b0 = f._b0;
+				const float b1 = f._b1;
+				const float b2 = f._b2;
+				const float a1 = f._a1;
+				const float a2 = f._a2;
+
+				float x1 = f._delay_element_1;
+				float x2 = f._delay_element_2;
+				float y1 = f._delay_element_output_1;
+				float y2 = f._delay_element_output_2;
+
+				for (int n = 0; n < num_samples; n++) {
+					const float input = samples[n][axis];
+					const float output = b0 * input + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2;
+
+					x2 = x1;
+					x1 = input;
+
+					y2 = y1;
+					y1 = output;
+
+					samples[n][axis] = output;
+				}
+
+				f._delay_element_1 = x1;
+				f._delay_element_2 = x2;
+				f._delay_element_output_1 = y1;
+				f._delay_element_output_2 = y2;
+			}
+		}
+
+#endif
+	}
+
+	// Filter array of samples in place with the low-pass filters of the 3 axes (Direct Form II).
+	static void applyLowPass(LowPassFilter2p<float> filters[3], Sample samples[], int num_samples)
+	{
+#if defined(__ARM_NEON) || defined(__SSE__)
+		const LowPassFilter2p<float> &fx = filters[0];
+		const LowPassFilter2p<float> &fy = filters[1];
+		const LowPassFilter2p<float> &fz = filters[2];
+
+		const Sample b0{fx._b0, fy._b0, fz._b0};
+		const Sample b1{fx._b1, fy._b1, fz._b1};
+		const Sample b2{fx._b2, fy._b2, fz._b2};
+		const Sample a1{fx._a1, fy._a1, fz._a1};
+		const Sample a2{fx._a2, fy._a2, fz._a2};
+
+		Sample w1{fx._delay_element_1, fy._delay_element_1, fz._delay_element_1};
+		Sample w2{fx._delay_element_2, fy._delay_element_2, fz._delay_element_2};
+
+		for (int n = 0; n < num_samples; n++) {
+			const Sample w0 = samples[n] - w1 * a1 - w2 * a2;
+
+			samples[n] = w0 * b0 + w1 * b1 + w2 * b2;
+
+			w2 = w1;
+			w1 = w0;
+		}
+
+		for (int axis = 0; axis < 3; axis++) {
+			filters[axis]._delay_element_1 = w1[axis];
+			filters[axis]._delay_element_2 = w2[axis];
+		}
+
+#else
+
+		for (int axis = 0; axis < 3; axis++) {
+			LowPassFilter2p<float> &f = filters[axis];
+
+			const float b0 = f._b0;
+			const float b1 = f._b1;
+			const float b2 = f._b2;
+			const float a1 = f._a1;
+			const float a2 = f._a2;
+
+			float w1 = f._delay_element_1;
+			float w2 = f._delay_element_2;
+
+			for (int n = 0; n < num_samples; n++) {
+				const float w0 = samples[n][axis] - w1 * a1 - w2 * a2;
+
+				samples[n][axis] = w0 * b0 + w1 * b1 + w2 * b2;
+
+				w2 = w1;
+				w1 = w0;
+			}
+
+			f._delay_element_1 = w1;
+			f._delay_element_2 = w2;
+		}
+
+#endif
+	}
+};
+
+} // namespace math
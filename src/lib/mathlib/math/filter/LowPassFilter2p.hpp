@@ -45,6 +45,8 @@
 namespace math
 {
 
+class BiquadBank3;
+
 template<typename T>
 class LowPassFilter2p
 {
@@ -161,6 +163,9 @@ public:
 	}
 
 protected:
+	// runs the filters of the 3 axes in one kernel on the coefficients and state below
+	friend class BiquadBank3;
+
 	T _delay_element_1{}; // buffered sample -1
 	T _delay_element_2{}; // buffered sample -2
 
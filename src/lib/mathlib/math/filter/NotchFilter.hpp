@@ -50,6 +50,8 @@
 namespace math
 {
 
+class BiquadBank3;
+
 template<typename T>
 class NotchFilter
 {
@@ -164,6 +166,8 @@ public:
 	}
 
 protected:
+	// runs the filters of the 3 axes in one kernel on the coefficients and state below
+	friend class BiquadBank3;
 
 	/**
 	 * Add a new raw value to the filter using the Direct Form I
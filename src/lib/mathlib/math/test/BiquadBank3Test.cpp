@@ -0,0 +1,151 @@
+/****************************************************************************
+ *
+ *   Copyright (C) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * Test code for the 3 axes biquad filter bank
+ * Run this test only using make tests TESTFILTER=BiquadBank3
+ */
+
+#include <gtest/gtest.h>
+
+#include <lib/mathlib/math/filter/BiquadBank3.hpp>
+
+using namespace math;
+
+class BiquadBank3Test : public ::testing::Test
+{
+public:
+	static constexpr int NUM_SAMPLES = 32;
+	static constexpr int NUM_BLOCKS = 50;
+
+	const float _sample_freq = 8000.f;
+
+	// sum of sines and an offset, different for every axis
+	float signal(int axis, int n) const
+	{
+		const float t = n / _sample_freq;
+		return 0.1f * axis + sinf(2.f * M_PI_F * (30.f + 10.f * axis) * t) + 0.5f * sinf(2.f * M_PI_F * 400.f * t)
+		       + 0.2f * sinf(2.f * M_PI_F * (900.f + 50.f * axis) * t);
+	}
+
+	// 2 notch filter stages and a low-pass filter, filtered per axis (reference) and with the filter bank
+	NotchFilter<float> _notch_reference[2][3];
+	NotchFilter<float> _notch_bank[2][3];
+	LowPassFilter2p<float> _lp_reference[3];
+	LowPassFilter2p<float> _lp_bank[3];
+
+	void filterAndCompare(int num_samples)
+	{
+		for (int block = 0; block < NUM_BLOCKS; block++) {
+			float reference[3][NUM_SAMPLES];
+			BiquadBank3::Sample samples[NUM_SAMPLES];
+
+			for (int n = 0; n < num_samples; n++) {
+				const int i = block * num_samples + n;
+				samples[n] = BiquadBank3::Sample{signal(0, i), signal(1, i), signal(2, i)};
+
+				for (int axis = 0; axis < 3; axis++) {
+					reference[axis][n] = signal(axis, i);
+				}
+			}
+
+			for (int axis = 0; axis < 3; axis++) {
+				for (int stage = 0; stage < 2; stage++) {
+					if (_notch_reference[stage][axis].getNotchFreq() > 0.f) {
+						_notch_reference[stage][axis].applyArray(reference[axis], num_samples);
+					}
+				}
+
+				_lp_reference[axis].applyArray(reference[axis], num_samples);
+			}
+
+			for (int stage = 0; stage < 2; stage++) {
+				BiquadBank3::applyNotch(_notch_bank[stage][0], _notch_bank[stage][1], _notch_bank[stage][2], samples, num_samples);
+			}
+
+			BiquadBank3::applyLowPass(_lp_bank, samples, num_samples);
+
+			for (int n = 0; n < num_samples; n++) {
+				for (int axis = 0; axis < 3; axis++) {
+					EXPECT_NEAR(samples[n][axis], reference[axis][n], 1e-5f) << "block " << block << " sample " << n << " axis " << axis;
+				}
+			}
+		}
+	}
+};
+
+TEST_F(BiquadBank3Test, sameAsSingleAxis)
+{
+	for (int axis = 0; axis < 3; axis++) {
+		_notch_reference[0][axis].setParameters(_sample_freq, 400.f, 30.f);
+		_notch_reference[1][axis].setParameters(_sample_freq, 900.f + 50.f * axis, 20.f);
+		_lp_reference[axis].set_cutoff_frequency(_sample_freq, 100.f);
+	}
+
+	// copy the filters, so that both have the same coefficients
+	memcpy(_notch_bank, _notch_reference, sizeof(_notch_bank));
+	memcpy(_lp_bank, _lp_reference, sizeof(_lp_bank));
+
+	filterAndCompare(NUM_SAMPLES);
+	filterAndCompare(1);
+	filterAndCompare(7);
+}
+
+TEST_F(BiquadBank3Test, disabledAxes)
+{
+	// notch filters only active on some axes, low-pass filter disabled on y
+	_notch_reference[0][0].setParameters(_sample_freq, 400.f, 30.f);
+	_notch_reference[1][2].setParameters(_sample_freq, 1000.f, 20.f);
+	_lp_reference[0].set_cutoff_frequency(_sample_freq, 100.f);
+	_lp_reference[2].set_cutoff_frequency(_sample_freq, 200.f);
+
+	memcpy(_notch_bank, _notch_reference, sizeof(_notch_bank));
+	memcpy(_lp_bank, _lp_reference, sizeof(_lp_bank));
+
+	filterAndCompare(NUM_SAMPLES);
+
+	// notch frequency change forcing a reset of the filter state on the next array of samples
+	for (int axis = 0; axis < 3; axis++) {
+		_notch_reference[1][axis].setParameters(_sample_freq, 600.f, 20.f);
+		_notch_bank[1][axis].setParameters(_sample_freq, 600.f, 20.f);
+	}
+
+	filterAndCompare(NUM_SAMPLES);
+
+	// disabled notch filter
+	_notch_reference[0][0].disable();
+	_notch_bank[0][0].disable();
+
+	filterAndCompare(NUM_SAMPLES);
+}
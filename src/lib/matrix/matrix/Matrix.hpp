@@ -18,11 +18,63 @@
 namespace matrix
 {
 
+namespace detail
+{
+
+// Matrix product kernels, specialized at compile time for the common small shapes.
+// Every element is summed in the same order (j = 0..N-1) by all kernels.
+template<typename Type, size_t M, size_t N, size_t P>
+struct MatrixMultiply {
+	static void apply(const Type a[M][N], const Type b[N][P], Type res[M][P])
+	{
+		// row i of res is accumulated from the rows of b, the inner loop runs over
+		// contiguous memory and can be vectorized
+		for (size_t i = 0; i < M; i++) {
+			for (size_t j = 0; j < N; j++) {
+				const Type a_ij = a[i][j];
+
+				for (size_t k = 0; k < P; k++) {
+					res[i][k] += a_ij * b[j][k];
+				}
+			}
+		}
+	}
+};
+
+template<typename Type, size_t P>
+struct MatrixMultiply<Type, 3, 3, P> {
+	static void apply(const Type a[3][3], const Type b[3][P], Type res[3][P])
+	{
+		for (size_t i = 0; i < 3; i++) {
+			for (size_t k = 0; k < P; k++) {
+				res[i][k] = a[i][0] * b[0][k] + a[i][1] * b[1][k] + a[i][2] * b[2][k];
+			}
+		}
+	}
+};
+
+template<typename Type, size_t P>
+struct MatrixMultiply<Type, 4, 4, P> {
+	static void apply(const Type a[4][4], const Type b[4][P], Type res[4][P])
+	{
+		for (size_t i = 0; i < 4; i++) {
+			for (size_t k = 0; k < P; k++) {
+				res[i][k] = a[i][0] * b[0][k] + a[i][1] * b[1][k] + a[i][2] * b[2][k] + a[i][3] * b[3][k];
+			}
+		}
+	}
+};
+
+} // namespace detail
+
 template<typename Type, size_t M, size_t N>
 class Matrix
 {
 	Type _data[M][N] {};
 
+	template<typename, size_t, size_t>
+	friend class Matrix;
+
 public:
 
 	// Constructors
@@ -158,23 +210,14 @@ public:
 	template<size_t P>
 	Matrix<Type, M, P> operator*(const Matrix<Type, N, P> &other) const
 	{
-		const Matrix<Type, M, N> &self = *this;
 		Matrix<Type, M, P> res{};
-
-		for (size_t i = 0; i < M; i++) {
-			for (size_t k = 0; k < P; k++) {
-				for (size_t j = 0; j < N; j++) {
-					res(i, k) += self(i, j) * other(j, k);
-				}
-			}
-		}
-
+		detail::MatrixMultiply<Type, M, N, P>::apply(_data, other._data, res._data);
 		return res;
 	}
 
 	// Using this function reduces the number of temporary variables needed to compute A * B.T
 	template<size_t P>
-	Matrix<Type, M, M> multiplyByTranspose(const Matrix<Type, P, N> &other) const
+	Matrix<Type, M, P> multiplyByTranspose(const Matrix<Type, P, N> &other) const
 	{
 		Matrix<Type, M, P> res;
 		const Matrix<Type, M, N> &self = *this;
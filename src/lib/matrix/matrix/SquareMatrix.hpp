@@ -315,6 +315,19 @@ public:
 			}
 		}
 	}
+
+	// symmetric rank one update: this += alpha * v * v.T
+	// v(i) * v(j) is commutative, a symmetric matrix stays exactly symmetric
+	void addOuterProduct(const Vector<Type, M> &v, Type alpha = Type(1))
+	{
+		SquareMatrix<Type, M> &self = *this;
+
+		for (size_t row_idx = 0; row_idx < M; row_idx++) {
+			for (size_t col_idx = 0; col_idx < M; col_idx++) {
+				self(row_idx, col_idx) += alpha * (v(row_idx) * v(col_idx));
+			}
+		}
+	}
 };
 
 using SquareMatrix2f = SquareMatrix<float, 2>;
@@ -341,6 +354,30 @@ SquareMatrix<Type, M> diag(Vector<Type, M> d)
 	return m;
 }
 
+// A * P * A.T for a symmetric P (e.g. covariance propagation)
+// the second product only computes the upper triangle, the result is exactly symmetric
+template<typename Type, size_t M, size_t N>
+SquareMatrix<Type, M> transformCovariance(const Matrix<Type, M, N> &A, const SquareMatrix<Type, N> &P)
+{
+	const Matrix<Type, M, N> AP = A * P;
+	SquareMatrix<Type, M> res;
+
+	for (size_t row_idx = 0; row_idx < M; row_idx++) {
+		for (size_t col_idx = row_idx; col_idx < M; col_idx++) {
+			Type sum{};
+
+			for (size_t j = 0; j < N; j++) {
+				sum += AP(row_idx, j) * A(col_idx, j);
+			}
+
+			res(row_idx, col_idx) = sum;
+		}
+	}
+
+	res.copyUpperToLowerTriangle();
+	return res;
+}
+
 template<typename Type, size_t M>
 SquareMatrix<Type, M> expm(const Matrix<Type, M, M> &A, size_t order = 5)
 {
@@ -0,0 +1,179 @@
+/****************************************************************************
+ *
+ *   Copyright (C) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * Timing of the specialized matrix kernels and the fused operations against the generic triple loop.
+ * Not part of the unit tests, the results are checked in MatrixKernelTest.
+ *
+ * Usage: matrix_kernel_benchmark [repeats]
+ *
+ * The best of the repeats is reported.
+ */
+
+#include <matrix/math.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+#include "MatrixKernelReference.hpp"
+
+using namespace matrix;
+using namespace matrix::reference;
+
+namespace
+{
+
+static constexpr int kIterations = 2000;
+
+int repeats = 10;
+
+volatile float sink;
+
+// runs f kIterations times, repeats times, and returns the best average time in ns
+template<typename F>
+double timeNs(F f)
+{
+	double best = 1e18;
+
+	for (int r = 0; r < repeats; r++) {
+		const auto start = std::chrono::steady_clock::now();
+
+		for (int i = 0; i < kIterations; i++) {
+			f(i);
+		}
+
+		const auto end = std::chrono::steady_clock::now();
+		best = std::min(best, std::chrono::duration<double, std::nano>(end - start).count() / kIterations);
+	}
+
+	return best;
+}
+
+void printTiming(const char *name, double generic_ns, double kernel_ns)
+{
+	printf("%-24s generic %9.1f ns  kernel %9.1f ns  (%.2fx)\n", name, generic_ns, kernel_ns, generic_ns / kernel_ns);
+}
+
+template<size_t M, size_t N, size_t P>
+void benchmarkMultiply(const char *name)
+{
+	Matrix<float, M, N> a;
+	Matrix<float, N, P> b;
+	fill(a, 0.1f);
+	fill(b, 0.7f);
+
+	const double generic_ns = timeNs([&](int i) {
+		a(0, 0) = static_cast<float>(i);
+		sink = multiplyGeneric(a, b)(M - 1, P - 1);
+	});
+
+	const double kernel_ns = timeNs([&](int i) {
+		a(0, 0) = static_cast<float>(i);
+		sink = (a * b)(M - 1, P - 1);
+	});
+
+	printTiming(name, generic_ns, kernel_ns);
+}
+
+template<size_t M, size_t N>
+void benchmarkTransformCovariance(const char *name)
+{
+	Matrix<float, M, N> A;
+	SquareMatrix<float, N> P;
+	fill(A, 0.3f);
+	fillSymmetric(P, 0.9f);
+
+	const double generic_ns = timeNs([&](int i) {
+		A(0, 0) = static_cast<float>(i);
+		sink = multiplyGeneric(multiplyGeneric(A, Matrix<float, N, N>(P)), A.transpose())(M - 1, M - 1);
+	});
+
+	const double kernel_ns = timeNs([&](int i) {
+		A(0, 0) = static_cast<float>(i);
+		sink = transformCovariance(A, P)(M - 1, M - 1);
+	});
+
+	printTiming(name, generic_ns, kernel_ns);
+}
+
+template<size_t M>
+void benchmarkOuterProduct(const char *name)
+{
+	SquareMatrix<float, M> P;
+	Vector<float, M> v;
+	fillSymmetric(P, 0.2f);
+	fill(v, 0.5f);
+
+	const double generic_ns = timeNs([&](int i) {
+		v(0) = static_cast<float>(i);
+		P -= multiplyGeneric(Matrix<float, M, 1>(v), Matrix<float, 1, M>(v.transpose())) * 1e-9f;
+		sink = P(M - 1, M - 1);
+	});
+
+	const double kernel_ns = timeNs([&](int i) {
+		v(0) = static_cast<float>(i);
+		P.addOuterProduct(v, -1e-9f);
+		sink = P(M - 1, M - 1);
+	});
+
+	printTiming(name, generic_ns, kernel_ns);
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+	if (argc > 1) {
+		repeats = std::max(atoi(argv[1]), 1);
+	}
+
+	benchmarkMultiply<3, 3, 1>("3x3 * 3x1");
+	benchmarkMultiply<3, 3, 3>("3x3 * 3x3");
+	benchmarkMultiply<4, 4, 1>("4x4 * 4x1");
+	benchmarkMultiply<4, 4, 4>("4x4 * 4x4");
+	benchmarkMultiply<6, 16, 16>("6x16 * 16x16");
+	benchmarkMultiply<16, 16, 16>("16x16 * 16x16");
+	benchmarkMultiply<24, 24, 24>("24x24 * 24x24");
+
+	benchmarkTransformCovariance<3, 3>("3x3 A*P*A^T");
+	benchmarkTransformCovariance<6, 16>("6x16 A*P*A^T");
+	benchmarkTransformCovariance<16, 16>("16x16 A*P*A^T");
+	benchmarkTransformCovariance<24, 24>("24x24 A*P*A^T");
+
+	benchmarkOuterProduct<16>("16 P += a*v*v^T");
+	benchmarkOuterProduct<24>("24 P += a*v*v^T");
+
+	return 0;
+}
@@ -0,0 +1,82 @@
+/****************************************************************************
+ *
+ *   Copyright (C) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * Generic triple loop matrix product (the implementation before the specialized kernels)
+ * and test data, shared by MatrixKernelTest and the matrix kernel benchmark.
+ */
+
+#pragma once
+
+#include <matrix/math.hpp>
+
+namespace matrix
+{
+namespace reference
+{
+
+template<typename Type, size_t M, size_t N, size_t P>
+Matrix<Type, M, P> multiplyGeneric(const Matrix<Type, M, N> &a, const Matrix<Type, N, P> &b)
+{
+	Matrix<Type, M, P> res{};
+
+	for (size_t i = 0; i < M; i++) {
+		for (size_t k = 0; k < P; k++) {
+			for (size_t j = 0; j < N; j++) {
+				res(i, k) += a(i, j) * b(j, k);
+			}
+		}
+	}
+
+	return res;
+}
+
+template<typename Type, size_t M, size_t N>
+void fill(Matrix<Type, M, N> &m, float seed)
+{
+	for (size_t i = 0; i < M; i++) {
+		for (size_t j = 0; j < N; j++) {
+			m(i, j) = sinf(seed + 0.37f * i + 1.13f * j);
+		}
+	}
+}
+
+template<typename Type, size_t M>
+void fillSymmetric(SquareMatrix<Type, M> &m, float seed)
+{
+	fill(m, seed);
+	m = (m + m.T()) * 0.5f;
+}
+
+} // namespace reference
+} // namespace matrix
@@ -0,0 +1,114 @@
+/****************************************************************************
+ *
+ *   Copyright (C) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * Checks the specialized matrix kernels and the fused operations against the generic triple loop.
+ * Their timing is measured by the matrix_kernel_benchmark executable.
+ */
+
+#include <gtest/gtest.h>
+#include <matrix/math.hpp>
+
+#include "MatrixKernelReference.hpp"
+
+using namespace matrix;
+using namespace matrix::reference;
+
+namespace
+{
+
+template<size_t M, size_t N, size_t P>
+void checkMultiply(const char *name)
+{
+	Matrix<float, M, N> a;
+	Matrix<float, N, P> b;
+	fill(a, 0.1f);
+	fill(b, 0.7f);
+
+	// same summation order per element, results have to match exactly
+	EXPECT_TRUE(isEqual(a * b, multiplyGeneric(a, b), 1e-6f)) << name;
+}
+
+template<size_t M, size_t N>
+void checkTransformCovariance(const char *name)
+{
+	Matrix<float, M, N> A;
+	SquareMatrix<float, N> P;
+	fill(A, 0.3f);
+	fillSymmetric(P, 0.9f);
+
+	SquareMatrix<float, M> res = transformCovariance(A, P);
+	EXPECT_TRUE(isEqual(res, SquareMatrix<float, M>(A * P * A.T()), 1e-4f)) << name;
+	EXPECT_TRUE(res.template isBlockSymmetric<M>(0, 0.f)) << name;
+}
+
+template<size_t M>
+void checkOuterProduct(const char *name)
+{
+	SquareMatrix<float, M> P;
+	Vector<float, M> v;
+	fillSymmetric(P, 0.2f);
+	fill(v, 0.5f);
+
+	SquareMatrix<float, M> res = P;
+	res.addOuterProduct(v, -0.5f);
+	EXPECT_TRUE(isEqual(res, SquareMatrix<float, M>(P - Matrix<float, M, 1>(v) * v.transpose() * 0.5f), 1e-6f)) << name;
+	EXPECT_TRUE(res.template isBlockSymmetric<M>(0, 0.f)) << name;
+}
+
+} // namespace
+
+TEST(MatrixKernelTest, Multiply)
+{
+	checkMultiply<3, 3, 1>("3x3 * 3x1");
+	checkMultiply<3, 3, 3>("3x3 * 3x3");
+	checkMultiply<4, 4, 1>("4x4 * 4x1");
+	checkMultiply<4, 4, 4>("4x4 * 4x4");
+	checkMultiply<6, 16, 16>("6x16 * 16x16");
+	checkMultiply<16, 16, 16>("16x16 * 16x16");
+	checkMultiply<24, 24, 24>("24x24 * 24x24");
+}
+
+TEST(MatrixKernelTest, TransformCovariance)
+{
+	checkTransformCovariance<3, 3>("3x3 A*P*A^T");
+	checkTransformCovariance<6, 16>("6x16 A*P*A^T");
+	checkTransformCovariance<16, 16>("16x16 A*P*A^T");
+	checkTransformCovariance<24, 24>("24x24 A*P*A^T");
+}
+
+TEST(MatrixKernelTest, OuterProduct)
+{
+	checkOuterProduct<16>("16 P += a*v*v^T");
+	checkOuterProduct<24>("24 P += a*v*v^T");
+}
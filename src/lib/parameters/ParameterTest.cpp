@@ -36,6 +36,12 @@
 #include <uORB/topics/obstacle_distance.h>
 #include <uORB/uORBManager.hpp>
 
+#include <lib/tinybson/tinybson.h>
+
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
 #include <gtest/gtest.h>
 
 class ParameterTest : public ::testing::Test
@@ -48,6 +54,58 @@ public:
 	}
 };
 
+/** Content of an exported BSON parameter file */
+struct ExportedParams {
+	int count{0};
+	bool has_cp_delay{false};
+	bool has_base{false};
+	uint32_t hash{0};
+	uint32_t base{0};
+};
+
+static ExportedParams *exported_params{nullptr};
+
+static int exported_params_callback(bson_decoder_t decoder, bson_node_t node)
+{
+	ExportedParams *exported = exported_params;
+
+	if (node->type == BSON_EOO) {
+		return 0;
+	}
+
+	if (strcmp(node->name, "_HASH_CHECK") == 0) {
+		exported->hash = static_cast<uint32_t>(node->i32);
+
+	} else if (strcmp(node->name, "_HASH_BASE") == 0) {
+		exported->has_base = true;
+		exported->base = static_cast<uint32_t>(node->i32);
+
+	} else {
+		exported->has_cp_delay |= (strcmp(node->name, "CP_DELAY") == 0);
+		exported->count++;
+	}
+
+	return 1;
+}
+
+static ExportedParams read_exported_params(const char *filename)
+{
+	ExportedParams exported{};
+	int fd = open(filename, O_RDONLY);
+
+	if (fd >= 0) {
+		bson_decoder_s decoder{};
+		exported_params = &exported;
+
+		if (bson_decoder_init_file(&decoder, fd, exported_params_callback) == 0) {
+			while (bson_decoder_next(&decoder) > 0) {}
+		}
+
+		close(fd);
+	}
+
+	return exported;
+}
 
 TEST_F(ParameterTest, testParamReadWrite)
 {
@@ -106,3 +164,57 @@ TEST_F(ParameterTest, testUorbSendReceive)
 	// AND: all the bytes should be equal
 	EXPECT_EQ(0, memcmp(&message, &obstacle_distance, sizeof(message)));
 }
+
+TEST_F(ParameterTest, testExportDelta)
+{
+	static constexpr const char *filename = "param_export_delta_test.bson";
+
+	// GIVEN: used parameters
+	param_t cp_dist = param_find("CP_DIST");
+	param_t cp_delay = param_find("CP_DELAY");
+	ASSERT_NE(PARAM_INVALID, cp_dist);
+	ASSERT_NE(PARAM_INVALID, cp_delay);
+
+	float value = 5.f;
+	param_set(cp_dist, &value);
+
+	// WHEN: we export all parameters
+	const int count = param_export_delta(filename, 0);
+	const ExportedParams exported = read_exported_params(filename);
+
+	// THEN: all used parameters (including the ones with default values) are exported
+	EXPECT_EQ(static_cast<int>(param_count_used()), count);
+	EXPECT_EQ(count, exported.count);
+	EXPECT_FALSE(exported.has_base);
+	EXPECT_EQ(param_hash_check(), exported.hash);
+
+#if defined(CONFIG_PARAM_CHANGE_TRACKING)
+	// WHEN: a parameter changes and we export the delta to the previous export
+	value = 0.7f;
+	param_set(cp_delay, &value);
+
+	EXPECT_EQ(1, param_export_delta(filename, exported.hash));
+	const ExportedParams delta = read_exported_params(filename);
+
+	// THEN: only the changed parameter is exported
+	EXPECT_EQ(1, delta.count);
+	EXPECT_TRUE(delta.has_cp_delay);
+	EXPECT_TRUE(delta.has_base);
+	EXPECT_EQ(exported.hash, delta.base);
+
+	// WHEN: the parameter is reset to its default
+	param_reset(cp_delay);
+
+	// THEN: the delta contains it as well
+	EXPECT_EQ(1, param_export_delta(filename, delta.hash));
+	EXPECT_TRUE(read_exported_params(filename).has_cp_delay);
+
+	// WHEN: nothing changed since the last export
+	const ExportedParams last = read_exported_params(filename);
+
+	// THEN: the delta is empty
+	EXPECT_EQ(0, param_export_delta(filename, last.hash));
+#endif // CONFIG_PARAM_CHANGE_TRACKING
+
+	unlink(filename);
+}
@@ -438,6 +438,19 @@ __EXPORT int 		param_load_default(void);
  */
 __EXPORT uint32_t	param_hash_check(void);
 
+/**
+ * Export the used parameters that changed since a parameter hash was generated.
+ *
+ * The BSON file starts with the hash of the exported state (_HASH_CHECK) and, for a delta, the hash it applies
+ * to (_HASH_BASE). Unlike param_export(), parameters with default values are included. If the hash is unknown
+ * (0, too old, or change tracking is disabled) all used parameters are exported and _HASH_BASE is omitted.
+ *
+ * @param filename	Path of the file to write.
+ * @param since_hash	Hash previously returned by param_hash_check(), or 0 for all used parameters.
+ * @return		Number of exported parameters, negative on failure.
+ */
+__EXPORT int		param_export_delta(const char *filename, uint32_t since_hash);
+
 /**
  * Print the status of the param system
  *
@@ -100,6 +100,21 @@ static ParamAutosave *autosave_instance {nullptr};
 static px4::AtomicBitset<param_info_count> params_active;  // params found
 static px4::AtomicBitset<param_info_count> params_unsaved;
 
+#if defined(CONFIG_PARAM_CHANGE_TRACKING)
+/* change tracking: every change increments the change count, which is stored (truncated) for the changed parameter */
+static px4::atomic<uint32_t> param_change_count{0};
+static uint16_t param_last_change[param_info_count] {};
+
+/* recently generated hashes, with the change count at the time the hash was generated */
+struct param_hash_history_s {
+	uint32_t hash;
+	uint32_t change_count;
+};
+static param_hash_history_s param_hash_history[8] {};
+static unsigned param_hash_history_next = 0;
+static pthread_mutex_t param_hash_history_mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif // CONFIG_PARAM_CHANGE_TRACKING
+
 static ConstLayer firmware_defaults;
 static DynamicSparseLayer runtime_defaults{&firmware_defaults};
 DynamicSparseLayer user_config{&runtime_defaults};
@@ -179,6 +194,14 @@ param_notify_changes()
 #endif
 }
 
+static void
+param_mark_changed(param_t param)
+{
+#if defined(CONFIG_PARAM_CHANGE_TRACKING)
+	param_last_change[param] = param_change_count.fetch_add(1) + 1;
+#endif // CONFIG_PARAM_CHANGE_TRACKING
+}
+
 static param_t param_find_internal(const char *name, bool notification)
 {
 	perf_count(param_find_perf);
@@ -441,6 +464,10 @@ param_set_internal(param_t param, const void *val, bool mark_saved, bool notify_
 		params_unsaved.set(param, !mark_saved);
 		result = PX4_OK;
 
+		if (param_changed) {
+			param_mark_changed(param);
+		}
+
 	} else {
 		PX4_ERR("param_set failed to store param %s", param_name(param));
 		result = PX4_ERROR;
@@ -528,7 +555,11 @@ void param_set_used(param_t param)
 
 #endif
 
-		params_active.set(param, true);
+		if (!params_active[param]) {
+			// a parameter that becomes used is new to anyone who synchronized the used parameters before
+			params_active.set(param, true);
+			param_mark_changed(param);
+		}
 	}
 }
 
@@ -600,6 +631,10 @@ int param_set_default_value(param_t param, const void *val)
 	}
 
 
+	if (result == PX4_OK) {
+		param_mark_changed(param);
+	}
+
 	if ((result == PX4_OK) && param_used(param)) {
 		// send notification if param is already in use
 		param_notify_changes();
@@ -619,6 +654,10 @@ static int param_reset_internal(param_t param, bool notify = true, bool autosave
 
 	if (handle_in_range(param)) {
 		user_config.reset(param);
+
+		if (param_found) {
+			param_mark_changed(param);
+		}
 	}
 
 	if (autosave) {
@@ -1306,10 +1345,69 @@ param_foreach(void (*func)(void *arg, param_t param), void *arg, bool only_chang
 	}
 }
 
+#if defined(CONFIG_PARAM_CHANGE_TRACKING)
+static void
+param_hash_history_add(uint32_t hash, uint32_t change_count)
+{
+	pthread_mutex_lock(&param_hash_history_mutex);
+
+	bool found = false;
+
+	for (auto &entry : param_hash_history) {
+		if (entry.hash == hash && entry.change_count != 0) {
+			// the same state can be reached again, the newest change count gives the smallest delta
+			entry.change_count = change_count;
+			found = true;
+			break;
+		}
+	}
+
+	if (!found) {
+		param_hash_history[param_hash_history_next] = {hash, change_count};
+		param_hash_history_next = (param_hash_history_next + 1) % (sizeof(param_hash_history) / sizeof(
+						  param_hash_history[0]));
+	}
+
+	pthread_mutex_unlock(&param_hash_history_mutex);
+}
+
+static bool
+param_hash_history_find(uint32_t hash, uint32_t &change_count)
+{
+	pthread_mutex_lock(&param_hash_history_mutex);
+
+	bool found = false;
+
+	for (const auto &entry : param_hash_history) {
+		if (entry.hash == hash && entry.change_count != 0) {
+			change_count = entry.change_count;
+			found = true;
+			break;
+		}
+	}
+
+	pthread_mutex_unlock(&param_hash_history_mutex);
+
+	return found;
+}
+
+static bool
+param_changed_since(param_t param, uint32_t change_count)
+{
+	// the stored change count is truncated, which is fine as long as there were less than 2^15 changes since
+	return static_cast<int16_t>(static_cast<uint16_t>(param_last_change[param] - change_count)) > 0;
+}
+#endif // CONFIG_PARAM_CHANGE_TRACKING
+
 uint32_t param_hash_check()
 {
 	uint32_t param_hash = 0;
 
+#if defined(CONFIG_PARAM_CHANGE_TRACKING)
+	// get the change count before reading the values: anything changed afterwards is part of the next delta
+	const uint32_t change_count = param_change_count.load();
+#endif // CONFIG_PARAM_CHANGE_TRACKING
+
 	/* compute the CRC32 over all string param names and 4 byte values */
 	for (param_t param = 0; handle_in_range(param); param++) {
 		if (!param_used(param) || param_is_volatile(param)) {
@@ -1323,9 +1421,115 @@ uint32_t param_hash_check()
 		param_hash = crc32part((const uint8_t *)val, param_size(param), param_hash);
 	}
 
+#if defined(CONFIG_PARAM_CHANGE_TRACKING)
+
+	// a change count of 0 marks unused history entries (nothing is used before the first param_find() either)
+	if (change_count != 0) {
+		param_hash_history_add(param_hash, change_count);
+	}
+
+#endif // CONFIG_PARAM_CHANGE_TRACKING
+
 	return param_hash;
 }
 
+int param_export_delta(const char *filename, uint32_t since_hash)
+{
+	bool delta = false;
+
+#if defined(CONFIG_PARAM_CHANGE_TRACKING)
+	uint32_t since_change_count = 0;
+
+	if (since_hash != 0 && param_hash_history_find(since_hash, since_change_count)) {
+		delta = (param_change_count.load() - since_change_count) < INT16_MAX;
+	}
+
+#endif // CONFIG_PARAM_CHANGE_TRACKING
+
+	// hash of the exported values, so that the next request can be a delta to this one
+	const uint32_t hash = param_hash_check();
+
+	int fd = ::open(filename, O_WRONLY | O_CREAT | O_TRUNC, PX4_O_MODE_666);
+
+	if (fd < 0) {
+		PX4_ERR("export delta open failed %d", errno);
+		return -1;
+	}
+
+	int result = -1;
+	int count = 0;
+	bson_encoder_s encoder{};
+	uint8_t bson_buffer[256];
+
+	perf_begin(param_export_perf);
+
+	if (bson_encoder_init_buf_file(&encoder, fd, &bson_buffer, sizeof(bson_buffer)) != 0) {
+		goto out;
+	}
+
+	if (bson_encoder_append_int32(&encoder, "_HASH_CHECK", static_cast<int32_t>(hash)) != 0) {
+		goto out;
+	}
+
+	if (delta && bson_encoder_append_int32(&encoder, "_HASH_BASE", static_cast<int32_t>(since_hash)) != 0) {
+		goto out;
+	}
+
+	for (param_t param = 0; handle_in_range(param); param++) {
+		if (!param_used(param)) {
+			continue;
+		}
+
+#if defined(CONFIG_PARAM_CHANGE_TRACKING)
+
+		if (delta && !param_changed_since(param, since_change_count)) {
+			continue;
+		}
+
+#endif // CONFIG_PARAM_CHANGE_TRACKING
+
+		// unlike param_export() default values are included, a delta has to contain parameters reset to default
+		const param_value_u value = user_config.get(param);
+		const char *name = param_name(param);
+
+		switch (param_type(param)) {
+		case PARAM_TYPE_INT32:
+			if (bson_encoder_append_int32(&encoder, name, value.i) != 0) {
+				PX4_ERR("BSON append failed for '%s'", name);
+				goto out;
+			}
+
+			break;
+
+		case PARAM_TYPE_FLOAT:
+			if (bson_encoder_append_double(&encoder, name, (double)value.f) != 0) {
+				PX4_ERR("BSON append failed for '%s'", name);
+				goto out;
+			}
+
+			break;
+
+		default:
+			continue;
+		}
+
+		count++;
+	}
+
+	if (bson_encoder_fini(&encoder) == PX4_OK) {
+		result = count;
+
+	} else {
+		PX4_ERR("BSON encoder finalize failed");
+	}
+
+out:
+	perf_end(param_export_perf);
+	::close(fd);
+
+	return result;
+}
+
 void param_print_status()
 {
 	PX4_INFO("summary: %d/%d (used/total)", param_count_used(), param_count());
@@ -190,6 +190,12 @@ int	param_ioctl(unsigned int cmd, unsigned long arg)
 		}
 		break;
 
+	case PARAMIOCEXPORTDELTA: {
+			paramiocexportdelta_t *data = (paramiocexportdelta_t *)arg;
+			data->ret = param_export_delta(data->filename, data->since_hash);
+		}
+		break;
+
 	default:
 		ret = -ENOTTY;
 		break;
@@ -161,4 +161,11 @@ typedef struct paramiochash {
 	uint32_t ret;
 } paramiochash_t;
 
+#define PARAMIOCEXPORTDELTA	_PARAMIOC(19)
+typedef struct paramiocexportdelta {
+	const char *filename;
+	uint32_t since_hash;
+	int ret;
+} paramiocexportdelta_t;
+
 int param_ioctl(unsigned int cmd, unsigned long arg);
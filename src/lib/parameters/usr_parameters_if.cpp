@@ -219,3 +219,10 @@ uint32_t param_hash_check()
 	boardctl(PARAMIOCHASH, reinterpret_cast<unsigned long>(&data));
 	return data.ret;
 }
+
+int param_export_delta(const char *filename, uint32_t since_hash)
+{
+	paramiocexportdelta_t data = {filename, since_hash, PX4_ERROR};
+	boardctl(PARAMIOCEXPORTDELTA, reinterpret_cast<unsigned long>(&data));
+	return data.ret;
+}
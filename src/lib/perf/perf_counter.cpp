@@ -91,6 +91,44 @@ struct perf_ctr_interval : public perf_ctr_header {
 	float			M2{0.0f};
 };
 
+/**
+ * PC_HISTOGRAM counter.
+ *
+ * Log-scale buckets with 4 linear sub-buckets per power of two: values 0-3 us have
+ * their own bucket, and bucket (4 * (e - 1) + s) holds [(4 + s) << (e - 2), (5 + s) << (e - 2)) us.
+ * The last bucket holds everything from 114688 us. Updates are lock-free.
+ */
+static constexpr int PERF_HISTOGRAM_BUCKETS = 64;
+
+struct perf_ctr_histogram : public perf_ctr_header {
+	uint64_t		time_start{0};
+	uint64_t		time_total{0};
+	uint32_t		event_count{0};
+	uint32_t		time_most{0};
+	uint32_t		buckets[PERF_HISTOGRAM_BUCKETS] {};
+};
+
+static inline int histogram_bucket(uint32_t value)
+{
+	if (value < 4) {
+		return value;
+	}
+
+	const int e = 31 - __builtin_clz(value); // >= 2
+	const int bucket = 4 * (e - 1) + ((value >> (e - 2)) & 3);
+	return (bucket < PERF_HISTOGRAM_BUCKETS) ? bucket : PERF_HISTOGRAM_BUCKETS - 1;
+}
+
+static inline uint32_t histogram_bucket_upper(int bucket)
+{
+	if (bucket < 4) {
+		return bucket + 1;
+	}
+
+	const int e = bucket / 4 + 1;
+	return (uint32_t)(5 + (bucket % 4)) << (e - 2);
+}
+
 /**
  * List of all known counters.
  */
@@ -126,6 +164,10 @@ perf_alloc(enum perf_counter_type type, const char *name)
 		ctr = new perf_ctr_interval();
 		break;
 
+	case PC_HISTOGRAM:
+		ctr = new perf_ctr_histogram();
+		break;
+
 	default:
 		break;
 	}
@@ -194,6 +236,10 @@ perf_free(perf_counter_t handle)
 		delete (struct perf_ctr_interval *)handle;
 		break;
 
+	case PC_HISTOGRAM:
+		delete (struct perf_ctr_histogram *)handle;
+		break;
+
 	default:
 		break;
 	}
@@ -232,6 +278,10 @@ perf_begin(perf_counter_t handle)
 		((struct perf_ctr_elapsed *)handle)->time_start = hrt_absolute_time();
 		break;
 
+	case PC_HISTOGRAM:
+		((struct perf_ctr_histogram *)handle)->time_start = hrt_absolute_time();
+		break;
+
 	default:
 		break;
 	}
@@ -254,6 +304,15 @@ perf_end(perf_counter_t handle)
 		}
 		break;
 
+	case PC_HISTOGRAM: {
+			struct perf_ctr_histogram *pch = (struct perf_ctr_histogram *)handle;
+
+			if (pch->time_start != 0) {
+				perf_set_elapsed(handle, hrt_elapsed_time(&pch->time_start));
+			}
+		}
+		break;
+
 	default:
 		break;
 	}
@@ -294,6 +353,26 @@ perf_set_elapsed(perf_counter_t handle, int64_t elapsed)
 		}
 		break;
 
+	case PC_HISTOGRAM: {
+			struct perf_ctr_histogram *pch = (struct perf_ctr_histogram *)handle;
+
+			if (elapsed >= 0) {
+				const uint32_t value = (elapsed < UINT32_MAX) ? (uint32_t)elapsed : UINT32_MAX;
+
+				__atomic_fetch_add(&pch->buckets[histogram_bucket(value)], 1, __ATOMIC_RELAXED);
+				__atomic_fetch_add(&pch->event_count, 1, __ATOMIC_RELAXED);
+				pch->time_total += elapsed; // not atomic (64 bit), like PC_ELAPSED
+
+				uint32_t most = __atomic_load_n(&pch->time_most, __ATOMIC_RELAXED);
+
+				while ((value > most)
+				       && !__atomic_compare_exchange_n(&pch->time_most, &most, value, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {}
+
+				pch->time_start = 0;
+			}
+		}
+		break;
+
 	default:
 		break;
 	}
@@ -387,6 +466,10 @@ perf_cancel(perf_counter_t handle)
 		}
 		break;
 
+	case PC_HISTOGRAM:
+		((struct perf_ctr_histogram *)handle)->time_start = 0;
+		break;
+
 	default:
 		break;
 	}
@@ -424,6 +507,20 @@ perf_reset(perf_counter_t handle)
 			pci->time_most = 0;
 			break;
 		}
+
+	case PC_HISTOGRAM: {
+			struct perf_ctr_histogram *pch = (struct perf_ctr_histogram *)handle;
+			pch->time_start = 0;
+			pch->time_total = 0;
+			__atomic_store_n(&pch->event_count, 0, __ATOMIC_RELAXED);
+			__atomic_store_n(&pch->time_most, 0, __ATOMIC_RELAXED);
+
+			for (int i = 0; i < PERF_HISTOGRAM_BUCKETS; i++) {
+				__atomic_store_n(&pch->buckets[i], 0, __ATOMIC_RELAXED);
+			}
+
+			break;
+		}
 	}
 }
 
@@ -470,6 +567,21 @@ perf_print_counter(perf_counter_t handle)
 			break;
 		}
 
+	case PC_HISTOGRAM: {
+			struct perf_ctr_histogram *pch = (struct perf_ctr_histogram *)handle;
+
+			PX4_INFO_RAW("%s: %" PRIu32 " events, p50 %" PRIu32 "us p90 %" PRIu32 "us p99 %" PRIu32 "us p99.9 %" PRIu32
+				     "us max %" PRIu32 "us\n",
+				     handle->name,
+				     pch->event_count,
+				     perf_percentile(handle, 0.5f),
+				     perf_percentile(handle, 0.9f),
+				     perf_percentile(handle, 0.99f),
+				     perf_percentile(handle, 0.999f),
+				     pch->time_most);
+			break;
+		}
+
 	default:
 		break;
 	}
@@ -522,6 +634,21 @@ perf_print_counter_buffer(char *buffer, int length, perf_counter_t handle)
 			break;
 		}
 
+	case PC_HISTOGRAM: {
+			struct perf_ctr_histogram *pch = (struct perf_ctr_histogram *)handle;
+
+			num_written = snprintf(buffer, length,
+					       "%s: %" PRIu32 " events, p50 %" PRIu32 "us p90 %" PRIu32 "us p99 %" PRIu32 "us p99.9 %" PRIu32 "us max %" PRIu32 "us",
+					       handle->name,
+					       pch->event_count,
+					       perf_percentile(handle, 0.5f),
+					       perf_percentile(handle, 0.9f),
+					       perf_percentile(handle, 0.99f),
+					       perf_percentile(handle, 0.999f),
+					       pch->time_most);
+			break;
+		}
+
 	default:
 		break;
 	}
@@ -551,6 +678,9 @@ perf_event_count(perf_counter_t handle)
 			return pci->event_count;
 		}
 
+	case PC_HISTOGRAM:
+		return ((struct perf_ctr_histogram *)handle)->event_count;
+
 	default:
 		break;
 	}
@@ -583,6 +713,105 @@ perf_mean(perf_counter_t handle)
 	return 0.0f;
 }
 
+uint64_t
+perf_elapsed_total(perf_counter_t handle)
+{
+	if (handle == nullptr) {
+		return 0;
+	}
+
+	switch (handle->type) {
+	case PC_ELAPSED:
+		return ((struct perf_ctr_elapsed *)handle)->time_total;
+
+	case PC_HISTOGRAM:
+		return ((struct perf_ctr_histogram *)handle)->time_total;
+
+	default:
+		break;
+	}
+
+	return 0;
+}
+
+uint32_t
+perf_max(perf_counter_t handle)
+{
+	if (handle == nullptr) {
+		return 0;
+	}
+
+	switch (handle->type) {
+	case PC_ELAPSED:
+		return ((struct perf_ctr_elapsed *)handle)->time_most;
+
+	case PC_INTERVAL:
+		return ((struct perf_ctr_interval *)handle)->time_most;
+
+	case PC_HISTOGRAM:
+		return __atomic_load_n(&((struct perf_ctr_histogram *)handle)->time_most, __ATOMIC_RELAXED);
+
+	default:
+		break;
+	}
+
+	return 0;
+}
+
+uint32_t
+perf_percentile(perf_counter_t handle, float percentile)
+{
+	if ((handle == nullptr) || (handle->type != PC_HISTOGRAM)) {
+		return 0;
+	}
+
+	struct perf_ctr_histogram *pch = (struct perf_ctr_histogram *)handle;
+
+	// take a snapshot, the buckets may be updated concurrently
+	uint32_t buckets[PERF_HISTOGRAM_BUCKETS];
+	uint32_t total = 0;
+
+	for (int i = 0; i < PERF_HISTOGRAM_BUCKETS; i++) {
+		buckets[i] = __atomic_load_n(&pch->buckets[i], __ATOMIC_RELAXED);
+		total += buckets[i];
+	}
+
+	if (total == 0) {
+		return 0;
+	}
+
+	const uint32_t time_most = __atomic_load_n(&pch->time_most, __ATOMIC_RELAXED);
+
+	// number of events at or below the percentile (at least 1)
+	const float rank = ceilf(percentile * total);
+	const uint32_t target = (rank < 1.f) ? 1 : ((rank > total) ? total : (uint32_t)rank);
+	uint32_t count = 0;
+
+	for (int i = 0; i < PERF_HISTOGRAM_BUCKETS; i++) {
+		count += buckets[i];
+
+		if (count >= target) {
+			// never report more than the largest measured value
+			const uint32_t upper = (i < PERF_HISTOGRAM_BUCKETS - 1) ? histogram_bucket_upper(i) : time_most;
+			return (upper < time_most) ? upper : time_most;
+		}
+	}
+
+	return time_most;
+}
+
+enum perf_counter_type
+perf_type(perf_counter_t handle)
+{
+	return handle->type;
+}
+
+const char *
+perf_name(perf_counter_t handle)
+{
+	return handle->name;
+}
+
 void
 perf_iterate_all(perf_callback cb, void *user)
 {
@@ -48,7 +48,8 @@
 enum perf_counter_type {
 	PC_COUNT,		/**< count the number of times an event occurs */
 	PC_ELAPSED,		/**< measure the time elapsed performing an event */
-	PC_INTERVAL		/**< measure the interval between instances of an event */
+	PC_INTERVAL,		/**< measure the interval between instances of an event */
+	PC_HISTOGRAM		/**< measure the time elapsed performing an event, as a histogram for percentiles */
 };
 
 struct perf_ctr_header;
@@ -117,7 +118,7 @@ __EXPORT extern void		perf_end(perf_counter_t handle);
 /**
  * Register a measurement
  *
- * This call applies to counters that operate over ranges of time; PC_ELAPSED etc.
+ * This call applies to counters that operate over ranges of time; PC_ELAPSED, PC_HISTOGRAM etc.
  * If a call is made without a corresponding perf_begin call. It sets the
  * value provided as argument as a new measurement.
  *
@@ -230,6 +231,52 @@ __EXPORT extern uint64_t	perf_event_count(perf_counter_t handle);
  */
 __EXPORT extern float		perf_mean(perf_counter_t handle);
 
+/**
+ * Return the total elapsed time
+ *
+ * This call applies to counters of type PC_ELAPSED and PC_HISTOGRAM.
+ *
+ * @param handle		The handle returned from perf_alloc.
+ * @return			total elapsed time in us
+ */
+__EXPORT extern uint64_t	perf_elapsed_total(perf_counter_t handle);
+
+/**
+ * Return the largest measurement
+ *
+ * This call applies to counters of type PC_ELAPSED, PC_INTERVAL and PC_HISTOGRAM.
+ *
+ * @param handle		The handle returned from perf_alloc.
+ * @return			largest elapsed time or interval in us
+ */
+__EXPORT extern uint32_t	perf_max(perf_counter_t handle);
+
+/**
+ * Return a percentile of the measured times
+ *
+ * This call applies to counters of type PC_HISTOGRAM. The result is the upper bound
+ * of the histogram bucket containing the percentile, so it's accurate to within 25%.
+ *
+ * @param handle		The handle returned from perf_alloc.
+ * @param percentile		The percentile, in the range [0, 1] (eg 0.99f).
+ * @return			percentile in us, or 0 if there are no events
+ */
+__EXPORT extern uint32_t	perf_percentile(perf_counter_t handle, float percentile);
+
+/**
+ * Return the counter type
+ *
+ * @param handle		The handle returned from perf_alloc.
+ */
+__EXPORT extern enum perf_counter_type perf_type(perf_counter_t handle);
+
+/**
+ * Return the counter name
+ *
+ * @param handle		The handle returned from perf_alloc.
+ */
+__EXPORT extern const char	*perf_name(perf_counter_t handle);
+
 __END_DECLS
 
 #endif
@@ -52,7 +52,7 @@ using namespace time_literals;
 ControlAllocator::ControlAllocator() :
 	ModuleParams(nullptr),
 	ScheduledWorkItem(MODULE_NAME, px4::wq_configurations::rate_ctrl),
-	_loop_perf(perf_alloc(PC_ELAPSED, MODULE_NAME": cycle"))
+	_loop_perf(perf_alloc(PC_HISTOGRAM, MODULE_NAME": cycle"))
 {
 	_control_allocator_status_pub[0].advertise();
 	_control_allocator_status_pub[1].advertise();
@@ -169,12 +169,15 @@ void Ekf::fuseGnssYaw(float antenna_yaw_offset)
 
 	float heading_pred;
 	float heading_innov_var;
-	VectorState H;
+	VectorState H_full;
 
 	// Note: we recompute innov and innov_var because it doesn't cost much more than just computing H
 	// making a separate function just for H uses more flash space without reducing CPU load significantly
 	sym::ComputeGnssYawPredInnovVarAndH(_state.vector(), P, antenna_yaw_offset, aid_src.observation_variance, FLT_EPSILON,
-					    &heading_pred, &heading_innov_var, &H);
+					    &heading_pred, &heading_innov_var, &H_full);
+
+	// the heading only depends on the orientation states
+	const SparseVectorState<State::quat_nominal.idx, State::quat_nominal.idx + 1, State::quat_nominal.idx + 2> H(H_full);
 
 	// check if the innovation variance calculation is badly conditioned
 	if (aid_src.innovation_variance < aid_src.observation_variance) {
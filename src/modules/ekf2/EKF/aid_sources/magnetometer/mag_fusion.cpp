@@ -142,12 +142,15 @@ bool Ekf::fuseMag(const Vector3f &mag, const float R_MAG, VectorState &H, estima
 
 bool Ekf::fuseDeclination(float decl_measurement_rad, float R, bool update_all_states)
 {
-	VectorState H;
+	VectorState H_full;
 	float decl_pred;
 	float innovation_variance;
 
 	sym::ComputeMagDeclinationPredInnovVarAndH(_state.vector(), P, R, FLT_EPSILON,
-			&decl_pred, &innovation_variance, &H);
+			&decl_pred, &innovation_variance, &H_full);
+
+	// the declination only depends on the horizontal earth field states
+	const SparseVectorState<State::mag_I.idx, State::mag_I.idx + 1> H(H_full);
 
 	const float innovation = wrap_pi(decl_pred - decl_measurement_rad);
 
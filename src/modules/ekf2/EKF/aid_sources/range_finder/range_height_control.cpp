@@ -285,8 +285,9 @@ void Ekf::resetTerrainToRng(estimator_aid_source1d_s &aid_src)
 
 	const float old_terrain = _state.terrain;
 
-	VectorState H;
-	sym::ComputeHaglH(&H);
+	VectorState H_full;
+	sym::ComputeHaglH(&H_full);
+	const SparseVectorState<State::pos.idx + 2, State::terrain.idx> H(H_full);
 
 	VectorState K;
 	K(State::terrain.idx) = 1.f; // innovation is forced into the terrain state to create a "reset"
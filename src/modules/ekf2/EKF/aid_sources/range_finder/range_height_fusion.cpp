@@ -41,9 +41,11 @@ bool Ekf::fuseHaglRng(estimator_aid_source1d_s &aid_src, bool update_height, boo
 		return false;
 	}
 
-	VectorState H;
+	VectorState H_full;
+	sym::ComputeHaglH(&H_full);
 
-	sym::ComputeHaglH(&H);
+	// only the height and terrain states are observed
+	const SparseVectorState<State::pos.idx + 2, State::terrain.idx> H(H_full);
 
 	// calculate the Kalman gain
 	VectorState K = P * H / aid_src.innovation_variance;
@@ -74,6 +74,8 @@ class Ekf final : public EstimatorInterface
 public:
 	typedef matrix::Vector<float, State::size> VectorState;
 	typedef matrix::SquareMatrix<float, State::size> SquareMatrixState;
+	template <size_t ... Idxs>
+	using SparseVectorState = matrix::SparseVectorf<State::size, Idxs...>;
 
 	Ekf()
 	{
@@ -262,6 +264,22 @@ public:
 
 	bool measurementUpdate(VectorState &K, const VectorState &H, const float R, const float innovation);
 
+	// same as above, for observation Jacobians with only a few non-zero entries (P * H uses only those columns)
+	template <size_t ... Idxs>
+	bool measurementUpdate(VectorState &K, const SparseVectorState<Idxs...> &H, const float R, const float innovation)
+	{
+		clearInhibitedStateKalmanGains(K);
+
+		const VectorState PH = P * H; // H is stored as a column vector. H is in fact H.T
+		covarianceJosephUpdate(K, PH, H.dot(PH) + R);
+
+		constrainStateVariances();
+
+		// apply the state corrections
+		fuse(K, innovation);
+		return true;
+	}
+
 	// gyro bias
 	const Vector3f &getGyroBias() const { return _state.gyro_bias; } // get the gyroscope bias in rad/s
 	Vector3f getGyroBiasVariance() const { return getStateVariance<State::gyro_bias>(); } // get the gyroscope bias variance in rad/s
@@ -807,6 +825,9 @@ private:
 
 	void clearInhibitedStateKalmanGains(VectorState &K) const;
 
+	// Joseph stabilized covariance update for a scalar measurement, given PH = P * H.T and S = H * P * H.T + R
+	void covarianceJosephUpdate(const VectorState &K, const VectorState &PH, float S);
+
 	// limit the diagonal of the covariance matrix
 	void constrainStateVariances();
 
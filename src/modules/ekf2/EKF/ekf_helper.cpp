@@ -1050,34 +1050,9 @@ void Ekf::fuseDirectStateMeasurement(const float innov, const float innov_var, c
 	const VectorState KR = K * R;
 	P += KR.multiplyByTranspose(K);
 #else
-	// Efficient implementation of the Joseph stabilized covariance update
-	// Based on "G. J. Bierman. Factorization Methods for Discrete Sequential Estimation. Academic Press, Dover Publications, New York, 1977, 2006"
-	// P = (I - K * H) * P * (I - K * H).T   + K * R * K.T
-	//   =      P_temp     * (I - H.T * K.T) + K * R * K.T
-	//   =      P_temp - P_temp * H.T * K.T  + K * R * K.T
-
-	// Step 1: conventional update
-	// Compute P_temp and store it in P to avoid allocating more memory
 	// P is symmetric, so PH == H.T * P.T == H.T * P. Taking the row is faster as matrices are row-major
-	VectorState PH = P.row(state_index);
-
-	for (unsigned i = 0; i < State::size; i++) {
-		for (unsigned j = 0; j < State::size; j++) {
-			P(i, j) -= K(i) * PH(j); // P is now not symmetric if K is not optimal (e.g.: some gains have been zeroed)
-		}
-	}
-
-	// Step 2: stabilized update
-	// P (or "P_temp") is not symmetric so we must take the column
-	PH = P.col(state_index);
-
-	for (unsigned i = 0; i < State::size; i++) {
-		for (unsigned j = 0; j <= i; j++) {
-			P(i, j) = P(i, j) - PH(i) * K(j) + K(i) * R * K(j);
-			P(j, i) = P(i, j);
-		}
-	}
-
+	const VectorState PH = P.row(state_index);
+	covarianceJosephUpdate(K, PH, PH(state_index) + R);
 #endif
 
 	constrainStateVariances();
@@ -1101,40 +1076,35 @@ bool Ekf::measurementUpdate(VectorState &K, const VectorState &H, const float R,
 	const VectorState KR = K * R;
 	P += KR.multiplyByTranspose(K);
 #else
+	const VectorState PH = P * H; // H is stored as a column vector. H is in fact H.T
+	covarianceJosephUpdate(K, PH, H.dot(PH) + R);
+#endif
+
+	constrainStateVariances();
+
+	// apply the state corrections
+	fuse(K, innovation);
+	return true;
+}
+
+void Ekf::covarianceJosephUpdate(const VectorState &K, const VectorState &PH, const float S)
+{
 	// Efficient implementation of the Joseph stabilized covariance update
 	// Based on "G. J. Bierman. Factorization Methods for Discrete Sequential Estimation. Academic Press, Dover Publications, New York, 1977, 2006"
 	// P = (I - K * H) * P * (I - K * H).T   + K * R * K.T
-	//   =      P_temp     * (I - H.T * K.T) + K * R * K.T
-	//   =      P_temp - P_temp * H.T * K.T  + K * R * K.T
-
-	// Step 1: conventional update
-	// Compute P_temp and store it in P to avoid allocating more memory
-	// P is symmetric, so PH == H.T * P.T == H.T * P. Taking the row is faster as matrices are row-major
-	VectorState PH = P * H; // H is stored as a column vector. H is in fact H.T
-
+	//   = P - K * PH.T - PH * K.T + K * (H * P * H.T + R) * K.T
+	//
+	// This is a symmetric rank-2 update, so only the lower triangle is computed and then mirrored.
+	// It is valid for any K (e.g.: when some gains have been zeroed) and gives the same result
+	// as the conventional update followed by the stabilized update, without computing P * H twice.
 	for (unsigned i = 0; i < State::size; i++) {
-		for (unsigned j = 0; j < State::size; j++) {
-			P(i, j) -= K(i) * PH(j); // P is now not symmetrical if K is not optimal (e.g.: some gains have been zeroed)
-		}
-	}
+		const float KS_i = K(i) * S;
 
-	// Step 2: stabilized update
-	PH = P * H; // H is stored as a column vector. H is in fact H.T
-
-	for (unsigned i = 0; i < State::size; i++) {
 		for (unsigned j = 0; j <= i; j++) {
-			P(i, j) = P(i, j) - PH(i) * K(j) + K(i) * R * K(j);
+			P(i, j) = P(i, j) - K(i) * PH(j) - PH(i) * K(j) + KS_i * K(j);
 			P(j, i) = P(i, j);
 		}
 	}
-
-#endif
-
-	constrainStateVariances();
-
-	// apply the state corrections
-	fuse(K, innovation);
-	return true;
 }
 
 void Ekf::resetAidSourceStatusZeroInnovation(estimator_aid_source1d_s &status) const
@@ -55,18 +55,11 @@ bool Ekf::fuseYaw(estimator_aid_source1d_s &aid_src_status, const VectorState &H
 		return false;
 	}
 
-	// calculate the Kalman gains
-	// only calculate gains for states we are using
-	VectorState Kfusion;
-	const float heading_innov_var_inv = 1.f / aid_src_status.innovation_variance;
-
-	for (uint8_t row = 0; row < State::size; row++) {
-		for (uint8_t col = 0; col <= 3; col++) {
-			Kfusion(row) += P(row, col) * H_YAW(col);
-		}
+	// the heading only depends on the orientation states
+	const SparseVectorState<State::quat_nominal.idx, State::quat_nominal.idx + 1, State::quat_nominal.idx + 2> H(H_YAW);
 
-		Kfusion(row) *= heading_innov_var_inv;
-	}
+	// calculate the Kalman gains
+	VectorState Kfusion = P * H / aid_src_status.innovation_variance;
 
 	// set the heading unhealthy if the test fails
 	if (aid_src_status.innovation_rejected) {
@@ -98,7 +91,7 @@ bool Ekf::fuseYaw(estimator_aid_source1d_s &aid_src_status, const VectorState &H
 		_innov_check_fail_status.flags.reject_yaw = false;
 	}
 
-	measurementUpdate(Kfusion, H_YAW, aid_src_status.observation_variance, aid_src_status.innovation);
+	measurementUpdate(Kfusion, H, aid_src_status.observation_variance, aid_src_status.innovation);
 
 	_time_last_heading_fuse = _time_delayed_us;
 
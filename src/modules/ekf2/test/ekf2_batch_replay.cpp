@@ -0,0 +1,257 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * Batch replay of sensor data files through the EKF, for parameter tuning over many logs.
+ *
+ * Each run is an isolated Ekf instance with its own sensor simulator, the runs are distributed
+ * over a pool of threads (-j, default: number of cores) in this single process.
+ * The runs are read from a file, one run per line with tab separated fields:
+ *
+ *   <output_dir> <sensor_data.csv> [params.txt ...]
+ *
+ * The parameter files ("<param_name> <value>" per line, e.g. the EKF2 parameters of the log followed by
+ * overrides) are applied in order on top of the configuration of test_EKF_withReplayData, a parameter
+ * given again replaces the previous value. Parameters of the ekf2 module only are ignored with a warning.
+ *
+ * Each run writes to its (existing) output directory:
+ *  - replay.ulg: the applied parameters, the states and variances at each filter update
+ *    (ekf_replay_state) and each sample processed by the aid sources in use (ekf_replay_<aid_source>)
+ *  - test_ratios.csv: the innovation test ratio statistics per aid source, as ekf2_replay_benchmark -t
+ *
+ * Usage: ekf2_batch_replay [-j threads] runs.txt
+ *
+ * Returns non zero if a run failed.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "EKF/ekf.h"
+#include "sensor_simulator/ekf_replay.h"
+#include "sensor_simulator/ekf_ulog_logger.h"
+
+namespace
+{
+
+struct Run {
+	std::string output_dir;
+	std::string sensor_data_file;
+	std::vector<EkfParameterValue> params;
+};
+
+bool loadRuns(const char *file_name, std::vector<Run> &runs)
+{
+	std::ifstream file(file_name);
+
+	if (!file) {
+		printf("can not open %s\n", file_name);
+		return false;
+	}
+
+	std::string line;
+
+	while (std::getline(file, line)) {
+		std::stringstream ss(line);
+		std::vector<std::string> fields;
+		std::string field;
+
+		while (std::getline(ss, field, '\t')) {
+			fields.push_back(field);
+		}
+
+		if (fields.empty() || fields[0].empty() || (fields[0][0] == '#')) {
+			continue;
+		}
+
+		if (fields.size() < 2) {
+			printf("%s: no sensor data file for %s\n", file_name, fields[0].c_str());
+			return false;
+		}
+
+		Run run{fields[0], fields[1], {}};
+
+		for (size_t i = 2; i < fields.size(); i++) {
+			if (!loadEkfParameters(fields[i], run.params)) {
+				return false;
+			}
+		}
+
+		runs.push_back(run);
+	}
+
+	return true;
+}
+
+bool writeTestRatios(const std::string &file_name, const std::string &name,
+		     const TestRatios (&test_ratios)[num_ekf_aid_sources])
+{
+	FILE *file = fopen(file_name.c_str(), "w");
+
+	if (file == nullptr) {
+		return false;
+	}
+
+	fprintf(file, "scenario,aid_source,samples,mean,max,fraction_above_1\n");
+
+	for (unsigned i = 0; i < num_ekf_aid_sources; i++) {
+		const TestRatios &ratios = test_ratios[i];
+
+		// aid sources that are not in use keep a test ratio of 0
+		if ((ratios.samples == 0) || !(ratios.max > 0.f)) {
+			continue;
+		}
+
+		fprintf(file, "%s,%s,%llu,%.4f,%.4f,%.4f\n", name.c_str(), ekf_aid_sources[i].name,
+			(unsigned long long)ratios.samples, ratios.sum / ratios.samples, (double)ratios.max,
+			(double)ratios.above_1 / ratios.samples);
+	}
+
+	return fclose(file) == 0;
+}
+
+bool replay(const Run &run)
+{
+	const auto start = std::chrono::steady_clock::now();
+
+	EkfReplay replay(run.sensor_data_file, run.params);
+	EkfULogLogger ulog_logger(replay.ekf);
+
+	if (!ulog_logger.open(run.output_dir + "/replay.ulg", run.sensor_data_file, run.params)) {
+		printf("%s: can not open replay.ulg\n", run.output_dir.c_str());
+		return false;
+	}
+
+	TestRatios test_ratios[num_ekf_aid_sources] {};
+	uint64_t timestamp_sample[num_ekf_aid_sources] {};
+
+	replay.sensor_simulator.setUpdateCallback([&](uint64_t) {
+		ulog_logger.update();
+
+		for (unsigned i = 0; i < num_ekf_aid_sources; i++) {
+			const AidSourceStatus status = ekf_aid_sources[i].status(*replay.ekf);
+
+			// a new sample was processed (fused or rejected), once the aid source is in use
+			if (status.timestamp_sample != timestamp_sample[i]) {
+				timestamp_sample[i] = status.timestamp_sample;
+
+				if ((status.time_last_fuse != 0) && std::isfinite(status.test_ratio)) {
+					test_ratios[i].update(status.test_ratio);
+				}
+			}
+		}
+	});
+
+	replay.run();
+
+	const std::string name = run.output_dir.substr(run.output_dir.find_last_of('/') + 1);
+
+	if (!ulog_logger.close() || !writeTestRatios(run.output_dir + "/test_ratios.csv", name, test_ratios)) {
+		printf("%s: write failed\n", run.output_dir.c_str());
+		return false;
+	}
+
+	const std::chrono::duration<double> wall_time = std::chrono::steady_clock::now() - start;
+	printf("%s: %.0f s replayed in %.1f s\n", run.output_dir.c_str(), replay.end_time_us * 1e-6, wall_time.count());
+
+	return true;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+	unsigned threads = std::max(std::thread::hardware_concurrency(), 1u);
+	const char *runs_file = nullptr;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+			threads = std::max(atoi(argv[++i]), 1);
+
+		} else if (argv[i][0] != '-' && runs_file == nullptr) {
+			runs_file = argv[i];
+
+		} else {
+			runs_file = nullptr;
+			break;
+		}
+	}
+
+	if (runs_file == nullptr) {
+		printf("usage: ekf2_batch_replay [-j threads] runs.txt\n");
+		return 1;
+	}
+
+	std::vector<Run> runs;
+
+	if (!loadRuns(runs_file, runs)) {
+		return 1;
+	}
+
+	threads = std::min(threads, (unsigned)runs.size());
+	printf("replaying %zu runs on %u threads\n", runs.size(), threads);
+
+	std::atomic<size_t> next_run{0};
+	std::atomic<unsigned> failed_runs{0};
+	std::vector<std::thread> workers;
+
+	for (unsigned t = 0; t < threads; t++) {
+		workers.emplace_back([&]() {
+			for (size_t i = next_run++; i < runs.size(); i = next_run++) {
+				if (!replay(runs[i])) {
+					failed_runs++;
+				}
+			}
+		});
+	}
+
+	for (std::thread &worker : workers) {
+		worker.join();
+	}
+
+	if (failed_runs > 0) {
+		printf("%u of %zu runs failed\n", failed_runs.load(), runs.size());
+	}
+
+	return (failed_runs > 0) ? 1 : 0;
+}
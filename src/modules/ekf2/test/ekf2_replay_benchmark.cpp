@@ -0,0 +1,426 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * Offline throughput benchmark of the EKF, replaying sensor data as fast as possible.
+ *
+ * Without arguments, the replay data of test_EKF_withReplayData is run and the filter
+ * outputs are checked against the change indication files (within their logged precision).
+ * Otherwise the sensor data files given on the command line (e.g. ULogs converted with
+ * sensor_simulator/createSensorDataFile.py) are replayed without equivalence check.
+ *
+ * The time spent in Ekf::update() is reported per fusion type: an update is counted for
+ * each aid source it fused, updates without any fusion are reported as "predict".
+ *
+ * The innovation test ratios of the aid sources (the largest of the axes for vector aid sources)
+ * can be summarized per scenario (-t), with EKF2 parameters (-p, "<param_name> <value>" per line).
+ * For many logs or parameter sets, see ekf2_batch_replay.
+ *
+ * Usage: ekf2_replay_benchmark [-r repeats] [-o results.csv] [-p params.txt] [-t test_ratios.csv]
+ *                              [sensor_data.csv ...]
+ *
+ * Returns non zero if the outputs differ from the reference.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "EKF/ekf.h"
+#include "sensor_simulator/sensor_simulator.h"
+#include "sensor_simulator/ekf_wrapper.h"
+#include "sensor_simulator/ekf_logger.h"
+#include "sensor_simulator/ekf_replay.h"
+
+static std::atomic<uint64_t> heap_allocations{0};
+
+void *operator new(size_t size)
+{
+	heap_allocations++;
+	void *ptr = malloc(size);
+
+	if (ptr == nullptr) {
+		throw std::bad_alloc();
+	}
+
+	return ptr;
+}
+
+void operator delete(void *ptr) noexcept
+{
+	free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+	free(ptr);
+}
+
+namespace
+{
+
+struct Scenario {
+	std::string name;
+	std::string sensor_data_file;
+	std::string reference_file; // empty: no equivalence check
+	float duration_s;           // 0: until the end of the sensor data
+	float gps_innov_gate;       // 0: parameter default
+};
+
+// index 0: updates without fusion, index i + 1: updates fusing ekf_aid_sources[i]
+struct UpdateTimes {
+	uint64_t count[num_ekf_aid_sources + 1] {};
+	uint64_t total_ns[num_ekf_aid_sources + 1] {};
+	uint64_t updates{0};
+	uint64_t updates_total_ns{0};
+	uint64_t replayed_us{0};
+};
+
+// the GNSS innovation gate of the scenario, then the parameters given on the command line
+std::vector<EkfParameterValue> scenarioParameters(const Scenario &scenario,
+		const std::vector<EkfParameterValue> &params)
+{
+	std::vector<EkfParameterValue> scenario_params;
+
+	if (scenario.gps_innov_gate > 0.f) {
+		scenario_params.push_back({findEkfParameter("EKF2_GPS_V_GATE"), scenario.gps_innov_gate});
+		scenario_params.push_back({findEkfParameter("EKF2_GPS_P_GATE"), scenario.gps_innov_gate});
+	}
+
+	scenario_params.insert(scenario_params.end(), params.begin(), params.end());
+	return scenario_params;
+}
+
+void runTimed(const Scenario &scenario, const std::vector<EkfParameterValue> &params, UpdateTimes &times,
+	      TestRatios (&test_ratios)[num_ekf_aid_sources], uint64_t &allocations)
+{
+	EkfReplay replay(scenario.sensor_data_file, scenarioParameters(scenario, params), scenario.duration_s);
+
+	uint64_t time_last_fuse[num_ekf_aid_sources] {};
+	uint64_t timestamp_sample[num_ekf_aid_sources] {};
+
+	// Ekf::update() only is timed, not the callback
+	replay.sensor_simulator.setUpdateCallback([&](uint64_t elapsed_ns) {
+		bool fused = false;
+
+		for (unsigned i = 0; i < num_ekf_aid_sources; i++) {
+			const AidSourceStatus status = ekf_aid_sources[i].status(*replay.ekf);
+
+			if (status.time_last_fuse != time_last_fuse[i]) {
+				time_last_fuse[i] = status.time_last_fuse;
+				times.count[i + 1]++;
+				times.total_ns[i + 1] += elapsed_ns;
+				fused = true;
+			}
+
+			// a new sample was processed (fused or rejected), once the aid source is in use
+			if (status.timestamp_sample != timestamp_sample[i]) {
+				timestamp_sample[i] = status.timestamp_sample;
+
+				if ((status.time_last_fuse != 0) && std::isfinite(status.test_ratio)) {
+					test_ratios[i].update(status.test_ratio);
+				}
+			}
+		}
+
+		if (!fused) {
+			times.count[0]++;
+			times.total_ns[0] += elapsed_ns;
+		}
+
+		times.updates++;
+		times.updates_total_ns += elapsed_ns;
+	});
+
+	const uint64_t allocations_start = heap_allocations;
+
+	replay.run();
+
+	times.replayed_us = replay.end_time_us;
+	allocations = heap_allocations - allocations_start;
+}
+
+bool equalWithinLoggedPrecision(const std::string &output, const std::string &reference)
+{
+	if (output == reference) {
+		return true;
+	}
+
+	// the states and variances are logged with 2 significant digits: allow one unit of the last digit,
+	// and an absolute tolerance for values that are zero up to float rounding (e.g. 0 and -8e-07)
+	const double a = strtod(output.c_str(), nullptr);
+	const double b = strtod(reference.c_str(), nullptr);
+
+	return fabs(a - b) <= fmax(0.1 * fmax(fabs(a), fabs(b)), 1e-5);
+}
+
+bool compareWithReference(const std::string &output_file, const std::string &reference_file)
+{
+	std::ifstream output(output_file);
+	std::ifstream reference(reference_file);
+
+	if (!output || !reference) {
+		printf("can not open %s or %s\n", output_file.c_str(), reference_file.c_str());
+		return false;
+	}
+
+	std::string output_line;
+	std::string reference_line;
+	unsigned line = 0;
+	unsigned mismatches = 0;
+
+	while (std::getline(reference, reference_line)) {
+		line++;
+
+		if (!std::getline(output, output_line)) {
+			printf("%s: output ends at line %u\n", output_file.c_str(), line);
+			return false;
+		}
+
+		std::stringstream output_ss(output_line);
+		std::stringstream reference_ss(reference_line);
+		std::string output_value;
+		std::string reference_value;
+		unsigned column = 0;
+
+		while (std::getline(reference_ss, reference_value, ',')) {
+			if (!std::getline(output_ss, output_value, ',')
+			    || ((line == 1 || column == 0) && (output_value != reference_value))
+			    || !equalWithinLoggedPrecision(output_value, reference_value)) {
+
+				if (mismatches == 0) {
+					printf("%s:%u column %u: %s, reference %s\n", output_file.c_str(), line, column,
+					       output_value.c_str(), reference_value.c_str());
+				}
+
+				mismatches++;
+			}
+
+			column++;
+		}
+	}
+
+	if (mismatches > 0) {
+		printf("%s: %u values differ from %s\n", output_file.c_str(), mismatches, reference_file.c_str());
+	}
+
+	return mismatches == 0;
+}
+
+bool checkEquivalence(const Scenario &scenario)
+{
+	const std::string output_file = "ekf2_replay_benchmark_" + scenario.name + ".csv";
+
+	{
+		EkfReplay replay(scenario.sensor_data_file, scenarioParameters(scenario, {}), scenario.duration_s);
+		EkfLogger ekf_logger(replay.ekf);
+		ekf_logger.setFilePath(output_file);
+
+		// logged at 10 Hz as the change indication
+		const int samples = (int)(replay.end_time_us / 100000);
+
+		for (int i = 0; i < samples; ++i) {
+			replay.sensor_simulator.runReplaySeconds(0.1f);
+			ekf_logger.writeStateToFile();
+		}
+	}
+
+	return compareWithReference(output_file, scenario.reference_file);
+}
+
+void printUsage()
+{
+	printf("usage: ekf2_replay_benchmark [-r repeats] [-o results.csv] [-p params.txt] [-t test_ratios.csv]"
+	       " [sensor_data.csv ...]\n");
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+	int repeats = 3;
+	const char *results_file = nullptr;
+	const char *test_ratios_file = nullptr;
+	std::vector<EkfParameterValue> params;
+	std::vector<Scenario> scenarios;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+			repeats = std::max(atoi(argv[++i]), 1);
+
+		} else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+			results_file = argv[++i];
+
+		} else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc) {
+			if (!loadEkfParameters(argv[++i], params)) {
+				return 1;
+			}
+
+		} else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+			test_ratios_file = argv[++i];
+
+		} else if (argv[i][0] == '-') {
+			printUsage();
+			return 1;
+
+		} else {
+			std::string name = argv[i];
+			name = name.substr(name.find_last_of('/') + 1);
+			name = name.substr(0, name.find_last_of('.'));
+			scenarios.push_back({name, argv[i], "", 0.f, 0.f});
+		}
+	}
+
+	if (scenarios.empty()) {
+		scenarios = {
+			{"iris_gps", TEST_DATA_PATH"/replay_data/iris_gps.csv", TEST_DATA_PATH"/change_indication/iris_gps.csv", 35.f, 0.f},
+			{"ekf_gsf_reset", TEST_DATA_PATH"/replay_data/ekf_gsf_reset.csv", TEST_DATA_PATH"/change_indication/ekf_gsf_reset.csv", 39.f, 1.f},
+		};
+	}
+
+	FILE *results = nullptr;
+
+	if (results_file) {
+		results = fopen(results_file, "w");
+
+		if (results == nullptr) {
+			printf("can not open %s\n", results_file);
+			return 1;
+		}
+
+		fprintf(results, "scenario,fusion,updates,ns_per_update\n");
+	}
+
+	FILE *test_ratios_out = nullptr;
+
+	if (test_ratios_file) {
+		test_ratios_out = fopen(test_ratios_file, "w");
+
+		if (test_ratios_out == nullptr) {
+			printf("can not open %s\n", test_ratios_file);
+			return 1;
+		}
+
+		fprintf(test_ratios_out, "scenario,aid_source,samples,mean,max,fraction_above_1\n");
+	}
+
+	bool equivalent = true;
+
+	for (const Scenario &scenario : scenarios) {
+		if (!scenario.reference_file.empty()) {
+			const bool scenario_equivalent = checkEquivalence(scenario);
+			printf("%s: output %s reference\n", scenario.name.c_str(), scenario_equivalent ? "matches" : "DIFFERS FROM");
+			equivalent = equivalent && scenario_equivalent;
+		}
+
+		// keep the fastest repeat for each fusion type
+		UpdateTimes best{};
+		uint64_t allocations = 0;
+		TestRatios test_ratios[num_ekf_aid_sources] {}; // the same for every repeat
+
+		for (int r = 0; r < repeats; r++) {
+			UpdateTimes times{};
+			std::fill(std::begin(test_ratios), std::end(test_ratios), TestRatios{});
+			runTimed(scenario, params, times, test_ratios, allocations);
+
+			for (unsigned i = 0; i < num_ekf_aid_sources + 1; i++) {
+				if (r == 0 || times.total_ns[i] < best.total_ns[i]) {
+					best.count[i] = times.count[i];
+					best.total_ns[i] = times.total_ns[i];
+				}
+			}
+
+			if (r == 0 || times.updates_total_ns < best.updates_total_ns) {
+				best.updates = times.updates;
+				best.updates_total_ns = times.updates_total_ns;
+			}
+
+			best.replayed_us = times.replayed_us;
+		}
+
+		printf("%s: %llu updates, %.1f ns/update, %.0fx real time, %llu heap allocations\n", scenario.name.c_str(),
+		       (unsigned long long)best.updates, (double)best.updates_total_ns / std::max(best.updates, (uint64_t)1),
+		       (double)best.replayed_us * 1e3 / std::max(best.updates_total_ns, (uint64_t)1),
+		       (unsigned long long)allocations);
+
+		for (unsigned i = 0; i < num_ekf_aid_sources + 1; i++) {
+			if (best.count[i] == 0) {
+				continue;
+			}
+
+			const char *name = (i == 0) ? "predict" : ekf_aid_sources[i - 1].name;
+			const double ns_per_update = (double)best.total_ns[i] / best.count[i];
+
+			printf("  %-14s %8llu updates %10.1f ns/update\n", name, (unsigned long long)best.count[i], ns_per_update);
+
+			if (results) {
+				fprintf(results, "%s,%s,%llu,%.1f\n", scenario.name.c_str(), name, (unsigned long long)best.count[i],
+					ns_per_update);
+			}
+		}
+
+		if (test_ratios_out) {
+			for (unsigned i = 0; i < num_ekf_aid_sources; i++) {
+				const TestRatios &ratios = test_ratios[i];
+
+				// aid sources that are not in use keep a test ratio of 0
+				if ((ratios.samples == 0) || !(ratios.max > 0.f)) {
+					continue;
+				}
+
+				fprintf(test_ratios_out, "%s,%s,%llu,%.4f,%.4f,%.4f\n", scenario.name.c_str(),
+					ekf_aid_sources[i].name, (unsigned long long)ratios.samples, ratios.sum / ratios.samples,
+					(double)ratios.max, (double)ratios.above_1 / ratios.samples);
+			}
+		}
+	}
+
+	if (results) {
+		fclose(results);
+	}
+
+	if (test_ratios_out) {
+		fclose(test_ratios_out);
+	}
+
+	return equivalent ? 0 : 1;
+}
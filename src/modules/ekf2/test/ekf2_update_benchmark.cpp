@@ -0,0 +1,146 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * Timing of the EKF update cycle and of the dense and sparse measurement updates, run with the
+ * sensor simulator (IMU, baro, mag, GNSS and range finder). Not part of the unit tests, the
+ * equivalence of the dense and sparse updates is tested in test_EKF_measurementUpdate.
+ *
+ * Usage: ekf2_update_benchmark [repeats]
+ *
+ * The best of the repeats is reported.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+
+#include "EKF/ekf.h"
+#include "sensor_simulator/sensor_simulator.h"
+#include "sensor_simulator/ekf_wrapper.h"
+
+using namespace std::chrono;
+
+// filter fusing GNSS and range finder data, past the initial alignment
+struct Filter {
+	Filter() :
+		ekf{std::make_shared<Ekf>()},
+		sensor_simulator(ekf),
+		ekf_wrapper(ekf)
+	{
+		ekf->init(0);
+		sensor_simulator.runSeconds(0.1);
+		ekf->set_in_air_status(false);
+		ekf->set_vehicle_at_rest(true);
+
+		sensor_simulator.runSeconds(2);
+		ekf_wrapper.enableGpsFusion();
+		ekf_wrapper.enableRangeHeightFusion();
+		sensor_simulator.startGps();
+		sensor_simulator.startRangeFinder();
+		sensor_simulator.runSeconds(11);
+	}
+
+	std::shared_ptr<Ekf> ekf;
+	SensorSimulator sensor_simulator;
+	EkfWrapper ekf_wrapper;
+};
+
+// average wall clock time per filter update (200 Hz IMU, includes the simulator overhead) [ns]
+static double updateCycleTime()
+{
+	Filter filter;
+
+	constexpr float duration_s = 60.f;
+	const auto start = steady_clock::now();
+	filter.sensor_simulator.runSeconds(duration_s);
+	const auto elapsed = duration_cast<nanoseconds>(steady_clock::now() - start);
+
+	return (double)elapsed.count() / (duration_s * 200.f);
+}
+
+// average time of a measurement update with a range finder like observation Jacobian [ns]
+template <typename Jacobian>
+static double measurementUpdateTime(const Jacobian &H)
+{
+	Filter filter;
+	Ekf &ekf = *filter.ekf;
+
+	constexpr int updates = 20000;
+	constexpr float R = 0.01f;
+
+	const auto start = steady_clock::now();
+
+	for (int i = 0; i < updates; i++) {
+		const float innovation = 0.001f * ((i % 7) - 3);
+		Ekf::VectorState K = ekf.covariances() * H / (H.dot(ekf.covariances() * H) + R);
+		ekf.measurementUpdate(K, H, R, innovation);
+	}
+
+	const auto elapsed = duration_cast<nanoseconds>(steady_clock::now() - start);
+
+	return (double)elapsed.count() / updates;
+}
+
+int main(int argc, char *argv[])
+{
+	const int repeats = (argc > 1) ? std::max(atoi(argv[1]), 1) : 5;
+
+	// vertical position and terrain
+	constexpr int pos_z = State::pos.idx + 2;
+	constexpr int terrain = State::terrain.idx;
+
+	Ekf::VectorState H_dense;
+	H_dense(pos_z) = -1.f;
+	H_dense(terrain) = 1.f;
+	const Ekf::SparseVectorState<pos_z, terrain> H_sparse(H_dense);
+
+	double cycle = 1e12;
+	double dense = 1e12;
+	double sparse = 1e12;
+
+	for (int i = 0; i < repeats; i++) {
+		cycle = std::min(cycle, updateCycleTime());
+		dense = std::min(dense, measurementUpdateTime(H_dense));
+		sparse = std::min(sparse, measurementUpdateTime(H_sparse));
+	}
+
+	printf("EKF update cycle: %.1f ns\n", cycle);
+	printf("measurement update: dense %.1f ns, sparse %.1f ns (%.1f%% reduction)\n", dense, sparse,
+	       100.0 * (1.0 - sparse / dense));
+
+	return 0;
+}
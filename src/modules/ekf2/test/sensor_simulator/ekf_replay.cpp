@@ -0,0 +1,303 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "ekf_replay.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <utility>
+
+namespace
+{
+
+// the mapping of the ekf2 module (EKF2.cpp), applied to the parameters of the EKF
+#define EKF_PARAMETER(name, field) {name, \
+		std::is_integral_v<std::remove_reference_t<decltype(std::declval<parameters &>().field)>>, \
+		[](Ekf & ekf, float value) { \
+			auto &param = ekf.getParamHandle()->field; \
+			param = static_cast<std::remove_reference_t<decltype(param)>>(value); \
+		}}
+
+// also given to the output predictor, as EKF2::Run() does
+#define IMU_POS_PARAMETER(name, axis) {name, false, [](Ekf & ekf, float value) { \
+			ekf.getParamHandle()->imu_pos_body(axis) = value; \
+			ekf.output_predictor().set_imu_offset(ekf.getParamHandle()->imu_pos_body); \
+		}}
+
+const EkfParameter ekf_parameters[] = {
+	EKF_PARAMETER("EKF2_PREDICT_US", filter_update_interval_us),
+	EKF_PARAMETER("EKF2_DELAY_MAX", delay_max_ms),
+	EKF_PARAMETER("EKF2_IMU_CTRL", imu_ctrl),
+	EKF_PARAMETER("EKF2_VEL_LIM", velocity_limit),
+#if defined(CONFIG_EKF2_AUXVEL)
+	EKF_PARAMETER("EKF2_AVEL_DELAY", auxvel_delay_ms),
+#endif // CONFIG_EKF2_AUXVEL
+	EKF_PARAMETER("EKF2_GYR_NOISE", gyro_noise),
+	EKF_PARAMETER("EKF2_ACC_NOISE", accel_noise),
+	EKF_PARAMETER("EKF2_GYR_B_NOISE", gyro_bias_p_noise),
+	EKF_PARAMETER("EKF2_ACC_B_NOISE", accel_bias_p_noise),
+#if defined(CONFIG_EKF2_WIND)
+	EKF_PARAMETER("EKF2_WIND_NSD", wind_vel_nsd),
+#endif // CONFIG_EKF2_WIND
+	EKF_PARAMETER("EKF2_NOAID_NOISE", pos_noaid_noise),
+#if defined(CONFIG_EKF2_GNSS)
+	EKF_PARAMETER("EKF2_GPS_CTRL", gnss_ctrl),
+	EKF_PARAMETER("EKF2_GPS_DELAY", gps_delay_ms),
+	EKF_PARAMETER("EKF2_GPS_POS_X", gps_pos_body(0)),
+	EKF_PARAMETER("EKF2_GPS_POS_Y", gps_pos_body(1)),
+	EKF_PARAMETER("EKF2_GPS_POS_Z", gps_pos_body(2)),
+	EKF_PARAMETER("EKF2_GPS_V_NOISE", gps_vel_noise),
+	EKF_PARAMETER("EKF2_GPS_P_NOISE", gps_pos_noise),
+	EKF_PARAMETER("EKF2_GPS_P_GATE", gps_pos_innov_gate),
+	EKF_PARAMETER("EKF2_GPS_V_GATE", gps_vel_innov_gate),
+	EKF_PARAMETER("EKF2_GPS_CHECK", gps_check_mask),
+	EKF_PARAMETER("EKF2_REQ_EPH", req_hacc),
+	EKF_PARAMETER("EKF2_REQ_EPV", req_vacc),
+	EKF_PARAMETER("EKF2_REQ_SACC", req_sacc),
+	EKF_PARAMETER("EKF2_REQ_NSATS", req_nsats),
+	EKF_PARAMETER("EKF2_REQ_PDOP", req_pdop),
+	EKF_PARAMETER("EKF2_REQ_HDRIFT", req_hdrift),
+	EKF_PARAMETER("EKF2_REQ_VDRIFT", req_vdrift),
+	EKF_PARAMETER("EKF2_GSF_TAS", EKFGSF_tas_default),
+	{"EKF2_REQ_GPS_H", false, [](Ekf & ekf, float value) { ekf.set_min_required_gps_health_time(value * 1e6f); }},
+#endif // CONFIG_EKF2_GNSS
+#if defined(CONFIG_EKF2_BAROMETER)
+	EKF_PARAMETER("EKF2_BARO_CTRL", baro_ctrl),
+	EKF_PARAMETER("EKF2_BARO_DELAY", baro_delay_ms),
+	EKF_PARAMETER("EKF2_BARO_NOISE", baro_noise),
+	EKF_PARAMETER("EKF2_BARO_GATE", baro_innov_gate),
+	EKF_PARAMETER("EKF2_GND_EFF_DZ", gnd_effect_deadzone),
+	EKF_PARAMETER("EKF2_GND_MAX_HGT", gnd_effect_max_hgt),
+# if defined(CONFIG_EKF2_BARO_COMPENSATION)
+	EKF_PARAMETER("EKF2_ASPD_MAX", max_correction_airspeed),
+	EKF_PARAMETER("EKF2_PCOEF_XP", static_pressure_coef_xp),
+	EKF_PARAMETER("EKF2_PCOEF_XN", static_pressure_coef_xn),
+	EKF_PARAMETER("EKF2_PCOEF_YP", static_pressure_coef_yp),
+	EKF_PARAMETER("EKF2_PCOEF_YN", static_pressure_coef_yn),
+	EKF_PARAMETER("EKF2_PCOEF_Z", static_pressure_coef_z),
+# endif // CONFIG_EKF2_BARO_COMPENSATION
+#endif // CONFIG_EKF2_BAROMETER
+#if defined(CONFIG_EKF2_AIRSPEED)
+	EKF_PARAMETER("EKF2_ASP_DELAY", airspeed_delay_ms),
+	EKF_PARAMETER("EKF2_TAS_GATE", tas_innov_gate),
+	EKF_PARAMETER("EKF2_EAS_NOISE", eas_noise),
+	EKF_PARAMETER("EKF2_ARSP_THR", arsp_thr),
+#endif // CONFIG_EKF2_AIRSPEED
+#if defined(CONFIG_EKF2_SIDESLIP)
+	EKF_PARAMETER("EKF2_BETA_GATE", beta_innov_gate),
+	EKF_PARAMETER("EKF2_BETA_NOISE", beta_noise),
+	EKF_PARAMETER("EKF2_FUSE_BETA", beta_fusion_enabled),
+#endif // CONFIG_EKF2_SIDESLIP
+#if defined(CONFIG_EKF2_MAGNETOMETER)
+	EKF_PARAMETER("EKF2_MAG_DELAY", mag_delay_ms),
+	EKF_PARAMETER("EKF2_MAG_E_NOISE", mage_p_noise),
+	EKF_PARAMETER("EKF2_MAG_B_NOISE", magb_p_noise),
+	EKF_PARAMETER("EKF2_HEAD_NOISE", mag_heading_noise),
+	EKF_PARAMETER("EKF2_MAG_NOISE", mag_noise),
+	EKF_PARAMETER("EKF2_MAG_DECL", mag_declination_deg),
+	EKF_PARAMETER("EKF2_HDG_GATE", heading_innov_gate),
+	EKF_PARAMETER("EKF2_MAG_GATE", mag_innov_gate),
+	EKF_PARAMETER("EKF2_DECL_TYPE", mag_declination_source),
+	EKF_PARAMETER("EKF2_MAG_TYPE", mag_fusion_type),
+	EKF_PARAMETER("EKF2_MAG_ACCLIM", mag_acc_gate),
+	EKF_PARAMETER("EKF2_MAG_CHECK", mag_check),
+	EKF_PARAMETER("EKF2_MAG_CHK_STR", mag_check_strength_tolerance_gs),
+	EKF_PARAMETER("EKF2_MAG_CHK_INC", mag_check_inclination_tolerance_deg),
+	EKF_PARAMETER("EKF2_SYNT_MAG_Z", synthesize_mag_z),
+#endif // CONFIG_EKF2_MAGNETOMETER
+	EKF_PARAMETER("EKF2_HGT_REF", height_sensor_ref),
+	EKF_PARAMETER("EKF2_NOAID_TOUT", valid_timeout_max),
+#if defined(CONFIG_EKF2_TERRAIN) || defined(CONFIG_EKF2_OPTICAL_FLOW) || defined(CONFIG_EKF2_RANGE_FINDER)
+	EKF_PARAMETER("EKF2_MIN_RNG", rng_gnd_clearance),
+#endif // CONFIG_EKF2_TERRAIN || CONFIG_EKF2_OPTICAL_FLOW || CONFIG_EKF2_RANGE_FINDER
+#if defined(CONFIG_EKF2_TERRAIN)
+	EKF_PARAMETER("EKF2_TERR_NOISE", terrain_p_noise),
+	EKF_PARAMETER("EKF2_TERR_GRAD", terrain_gradient),
+#endif // CONFIG_EKF2_TERRAIN
+#if defined(CONFIG_EKF2_RANGE_FINDER)
+	EKF_PARAMETER("EKF2_RNG_CTRL", rng_ctrl),
+	EKF_PARAMETER("EKF2_RNG_DELAY", range_delay_ms),
+	EKF_PARAMETER("EKF2_RNG_NOISE", range_noise),
+	EKF_PARAMETER("EKF2_RNG_SFE", range_noise_scaler),
+	EKF_PARAMETER("EKF2_RNG_GATE", range_innov_gate),
+	EKF_PARAMETER("EKF2_RNG_PITCH", rng_sens_pitch),
+	EKF_PARAMETER("EKF2_RNG_A_VMAX", max_vel_for_range_aid),
+	EKF_PARAMETER("EKF2_RNG_A_HMAX", max_hagl_for_range_aid),
+	EKF_PARAMETER("EKF2_RNG_A_IGATE", range_aid_innov_gate),
+	EKF_PARAMETER("EKF2_RNG_QLTY_T", range_valid_quality_s),
+	EKF_PARAMETER("EKF2_RNG_K_GATE", range_kin_consistency_gate),
+	EKF_PARAMETER("EKF2_RNG_FOG", rng_fog),
+	EKF_PARAMETER("EKF2_RNG_POS_X", rng_pos_body(0)),
+	EKF_PARAMETER("EKF2_RNG_POS_Y", rng_pos_body(1)),
+	EKF_PARAMETER("EKF2_RNG_POS_Z", rng_pos_body(2)),
+#endif // CONFIG_EKF2_RANGE_FINDER
+#if defined(CONFIG_EKF2_EXTERNAL_VISION)
+	EKF_PARAMETER("EKF2_EV_DELAY", ev_delay_ms),
+	EKF_PARAMETER("EKF2_EV_CTRL", ev_ctrl),
+	EKF_PARAMETER("EKF2_EV_QMIN", ev_quality_minimum),
+	EKF_PARAMETER("EKF2_EVP_NOISE", ev_pos_noise),
+	EKF_PARAMETER("EKF2_EVV_NOISE", ev_vel_noise),
+	EKF_PARAMETER("EKF2_EVA_NOISE", ev_att_noise),
+	EKF_PARAMETER("EKF2_EVV_GATE", ev_vel_innov_gate),
+	EKF_PARAMETER("EKF2_EVP_GATE", ev_pos_innov_gate),
+	EKF_PARAMETER("EKF2_EV_POS_X", ev_pos_body(0)),
+	EKF_PARAMETER("EKF2_EV_POS_Y", ev_pos_body(1)),
+	EKF_PARAMETER("EKF2_EV_POS_Z", ev_pos_body(2)),
+#endif // CONFIG_EKF2_EXTERNAL_VISION
+#if defined(CONFIG_EKF2_OPTICAL_FLOW)
+	EKF_PARAMETER("EKF2_OF_CTRL", flow_ctrl),
+	EKF_PARAMETER("EKF2_OF_GYR_SRC", flow_gyro_src),
+	EKF_PARAMETER("EKF2_OF_DELAY", flow_delay_ms),
+	EKF_PARAMETER("EKF2_OF_N_MIN", flow_noise),
+	EKF_PARAMETER("EKF2_OF_N_MAX", flow_noise_qual_min),
+	EKF_PARAMETER("EKF2_OF_QMIN", flow_qual_min),
+	EKF_PARAMETER("EKF2_OF_QMIN_GND", flow_qual_min_gnd),
+	EKF_PARAMETER("EKF2_OF_GATE", flow_innov_gate),
+	EKF_PARAMETER("EKF2_OF_POS_X", flow_pos_body(0)),
+	EKF_PARAMETER("EKF2_OF_POS_Y", flow_pos_body(1)),
+	EKF_PARAMETER("EKF2_OF_POS_Z", flow_pos_body(2)),
+#endif // CONFIG_EKF2_OPTICAL_FLOW
+#if defined(CONFIG_EKF2_DRAG_FUSION)
+	EKF_PARAMETER("EKF2_DRAG_CTRL", drag_ctrl),
+	EKF_PARAMETER("EKF2_DRAG_NOISE", drag_noise),
+	EKF_PARAMETER("EKF2_BCOEF_X", bcoef_x),
+	EKF_PARAMETER("EKF2_BCOEF_Y", bcoef_y),
+	EKF_PARAMETER("EKF2_MCOEF", mcoef),
+#endif // CONFIG_EKF2_DRAG_FUSION
+#if defined(CONFIG_EKF2_GRAVITY_FUSION)
+	EKF_PARAMETER("EKF2_GRAV_NOISE", gravity_noise),
+#endif // CONFIG_EKF2_GRAVITY_FUSION
+	IMU_POS_PARAMETER("EKF2_IMU_POS_X", 0),
+	IMU_POS_PARAMETER("EKF2_IMU_POS_Y", 1),
+	IMU_POS_PARAMETER("EKF2_IMU_POS_Z", 2),
+	EKF_PARAMETER("EKF2_GBIAS_INIT", switch_on_gyro_bias),
+	EKF_PARAMETER("EKF2_ABIAS_INIT", switch_on_accel_bias),
+	EKF_PARAMETER("EKF2_ANGERR_INIT", initial_tilt_err),
+	EKF_PARAMETER("EKF2_ABL_LIM", acc_bias_lim),
+	EKF_PARAMETER("EKF2_ABL_ACCLIM", acc_bias_learn_acc_lim),
+	EKF_PARAMETER("EKF2_ABL_GYRLIM", acc_bias_learn_gyr_lim),
+	EKF_PARAMETER("EKF2_ABL_TAU", acc_bias_learn_tc),
+	EKF_PARAMETER("EKF2_GYR_B_LIM", gyro_bias_lim),
+	{"EKF2_TAU_POS", false, [](Ekf & ekf, float value) { ekf.output_predictor().set_pos_correction_tc(value); }},
+	{"EKF2_TAU_VEL", false, [](Ekf & ekf, float value) { ekf.output_predictor().set_vel_correction_tc(value); }},
+};
+
+#undef EKF_PARAMETER
+#undef IMU_POS_PARAMETER
+
+} // namespace
+
+const EkfParameter *findEkfParameter(const std::string &name)
+{
+	for (const EkfParameter &parameter : ekf_parameters) {
+		if (name == parameter.name) {
+			return &parameter;
+		}
+	}
+
+	return nullptr;
+}
+
+bool loadEkfParameters(const std::string &file_name, std::vector<EkfParameterValue> &params)
+{
+	std::ifstream file(file_name);
+
+	if (!file) {
+		printf("can not open %s\n", file_name.c_str());
+		return false;
+	}
+
+	std::string line;
+
+	while (std::getline(file, line)) {
+		std::stringstream ss(line);
+		std::string name;
+		float value = 0.f;
+
+		if (!(ss >> name) || (name[0] == '#')) {
+			continue;
+		}
+
+		if (!(ss >> value)) {
+			printf("%s: no value for %s\n", file_name.c_str(), name.c_str());
+			return false;
+		}
+
+		const EkfParameter *parameter = findEkfParameter(name);
+
+		if (parameter == nullptr) {
+			printf("%s: %s ignored (ekf2 module parameter)\n", file_name.c_str(), name.c_str());
+			continue;
+		}
+
+		auto param = std::find_if(params.begin(), params.end(), [parameter](const EkfParameterValue & param_value) {
+			return param_value.parameter == parameter;
+		});
+
+		if (param != params.end()) {
+			param->value = value;
+
+		} else {
+			params.push_back({parameter, value});
+		}
+	}
+
+	return true;
+}
+
+EkfReplay::EkfReplay(const std::string &sensor_data_file, const std::vector<EkfParameterValue> &params,
+		     float duration_s):
+	ekf{std::make_shared<Ekf>()},
+	sensor_simulator(ekf),
+	ekf_wrapper(ekf)
+{
+	sensor_simulator.loadSensorDataFromFile(sensor_data_file);
+
+	sensor_simulator.startGps();
+	ekf_wrapper.enableGpsFusion();
+
+	for (const EkfParameterValue &param : params) {
+		param.parameter->set(*ekf, param.value);
+	}
+
+	end_time_us = (duration_s > 0.f) ? (uint64_t)(duration_s * 1e6f) : sensor_simulator.getReplayEndTime();
+}
+
+void EkfReplay::run()
+{
+	while (sensor_simulator.getTime() < end_time_us) {
+		const uint64_t remaining_us = end_time_us - sensor_simulator.getTime();
+		sensor_simulator.runReplayMicroseconds((uint32_t)std::min(remaining_us, (uint64_t)1000000));
+	}
+}
@@ -0,0 +1,178 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * Offline replay of a sensor data file through the EKF, with the EKF2 parameters applied
+ * to the filter as the ekf2 module does, and the innovation test ratios of the aid sources.
+ * Shared by ekf2_replay_benchmark and ekf2_batch_replay.
+ */
+#ifndef EKF_EKF_REPLAY_H
+#define EKF_EKF_REPLAY_H
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "EKF/ekf.h"
+#include "sensor_simulator.h"
+#include "ekf_wrapper.h"
+
+// EKF2 parameter of the EKF library
+struct EkfParameter {
+	const char *name;
+	bool is_int;
+	void (*set)(Ekf &ekf, float value);
+};
+
+struct EkfParameterValue {
+	const EkfParameter *parameter;
+	float value;
+};
+
+// returns nullptr for the parameters of the ekf2 module only (instances, selector, logging, uORB inputs)
+const EkfParameter *findEkfParameter(const std::string &name);
+
+// reads "<param_name> <value>" lines (replay_params.txt format), a parameter given again replaces the previous value
+bool loadEkfParameters(const std::string &file_name, std::vector<EkfParameterValue> &params);
+
+struct AidSourceStatus {
+	uint64_t time_last_fuse;
+	uint64_t timestamp_sample;
+	float test_ratio; // largest of the axes
+};
+
+template<typename AidSource>
+AidSourceStatus aidSourceStatus(const AidSource &aid_src)
+{
+	float test_ratio = 0.f;
+
+	if constexpr(std::is_array_v<decltype(aid_src.test_ratio)>) {
+		for (const float axis_test_ratio : aid_src.test_ratio) {
+			test_ratio = std::max(test_ratio, axis_test_ratio);
+		}
+
+	} else {
+		test_ratio = aid_src.test_ratio;
+	}
+
+	return {aid_src.time_last_fuse, aid_src.timestamp_sample, test_ratio};
+}
+
+struct EkfAidSource {
+	const char *name;
+	AidSourceStatus (*status)(const Ekf &ekf);
+};
+
+inline const EkfAidSource ekf_aid_sources[] = {
+#if defined(CONFIG_EKF2_BAROMETER)
+	{"baro_hgt", [](const Ekf & ekf) { return aidSourceStatus(ekf.aid_src_baro_hgt()); }},
+#endif // CONFIG_EKF2_BAROMETER
+#if defined(CONFIG_EKF2_MAGNETOMETER)
+	{"mag", [](const Ekf & ekf) { return aidSourceStatus(ekf.aid_src_mag()); }},
+#endif // CONFIG_EKF2_MAGNETOMETER
+#if defined(CONFIG_EKF2_GNSS)
+	{"gnss_hgt", [](const Ekf & ekf) { return aidSourceStatus(ekf.aid_src_gnss_hgt()); }},
+	{"gnss_pos", [](const Ekf & ekf) { return aidSourceStatus(ekf.aid_src_gnss_pos()); }},
+	{"gnss_vel", [](const Ekf & ekf) { return aidSourceStatus(ekf.aid_src_gnss_vel()); }},
+# if defined(CONFIG_EKF2_GNSS_YAW)
+	{"gnss_yaw", [](const Ekf & ekf) { return aidSourceStatus(ekf.aid_src_gnss_yaw()); }},
+# endif // CONFIG_EKF2_GNSS_YAW
+#endif // CONFIG_EKF2_GNSS
+#if defined(CONFIG_EKF2_RANGE_FINDER)
+	{"rng_hgt", [](const Ekf & ekf) { return aidSourceStatus(ekf.aid_src_rng_hgt()); }},
+#endif // CONFIG_EKF2_RANGE_FINDER
+#if defined(CONFIG_EKF2_OPTICAL_FLOW)
+	{"optical_flow", [](const Ekf & ekf) { return aidSourceStatus(ekf.aid_src_optical_flow()); }},
+#endif // CONFIG_EKF2_OPTICAL_FLOW
+#if defined(CONFIG_EKF2_EXTERNAL_VISION)
+	{"ev_hgt", [](const Ekf & ekf) { return aidSourceStatus(ekf.aid_src_ev_hgt()); }},
+	{"ev_pos", [](const Ekf & ekf) { return aidSourceStatus(ekf.aid_src_ev_pos()); }},
+	{"ev_vel", [](const Ekf & ekf) { return aidSourceStatus(ekf.aid_src_ev_vel()); }},
+	{"ev_yaw", [](const Ekf & ekf) { return aidSourceStatus(ekf.aid_src_ev_yaw()); }},
+#endif // CONFIG_EKF2_EXTERNAL_VISION
+#if defined(CONFIG_EKF2_AIRSPEED)
+	{"airspeed", [](const Ekf & ekf) { return aidSourceStatus(ekf.aid_src_airspeed()); }},
+#endif // CONFIG_EKF2_AIRSPEED
+#if defined(CONFIG_EKF2_SIDESLIP)
+	{"sideslip", [](const Ekf & ekf) { return aidSourceStatus(ekf.aid_src_sideslip()); }},
+#endif // CONFIG_EKF2_SIDESLIP
+#if defined(CONFIG_EKF2_DRAG_FUSION)
+	{"drag", [](const Ekf & ekf) { return aidSourceStatus(ekf.aid_src_drag()); }},
+#endif // CONFIG_EKF2_DRAG_FUSION
+#if defined(CONFIG_EKF2_GRAVITY_FUSION)
+	{"gravity", [](const Ekf & ekf) { return aidSourceStatus(ekf.aid_src_gravity()); }},
+#endif // CONFIG_EKF2_GRAVITY_FUSION
+#if defined(CONFIG_EKF2_AUXVEL)
+	{"aux_vel", [](const Ekf & ekf) { return aidSourceStatus(ekf.aid_src_aux_vel()); }},
+#endif // CONFIG_EKF2_AUXVEL
+	{"fake_pos", [](const Ekf & ekf) { return aidSourceStatus(ekf.aid_src_fake_pos()); }},
+	{"fake_hgt", [](const Ekf & ekf) { return aidSourceStatus(ekf.aid_src_fake_hgt()); }},
+};
+
+constexpr unsigned num_ekf_aid_sources = sizeof(ekf_aid_sources) / sizeof(ekf_aid_sources[0]);
+
+// test ratio statistics of an aid source, over the samples it processed
+struct TestRatios {
+	uint64_t samples{0};
+	double sum{0.0};
+	float max{0.f};
+	uint64_t above_1{0};
+
+	void update(float test_ratio)
+	{
+		samples++;
+		sum += (double)test_ratio;
+		max = std::max(max, test_ratio);
+		above_1 += (test_ratio > 1.f) ? 1 : 0;
+	}
+};
+
+class EkfReplay
+{
+public:
+	// same configuration as test_EKF_withReplayData (GNSS fusion enabled), then the parameters in order
+	EkfReplay(const std::string &sensor_data_file, const std::vector<EkfParameterValue> &params = {},
+		  float duration_s = 0.f);
+
+	// runs the replay to its end, in steps of 1 s of sensor data
+	void run();
+
+	std::shared_ptr<Ekf> ekf;
+	SensorSimulator sensor_simulator;
+	EkfWrapper ekf_wrapper;
+	uint64_t end_time_us{0};
+};
+
+#endif // !EKF_EKF_REPLAY_H
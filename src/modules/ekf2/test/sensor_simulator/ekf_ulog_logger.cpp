@@ -0,0 +1,223 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "ekf_ulog_logger.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#include <logger/messages.h>
+
+namespace
+{
+
+// aid source i is logged with the message id i + 1
+constexpr uint16_t state_msg_id = 0;
+
+#pragma pack(push, 1)
+
+struct ulog_message_ekf_replay_state_s {
+	uint16_t msg_size = sizeof(ulog_message_ekf_replay_state_s) - ULOG_MSG_HEADER_LEN;
+	uint8_t msg_type = static_cast<uint8_t>(ULogMessageType::DATA);
+
+	uint16_t msg_id = state_msg_id;
+	uint64_t timestamp;
+	uint64_t control_status;
+	uint32_t fault_status;
+	float states[State::size];
+	float variances[State::size];
+};
+
+struct ulog_message_ekf_replay_aid_source_s {
+	uint16_t msg_size = sizeof(ulog_message_ekf_replay_aid_source_s) - ULOG_MSG_HEADER_LEN;
+	uint8_t msg_type = static_cast<uint8_t>(ULogMessageType::DATA);
+
+	uint16_t msg_id;
+	uint64_t timestamp;
+	uint64_t timestamp_sample;
+	float test_ratio; // largest of the axes
+	bool fused;
+};
+
+#pragma pack(pop)
+
+} // namespace
+
+EkfULogLogger::EkfULogLogger(std::shared_ptr<Ekf> ekf):
+	_ekf(ekf)
+{
+}
+
+bool EkfULogLogger::open(const std::string &file_path, const std::string &sensor_data_file,
+			 const std::vector<EkfParameterValue> &params)
+{
+	_file.open(file_path, std::ios::binary | std::ios::trunc);
+
+	if (!_file) {
+		return false;
+	}
+
+	ulog_file_header_s header{};
+	const uint8_t magic[] = {'U', 'L', 'o', 'g', 0x01, 0x12, 0x35, 0x01}; // file version 1
+	memcpy(header.magic, magic, sizeof(header.magic));
+	write(&header, sizeof(header));
+
+	ulog_message_flag_bits_s flag_bits{};
+	flag_bits.msg_size = sizeof(flag_bits) - ULOG_MSG_HEADER_LEN;
+	write(&flag_bits, sizeof(flag_bits));
+
+	writeInfo("sys_name", "EKF replay");
+	writeInfo("replay", sensor_data_file);
+
+	for (const EkfParameterValue &param : params) {
+		writeParameter(param);
+	}
+
+	char format[256];
+	snprintf(format, sizeof(format), "ekf_replay_state:uint64_t timestamp;uint64_t control_status;"
+		 "uint32_t fault_status;float[%u] states;float[%u] variances;", State::size, State::size);
+	writeFormat(format);
+
+	for (const EkfAidSource &aid_source : ekf_aid_sources) {
+		snprintf(format, sizeof(format), "ekf_replay_%s:uint64_t timestamp;uint64_t timestamp_sample;"
+			 "float test_ratio;bool fused;", aid_source.name);
+		writeFormat(format);
+	}
+
+	writeAddLogged(state_msg_id, "ekf_replay_state");
+
+	return _file.good();
+}
+
+void EkfULogLogger::update()
+{
+	const uint64_t time_us = _ekf->time_delayed_us();
+
+	if (time_us != _time_last_state_us) {
+		_time_last_state_us = time_us;
+
+		ulog_message_ekf_replay_state_s state{};
+		state.timestamp = time_us;
+		state.control_status = _ekf->control_status().value;
+		state.fault_status = _ekf->fault_status().value;
+		_ekf->state().vector().copyTo(state.states);
+		_ekf->covariances_diagonal().copyTo(state.variances);
+		write(&state, sizeof(state));
+	}
+
+	for (unsigned i = 0; i < num_ekf_aid_sources; i++) {
+		const AidSourceStatus status = ekf_aid_sources[i].status(*_ekf);
+
+		const bool fused = (status.time_last_fuse != _time_last_fuse[i]);
+		_time_last_fuse[i] = status.time_last_fuse;
+
+		if ((status.timestamp_sample == _timestamp_sample[i]) || (status.timestamp_sample == 0)) {
+			continue;
+		}
+
+		_timestamp_sample[i] = status.timestamp_sample;
+
+		// only the aid sources in use are logged
+		if (!_aid_source_logged[i]) {
+			char message_name[64];
+			snprintf(message_name, sizeof(message_name), "ekf_replay_%s", ekf_aid_sources[i].name);
+			writeAddLogged(i + 1, message_name);
+			_aid_source_logged[i] = true;
+		}
+
+		ulog_message_ekf_replay_aid_source_s aid_source{};
+		aid_source.msg_id = i + 1;
+		aid_source.timestamp = time_us;
+		aid_source.timestamp_sample = status.timestamp_sample;
+		aid_source.test_ratio = status.test_ratio;
+		aid_source.fused = fused;
+		write(&aid_source, sizeof(aid_source));
+	}
+}
+
+bool EkfULogLogger::close()
+{
+	_file.close();
+	return !_file.fail();
+}
+
+void EkfULogLogger::writeInfo(const char *key, const std::string &value)
+{
+	ulog_message_info_s info{};
+	const size_t value_len = std::min(value.length(), (size_t)200);
+	const int key_len = snprintf(info.key_value_str, sizeof(info.key_value_str), "char[%u] %s", (unsigned)value_len, key);
+	memcpy(&info.key_value_str[key_len], value.c_str(), value_len);
+	info.key_len = key_len;
+	info.msg_size = sizeof(info.key_len) + key_len + value_len;
+	write(&info, ULOG_MSG_HEADER_LEN + info.msg_size);
+}
+
+void EkfULogLogger::writeParameter(const EkfParameterValue &param)
+{
+	ulog_message_parameter_s parameter{};
+	const int key_len = snprintf(parameter.key_value_str, sizeof(parameter.key_value_str), "%s %s",
+				     param.parameter->is_int ? "int32_t" : "float", param.parameter->name);
+
+	if (param.parameter->is_int) {
+		const int32_t value = (int32_t)param.value;
+		memcpy(&parameter.key_value_str[key_len], &value, sizeof(value));
+
+	} else {
+		memcpy(&parameter.key_value_str[key_len], &param.value, sizeof(param.value));
+	}
+
+	parameter.key_len = key_len;
+	parameter.msg_size = sizeof(parameter.key_len) + key_len + 4;
+	write(&parameter, ULOG_MSG_HEADER_LEN + parameter.msg_size);
+}
+
+void EkfULogLogger::writeFormat(const char *format)
+{
+	ulog_message_format_s message{};
+	const size_t format_len = strlen(format);
+	memcpy(message.format, format, format_len);
+	message.msg_size = format_len;
+	write(&message, ULOG_MSG_HEADER_LEN + message.msg_size);
+}
+
+void EkfULogLogger::writeAddLogged(uint16_t msg_id, const char *message_name)
+{
+	ulog_message_add_logged_s message{};
+	const size_t name_len = strlen(message_name);
+	memcpy(message.message_name, message_name, name_len);
+	message.multi_id = 0;
+	message.msg_id = msg_id;
+	message.msg_size = sizeof(message.multi_id) + sizeof(message.msg_id) + name_len;
+	write(&message, ULOG_MSG_HEADER_LEN + message.msg_size);
+}
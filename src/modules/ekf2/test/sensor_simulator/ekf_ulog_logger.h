@@ -0,0 +1,80 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * Class to write the EKF states and the aid source samples of a replay to a ULog file,
+ * with the EKF2 parameters of the replay.
+ */
+#ifndef EKF_EKF_ULOG_LOGGER_H
+#define EKF_EKF_ULOG_LOGGER_H
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "EKF/ekf.h"
+#include "ekf_replay.h"
+
+class EkfULogLogger
+{
+public:
+	EkfULogLogger(std::shared_ptr<Ekf> ekf);
+	~EkfULogLogger() = default;
+
+	// writes the header, the message formats and the parameters, false if the file can not be opened
+	bool open(const std::string &file_path, const std::string &sensor_data_file,
+		  const std::vector<EkfParameterValue> &params);
+
+	// to call after each Ekf::update(): logs the states once per filter update, and each aid source sample processed
+	void update();
+
+	// false if a write failed
+	bool close();
+
+private:
+	void write(const void *data, size_t size) { _file.write(static_cast<const char *>(data), size); }
+	void writeInfo(const char *key, const std::string &value);
+	void writeParameter(const EkfParameterValue &param);
+	void writeFormat(const char *format);
+	void writeAddLogged(uint16_t msg_id, const char *message_name);
+
+	std::shared_ptr<Ekf> _ekf;
+	std::ofstream _file;
+
+	uint64_t _time_last_state_us{0};
+	uint64_t _time_last_fuse[num_ekf_aid_sources] {};
+	uint64_t _timestamp_sample[num_ekf_aid_sources] {};
+	bool _aid_source_logged[num_ekf_aid_sources] {};
+};
+#endif // !EKF_EKF_ULOG_LOGGER_H
@@ -1,5 +1,7 @@
 #include "sensor_simulator.h"
 
+#include <chrono>
+
 
 SensorSimulator::SensorSimulator(std::shared_ptr<Ekf> ekf):
 	_airspeed(ekf),
@@ -172,7 +174,7 @@ void SensorSimulator::runMicroseconds(uint32_t duration)
 			}
 
 			// Update at IMU rate
-			_ekf->update();
+			updateEkf();
 		}
 	}
 }
@@ -189,6 +191,19 @@ void SensorSimulator::updateSensors()
 	_airspeed.update(_time);
 }
 
+void SensorSimulator::updateEkf()
+{
+	if (_update_callback) {
+		const auto start = std::chrono::steady_clock::now();
+		_ekf->update();
+		const auto elapsed = std::chrono::steady_clock::now() - start;
+		_update_callback(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+
+	} else {
+		_ekf->update();
+	}
+}
+
 void SensorSimulator::runReplaySeconds(float duration_seconds)
 {
 	runReplayMicroseconds(uint32_t(duration_seconds * 1e6f));
@@ -215,7 +230,7 @@ void SensorSimulator::runReplayMicroseconds(uint32_t duration)
 				_ekf->set_vehicle_at_rest(false);
 			}
 
-			_ekf->update();
+			updateEkf();
 		}
 	}
 }
@@ -223,19 +238,11 @@ void SensorSimulator::runReplayMicroseconds(uint32_t duration)
 void SensorSimulator::setSensorDataFromReplayData()
 {
 	if (_replay_data.size() > 0) {
-		sensor_info sample = _replay_data[_current_replay_data_index];
-
-		while (sample.timestamp < _time) {
-			setSingleReplaySample(sample);
-
-			if (_current_replay_data_index < _replay_data.size()) {
-				_current_replay_data_index ++;
-
-			} else {
-				break;
-			}
-
-			sample = _replay_data[_current_replay_data_index];
+		// the last sample stays set once the end of the replay data is reached
+		while ((_current_replay_data_index < _replay_data.size())
+		       && (_replay_data[_current_replay_data_index].timestamp < _time)) {
+			setSingleReplaySample(_replay_data[_current_replay_data_index]);
+			_current_replay_data_index++;
 		}
 
 	} else {
@@ -342,7 +349,7 @@ void SensorSimulator::runTrajectoryMicroseconds(uint32_t duration)
 				_ekf->set_vehicle_at_rest(false);
 			}
 
-			_ekf->update();
+			updateEkf();
 		}
 	}
 }
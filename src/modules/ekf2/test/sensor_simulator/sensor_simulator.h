@@ -43,6 +43,7 @@
 #ifndef EKF_SENSOR_SIMULATOR_H
 #define EKF_SENSOR_SIMULATOR_H
 
+#include <functional>
 #include <memory>
 #include <fstream>
 #include <iostream>
@@ -118,6 +119,10 @@ public:
 	void setOrientation(const Dcmf &orientation) { _R_body_to_world = orientation; }
 
 	void loadSensorDataFromFile(std::string filename);
+	uint64_t getReplayEndTime() const { return _replay_data.empty() ? 0 : _replay_data.back().timestamp; }
+
+	// called after each filter update with the wall clock time spent in Ekf::update() (nanoseconds)
+	void setUpdateCallback(std::function<void(uint64_t)> callback) { _update_callback = callback; }
 
 	Airspeed    _airspeed;
 	Baro        _baro;
@@ -138,6 +143,7 @@ private:
 	void setSensorDataFromTrajectory();
 	void startBasicSensor();
 	void updateSensors();
+	void updateEkf();
 
 	std::shared_ptr<Ekf> _ekf{nullptr};
 
@@ -145,6 +151,8 @@ private:
 
 	bool _has_replay_data{false};
 
+	std::function<void(uint64_t)> _update_callback{};
+
 	uint64_t _current_replay_data_index{0};
 	uint64_t _time{0}; // microseconds
 
@@ -0,0 +1,126 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * Equivalence of the dense and sparse observation Jacobian measurement updates.
+ * Their timing is reported by ekf2_update_benchmark.
+ */
+
+#include <gtest/gtest.h>
+#include <memory>
+#include "EKF/ekf.h"
+#include "sensor_simulator/sensor_simulator.h"
+#include "sensor_simulator/ekf_wrapper.h"
+
+class EkfMeasurementUpdateTest : public ::testing::Test
+{
+public:
+	EkfMeasurementUpdateTest(): ::testing::Test(),
+		_ekf{std::make_shared<Ekf>()},
+		_sensor_simulator(_ekf),
+		_ekf_wrapper(_ekf) {};
+
+	std::shared_ptr<Ekf> _ekf;
+	SensorSimulator _sensor_simulator;
+	EkfWrapper _ekf_wrapper;
+
+	void SetUp() override
+	{
+		_ekf->init(0);
+		_sensor_simulator.runSeconds(0.1);
+		_ekf->set_in_air_status(false);
+		_ekf->set_vehicle_at_rest(true);
+
+		_sensor_simulator.runSeconds(2);
+		_ekf_wrapper.enableGpsFusion();
+		_ekf_wrapper.enableRangeHeightFusion();
+		_sensor_simulator.startGps();
+		_sensor_simulator.startRangeFinder();
+		_sensor_simulator.runSeconds(11);
+	}
+};
+
+TEST_F(EkfMeasurementUpdateTest, sparseEqualsDense)
+{
+	// GIVEN: two identical filters
+	std::shared_ptr<Ekf> ekf_dense = std::make_shared<Ekf>();
+	SensorSimulator sensor_simulator_dense(ekf_dense);
+	EkfWrapper ekf_wrapper_dense(ekf_dense);
+	ekf_dense->init(0);
+	sensor_simulator_dense.runSeconds(0.1);
+	ekf_dense->set_in_air_status(false);
+	ekf_dense->set_vehicle_at_rest(true);
+	sensor_simulator_dense.runSeconds(2);
+	ekf_wrapper_dense.enableGpsFusion();
+	ekf_wrapper_dense.enableRangeHeightFusion();
+	sensor_simulator_dense.startGps();
+	sensor_simulator_dense.startRangeFinder();
+	sensor_simulator_dense.runSeconds(11);
+
+	// AND: a range finder like observation Jacobian (vertical position and terrain)
+	constexpr int pos_z = State::pos.idx + 2;
+	constexpr int terrain = State::terrain.idx;
+
+	Ekf::VectorState H_dense;
+	H_dense(pos_z) = -1.f;
+	H_dense(terrain) = 1.f;
+	const Ekf::SparseVectorState<pos_z, terrain> H_sparse(H_dense);
+
+	// WHEN: applying the same sequence of updates with the dense and with the sparse Jacobian
+	constexpr float R = 0.01f;
+
+	for (int i = 0; i < 1000; i++) {
+		const float innovation = 0.001f * ((i % 7) - 3);
+
+		const Ekf::VectorState PH_dense = ekf_dense->covariances() * H_dense;
+		Ekf::VectorState K_dense = PH_dense / (H_dense.dot(PH_dense) + R);
+		ekf_dense->measurementUpdate(K_dense, H_dense, R, innovation);
+
+		const Ekf::VectorState PH_sparse = _ekf->covariances() * H_sparse;
+		Ekf::VectorState K_sparse = PH_sparse / (H_sparse.dot(PH_sparse) + R);
+		_ekf->measurementUpdate(K_sparse, H_sparse, R, innovation);
+	}
+
+	// THEN: both paths produce the same state and covariance
+	for (unsigned r = 0; r < State::size; r++) {
+		for (unsigned c = 0; c < State::size; c++) {
+			const float P_dense = ekf_dense->stateCovariance(r, c);
+			EXPECT_NEAR(P_dense, _ekf->stateCovariance(r, c), 1e-6f + 1e-4f * fabsf(P_dense))
+					<< "P(" << r << ", " << c << ")";
+		}
+	}
+
+	EXPECT_NEAR(ekf_dense->getPosition()(2), _ekf->getPosition()(2), 1e-4f);
+	EXPECT_NEAR(ekf_dense->getTerrainVertPos(), _ekf->getTerrainVertPos(), 1e-4f);
+}
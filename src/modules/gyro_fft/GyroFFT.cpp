@@ -60,19 +60,47 @@ GyroFFT::~GyroFFT()
 	perf_free(_gyro_generation_gap_perf);
 	perf_free(_gyro_fifo_generation_gap_perf);
 
+	FreeBuffers();
+}
+
+void GyroFFT::FreeBuffers()
+{
 	delete[] _gyro_data_buffer_x;
 	delete[] _gyro_data_buffer_y;
 	delete[] _gyro_data_buffer_z;
 	delete[] _hanning_window;
 	delete[] _fft_input_buffer;
 	delete[] _fft_outupt_buffer;
+	delete[] _hanning_window_f32;
+	delete[] _fft_input_buffer_f32;
+	delete[] _fft_output_buffer_f32;
 	delete[] _peak_magnitudes_all;
+
+	_gyro_data_buffer_x = nullptr;
+	_gyro_data_buffer_y = nullptr;
+	_gyro_data_buffer_z = nullptr;
+	_hanning_window = nullptr;
+	_fft_input_buffer = nullptr;
+	_fft_outupt_buffer = nullptr;
+	_hanning_window_f32 = nullptr;
+	_fft_input_buffer_f32 = nullptr;
+	_fft_output_buffer_f32 = nullptr;
+	_peak_magnitudes_all = nullptr;
+
+	for (int axis = 0; axis < 3; axis++) {
+		delete[] _power_spectrum_average[axis];
+		_power_spectrum_average[axis] = nullptr;
+	}
 }
 
 bool GyroFFT::init()
 {
 	bool buffers_allocated = false;
 
+	_fft_f32 = _param_imu_gyro_fft_f32.get();
+	_fft_overlap = math::constrain(_param_imu_gyro_fft_ovl.get(), (int32_t)0, (int32_t)3);
+	_fft_averaging = math::constrain(_param_imu_gyro_fft_avg.get(), (int32_t)1, (int32_t)16);
+
 	// arm_rfft_init_q15(&_rfft_q15, _imu_gyro_fft_len, 0, 1) manually inlined to save flash
 	_rfft_q15.pTwiddleAReal = (q15_t *) realCoefAQ15;
 	_rfft_q15.pTwiddleBReal = (q15_t *) realCoefBQ15;
@@ -138,13 +166,23 @@ bool GyroFFT::init()
 		break;
 	}
 
+	if (buffers_allocated && _fft_f32) {
+		buffers_allocated = _rfft_f32.init(_param_imu_gyro_fft_len.get());
+	}
+
 	if (buffers_allocated) {
 		_imu_gyro_fft_len = _param_imu_gyro_fft_len.get();
 
 		// init Hanning window
 		for (int n = 0; n < _imu_gyro_fft_len; n++) {
 			const float hanning_value = 0.5f * (1.f - cosf(2.f * M_PI_F * n / (_imu_gyro_fft_len - 1)));
-			arm_float_to_q15(&hanning_value, &_hanning_window[n], 1);
+
+			if (_fft_f32) {
+				_hanning_window_f32[n] = hanning_value;
+
+			} else {
+				arm_float_to_q15(&hanning_value, &_hanning_window[n], 1);
+			}
 		}
 
 		if (!SensorSelectionUpdate(true)) {
@@ -155,12 +193,7 @@ bool GyroFFT::init()
 	}
 
 	PX4_ERR("failed to allocate buffers");
-	delete[] _gyro_data_buffer_x;
-	delete[] _gyro_data_buffer_y;
-	delete[] _gyro_data_buffer_z;
-	delete[] _hanning_window;
-	delete[] _fft_input_buffer;
-	delete[] _fft_outupt_buffer;
+	FreeBuffers();
 
 	return false;
 }
@@ -266,7 +299,8 @@ static inline float tau(float x)
 	return (0.25f * p1 - sqrtf(6.f) / 24.f * p2);
 }
 
-float GyroFFT::EstimatePeakFrequencyBin(q15_t fft[], int peak_index)
+template<typename T>
+float GyroFFT::EstimatePeakFrequencyBin(const T fft[], int peak_index)
 {
 	if (peak_index >= 2) {
 		// find peak location using Quinn's Second Estimator (2020-06-14: http://dspguru.com/dsp/howtos/how-to-interpolate-fft-peak/)
@@ -299,6 +333,26 @@ float GyroFFT::EstimatePeakFrequencyBin(q15_t fft[], int peak_index)
 	return NAN;
 }
 
+float GyroFFT::EstimatePeakFrequencyBinAveraged(const float power_spectrum[], int bin_index)
+{
+	if ((bin_index >= 1) && (bin_index + 1 < _imu_gyro_fft_len / 2)) {
+		// the averaged spectrum has no phase: interpolate the magnitudes, exact for a single tone with the Hann window
+		const float m[3] {
+			sqrtf(power_spectrum[bin_index - 1]),
+			sqrtf(power_spectrum[bin_index]),
+			sqrtf(power_spectrum[bin_index + 1])
+		};
+
+		const float denominator = m[0] + 2.f * m[1] + m[2];
+
+		if (denominator > 0.f) {
+			return bin_index + 2.f * (m[2] - m[0]) / denominator;
+		}
+	}
+
+	return NAN;
+}
+
 void GyroFFT::Run()
 {
 	if (should_exit()) {
@@ -410,18 +464,31 @@ void GyroFFT::Update(const hrt_abstime &timestamp_sample, int16_t *input[], uint
 			if ((buffer_index >= _imu_gyro_fft_len) && !_fft_updated) {
 				perf_begin(_fft_perf);
 
-				arm_mult_q15(gyro_data_buffer[axis], _hanning_window, _fft_input_buffer, _imu_gyro_fft_len);
-				arm_rfft_q15(&_rfft_q15, _fft_input_buffer, _fft_outupt_buffer);
+				if (_fft_f32) {
+					for (int i = 0; i < _imu_gyro_fft_len; i++) {
+						_fft_input_buffer_f32[i] = _hanning_window_f32[i] * gyro_data_buffer[axis][i];
+					}
+
+					_rfft_f32.transform(_fft_input_buffer_f32, _fft_output_buffer_f32);
+
+					_fft_updated = true;
+
+					FindPeaks(timestamp_sample, axis, _fft_output_buffer_f32);
+
+				} else {
+					arm_mult_q15(gyro_data_buffer[axis], _hanning_window, _fft_input_buffer, _imu_gyro_fft_len);
+					arm_rfft_q15(&_rfft_q15, _fft_input_buffer, _fft_outupt_buffer);
 
-				_fft_updated = true;
+					_fft_updated = true;
 
-				FindPeaks(timestamp_sample, axis, _fft_outupt_buffer);
+					FindPeaks(timestamp_sample, axis, _fft_outupt_buffer);
+				}
 
 				// reset
-				// shift buffer (3/4 overlap)
-				const int overlap_start = _imu_gyro_fft_len / 4;
-				memmove(&gyro_data_buffer[axis][0], &gyro_data_buffer[axis][overlap_start], sizeof(q15_t) * overlap_start * 3);
-				buffer_index = overlap_start * 3;
+				// shift buffer by the hop size (IMU_GYRO_FFT_OVL: 0 no overlap, 1 1/2, 2 3/4, 3 7/8 overlap)
+				const int hop = _imu_gyro_fft_len >> _fft_overlap;
+				memmove(&gyro_data_buffer[axis][0], &gyro_data_buffer[axis][hop], sizeof(q15_t) * (_imu_gyro_fft_len - hop));
+				buffer_index = _imu_gyro_fft_len - hop;
 
 				perf_end(_fft_perf);
 			}
@@ -429,10 +496,23 @@ void GyroFFT::Update(const hrt_abstime &timestamp_sample, int16_t *input[], uint
 	}
 }
 
-void GyroFFT::FindPeaks(const hrt_abstime &timestamp_sample, int axis, q15_t *fft_outupt_buffer)
+template<typename T>
+void GyroFFT::FindPeaks(const hrt_abstime &timestamp_sample, int axis, const T fft_outupt_buffer[])
 {
 	const float resolution_hz = _gyro_sample_rate_hz / _imu_gyro_fft_len;
 
+	float *power_spectrum_average = _power_spectrum_average[axis];
+	float average_alpha = 1.f;
+
+	if (power_spectrum_average) {
+		// mean of the first IMU_GYRO_FFT_AVG spectra, exponential moving average with the same weight afterwards
+		if (_power_spectrum_average_count[axis] < _fft_averaging) {
+			_power_spectrum_average_count[axis]++;
+		}
+
+		average_alpha = 1.f / _power_spectrum_average_count[axis];
+	}
+
 	// sum total energy across all used buckets for SNR
 	float bin_mag_sum = 0;
 
@@ -442,25 +522,78 @@ void GyroFFT::FindPeaks(const hrt_abstime &timestamp_sample, int axis, q15_t *ff
 		const float real = fft_outupt_buffer[fft_index];
 		const float imag = fft_outupt_buffer[fft_index + 1];
 
-		const float fft_magnitude = sqrtf(real * real + imag * imag);
-
 		int bin_index = fft_index / 2;
 
+		float power = real * real + imag * imag;
+
+		if (power_spectrum_average) {
+			// average the power spectra of the overlapping windows
+			power_spectrum_average[bin_index] += average_alpha * (power - power_spectrum_average[bin_index]);
+			power = power_spectrum_average[bin_index];
+		}
+
+		const float fft_magnitude = sqrtf(power);
+
 		_peak_magnitudes_all[bin_index] = fft_magnitude;
 		bin_mag_sum += fft_magnitude;
 	}
 
+	const int bin_count = _imu_gyro_fft_len / 2;
+
+	float *peak_frequencies_publish[] { _sensor_gyro_fft.peak_frequencies_x, _sensor_gyro_fft.peak_frequencies_y, _sensor_gyro_fft.peak_frequencies_z };
 
 	// find raw peaks
 	uint16_t raw_peak_index[MAX_NUM_PEAKS] {};
 	float peak_magnitude[MAX_NUM_PEAKS] {};
+	int num_raw_peaks = 0;
 
-	for (int i = 0; i < MAX_NUM_PEAKS; i++) {
+	// peaks already tracked: only search close to the previous frequency
+	for (int peak_prev = 0; peak_prev < MAX_NUM_PEAKS; peak_prev++) {
+		const float peak_frequency_prev = peak_frequencies_publish[axis][peak_prev];
+
+		if (PX4_ISFINITE(peak_frequency_prev) && (peak_frequency_prev > 0.f)) {
+			const int bin_prev = (int)roundf(peak_frequency_prev / resolution_hz);
+
+			float largest_peak = 0;
+			int largest_peak_index = 0;
+
+			for (int bin_index = math::max(bin_prev - 2, 2); bin_index <= math::min(bin_prev + 2, bin_count - 2); bin_index++) {
+
+				const float freq_hz = bin_index * resolution_hz;
+
+				if ((_peak_magnitudes_all[bin_index] > largest_peak)
+				    && (freq_hz >= _param_imu_gyro_fft_min.get())
+				    && (freq_hz <= _param_imu_gyro_fft_max.get())) {
+
+					largest_peak = _peak_magnitudes_all[bin_index];
+					largest_peak_index = bin_index;
+				}
+			}
+
+			// must be a local maximum, not the side of a larger peak outside of the search range
+			if ((largest_peak_index > 1)
+			    && (_peak_magnitudes_all[largest_peak_index] >= _peak_magnitudes_all[largest_peak_index - 1])
+			    && (_peak_magnitudes_all[largest_peak_index] >= _peak_magnitudes_all[largest_peak_index + 1])) {
+
+				raw_peak_index[num_raw_peaks] = largest_peak_index;
+				peak_magnitude[num_raw_peaks] = _peak_magnitudes_all[largest_peak_index];
+				num_raw_peaks++;
+
+				// remove peak + sides (included in frequency estimate later)
+				_peak_magnitudes_all[largest_peak_index - 1] = 0;
+				_peak_magnitudes_all[largest_peak_index]     = 0;
+				_peak_magnitudes_all[largest_peak_index + 1] = 0;
+			}
+		}
+	}
+
+	// search the whole spectrum for the remaining peaks
+	for (int i = num_raw_peaks; i < MAX_NUM_PEAKS; i++) {
 
 		float largest_peak = 0;
 		int largest_peak_index = 0;
 
-		for (int bin_index = 1; bin_index < _imu_gyro_fft_len; bin_index++) {
+		for (int bin_index = 1; bin_index < bin_count; bin_index++) {
 
 			const float freq_hz = bin_index * resolution_hz;
 
@@ -493,8 +626,6 @@ void GyroFFT::FindPeaks(const hrt_abstime &timestamp_sample, int axis, q15_t *ff
 	float peak_frequencies[MAX_NUM_PEAKS] {};
 	float peak_snr[MAX_NUM_PEAKS] {};
 
-	float *peak_frequencies_publish[] { _sensor_gyro_fft.peak_frequencies_x, _sensor_gyro_fft.peak_frequencies_y, _sensor_gyro_fft.peak_frequencies_z };
-
 	float peak_frequencies_prev[MAX_NUM_PEAKS];
 
 	for (int i = 0; i < MAX_NUM_PEAKS; i++) {
@@ -504,7 +635,10 @@ void GyroFFT::FindPeaks(const hrt_abstime &timestamp_sample, int axis, q15_t *ff
 	for (int peak_new = 0; peak_new < MAX_NUM_PEAKS; peak_new++) {
 		if (raw_peak_index[peak_new] > 0) {
 
-			const float adjusted_bin = 0.5f * EstimatePeakFrequencyBin(fft_outupt_buffer, 2 * raw_peak_index[peak_new]);
+			// with averaging the frequency is estimated from the averaged spectrum as well
+			const float adjusted_bin = power_spectrum_average
+						   ? EstimatePeakFrequencyBinAveraged(power_spectrum_average, raw_peak_index[peak_new])
+						   : 0.5f * EstimatePeakFrequencyBin(fft_outupt_buffer, 2 * raw_peak_index[peak_new]);
 
 			if (PX4_ISFINITE(adjusted_bin)) {
 				const float freq_adjusted = resolution_hz * adjusted_bin;
@@ -703,6 +837,8 @@ int GyroFFT::task_spawn(int argc, char *argv[])
 int GyroFFT::print_status()
 {
 	PX4_INFO("gyro sample rate: %.3f Hz", (double)_gyro_sample_rate_hz);
+	PX4_INFO("FFT: %s, length %" PRId32 ", overlap %.1f%%, averaging %" PRId32, _fft_f32 ? "float32" : "q15",
+		 _imu_gyro_fft_len, (double)(100.f - 100.f / (1 << _fft_overlap)), _fft_averaging);
 	perf_print_counter(_cycle_perf);
 	perf_print_counter(_cycle_interval_perf);
 	perf_print_counter(_fft_perf);
@@ -56,6 +56,8 @@
 #include "arm_math.h"
 #include "arm_const_structs.h"
 
+#include "RealFFT.hpp"
+
 using namespace time_literals;
 
 class GyroFFT : public ModuleBase<GyroFFT>, public ModuleParams, public px4::ScheduledWorkItem
@@ -85,8 +87,12 @@ private:
 			sensor_gyro_fft_s::peak_frequencies_x[0]);
 
 	void Run() override;
-	inline void FindPeaks(const hrt_abstime &timestamp_sample, int axis, q15_t *fft_outupt_buffer);
-	inline float EstimatePeakFrequencyBin(q15_t fft[], int peak_index);
+	template<typename T>
+	inline void FindPeaks(const hrt_abstime &timestamp_sample, int axis, const T fft_outupt_buffer[]);
+	template<typename T>
+	inline float EstimatePeakFrequencyBin(const T fft[], int peak_index);
+	inline float EstimatePeakFrequencyBinAveraged(const float power_spectrum[], int bin_index);
+	void FreeBuffers();
 	inline void Publish();
 	bool SensorSelectionUpdate(bool force = false);
 	void Update(const hrt_abstime &timestamp_sample, int16_t *input[], uint8_t N);
@@ -100,16 +106,34 @@ private:
 		_gyro_data_buffer_x = new q15_t[N];
 		_gyro_data_buffer_y = new q15_t[N];
 		_gyro_data_buffer_z = new q15_t[N];
-		_hanning_window = new q15_t[N];
-		_fft_input_buffer = new q15_t[N];
-		_fft_outupt_buffer = new q15_t[N * 2];
+
+		if (_fft_f32) {
+			_hanning_window_f32 = new float[N];
+			_fft_input_buffer_f32 = new float[N];
+			_fft_output_buffer_f32 = new float[N + 2];
+
+		} else {
+			_hanning_window = new q15_t[N];
+			_fft_input_buffer = new q15_t[N];
+			_fft_outupt_buffer = new q15_t[N * 2];
+		}
 
 		_peak_magnitudes_all = new float[N];
 
+		bool power_spectrum_allocated = true;
+
+		if (_fft_averaging > 1) {
+			for (int axis = 0; axis < 3; axis++) {
+				_power_spectrum_average[axis] = new float[N / 2] {};
+				power_spectrum_allocated = power_spectrum_allocated && _power_spectrum_average[axis];
+			}
+		}
+
 		return (_gyro_data_buffer_x && _gyro_data_buffer_y && _gyro_data_buffer_z
-			&& _hanning_window
-			&& _fft_input_buffer
-			&& _fft_outupt_buffer);
+			&& (_fft_f32 ? (_hanning_window_f32 && _fft_input_buffer_f32 && _fft_output_buffer_f32)
+			    : (_hanning_window && _fft_input_buffer && _fft_outupt_buffer))
+			&& _peak_magnitudes_all
+			&& power_spectrum_allocated);
 	}
 
 	uORB::Publication<sensor_gyro_fft_s> _sensor_gyro_fft_pub{ORB_ID(sensor_gyro_fft)};
@@ -133,6 +157,7 @@ private:
 	bool _gyro_fifo{false};
 
 	arm_rfft_instance_q15 _rfft_q15;
+	RealFFT _rfft_f32;
 
 	q15_t *_gyro_data_buffer_x{nullptr};
 	q15_t *_gyro_data_buffer_y{nullptr};
@@ -141,8 +166,16 @@ private:
 	q15_t *_fft_input_buffer{nullptr};
 	q15_t *_fft_outupt_buffer{nullptr};
 
+	float *_hanning_window_f32{nullptr};
+	float *_fft_input_buffer_f32{nullptr};
+	float *_fft_output_buffer_f32{nullptr};
+
 	float *_peak_magnitudes_all{nullptr};
 
+	// power spectrum average of each axis (IMU_GYRO_FFT_AVG > 1 only)
+	float *_power_spectrum_average[3] {};
+	int _power_spectrum_average_count[3] {};
+
 	float _gyro_sample_rate_hz{8000}; // 8 kHz default
 
 	float _fifo_last_scale{0};
@@ -158,6 +191,9 @@ private:
 	hrt_abstime _last_update[3][MAX_NUM_PEAKS] {};
 
 	int32_t _imu_gyro_fft_len{256};
+	int32_t _fft_overlap{2};
+	int32_t _fft_averaging{1};
+	bool _fft_f32{false};
 
 	bool _fft_updated{false};
 	bool _publish{false};
@@ -166,7 +202,10 @@ private:
 		(ParamInt<px4::params::IMU_GYRO_FFT_LEN>) _param_imu_gyro_fft_len,
 		(ParamFloat<px4::params::IMU_GYRO_FFT_MIN>) _param_imu_gyro_fft_min,
 		(ParamFloat<px4::params::IMU_GYRO_FFT_MAX>) _param_imu_gyro_fft_max,
-		(ParamFloat<px4::params::IMU_GYRO_FFT_SNR>) _param_imu_gyro_fft_snr
+		(ParamFloat<px4::params::IMU_GYRO_FFT_SNR>) _param_imu_gyro_fft_snr,
+		(ParamBool<px4::params::IMU_GYRO_FFT_F32>) _param_imu_gyro_fft_f32,
+		(ParamInt<px4::params::IMU_GYRO_FFT_OVL>) _param_imu_gyro_fft_ovl,
+		(ParamInt<px4::params::IMU_GYRO_FFT_AVG>) _param_imu_gyro_fft_avg
 	)
 };
 
@@ -0,0 +1,172 @@
+/****************************************************************************
+ *
+ *   Copyright (C) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file RealFFT.hpp
+ *
+ * Float32 FFT of real samples, the length is a power of 2.
+ *
+ * The N real samples are transformed as N/2 complex samples (even samples as real, odd samples as imaginary part)
+ * with an in place radix-2 FFT, then split into the spectrum of the real signal. The output has the layout of the
+ * CMSIS-DSP real FFT: [real[0], imag[0], real[1], imag[1], ... real[N/2], imag[N/2]] (N + 2 values).
+ */
+
+#pragma once
+
+#include <mathlib/math/Functions.hpp>
+
+class RealFFT
+{
+public:
+	RealFFT() = default;
+	~RealFFT() { delete[] _twiddle; }
+
+	RealFFT(const RealFFT &) = delete;
+	RealFFT &operator=(const RealFFT &) = delete;
+
+	bool init(int length)
+	{
+		delete[] _twiddle;
+		_twiddle = nullptr;
+		_length = 0;
+
+		if ((length < 4) || ((length & (length - 1)) != 0)) {
+			return false;
+		}
+
+		// twiddle factors exp(-2 pi i k / N), k = 0 ... N/2 - 1, used by both the complex FFT and the split
+		_twiddle = new float[length];
+
+		if (_twiddle == nullptr) {
+			return false;
+		}
+
+		for (int k = 0; k < length / 2; k++) {
+			const float phase = -2.f * M_PI_F * k / length;
+			_twiddle[2 * k] = cosf(phase);
+			_twiddle[2 * k + 1] = sinf(phase);
+		}
+
+		_length = length;
+		return true;
+	}
+
+	int length() const { return _length; }
+
+	/**
+	 * @param input N real samples, used as work buffer (overwritten)
+	 * @param output N + 2 values, the complex spectrum from 0 to the Nyquist frequency
+	 */
+	void transform(float input[], float output[]) const
+	{
+		const int M = _length / 2;
+		float *z = input;
+
+		// bit reversal permutation
+		for (int i = 1, j = 0; i < M; i++) {
+			int bit = M >> 1;
+
+			for (; j & bit; bit >>= 1) {
+				j ^= bit;
+			}
+
+			j ^= bit;
+
+			if (i < j) {
+				swap(z[2 * i], z[2 * j]);
+				swap(z[2 * i + 1], z[2 * j + 1]);
+			}
+		}
+
+		// radix-2 butterflies, exp(-2 pi i k / size) = twiddle[k * N / size]
+		for (int size = 2; size <= M; size *= 2) {
+			const int half = size / 2;
+			const int stride = _length / size;
+
+			for (int k = 0; k < half; k++) {
+				const float wr = _twiddle[2 * k * stride];
+				const float wi = _twiddle[2 * k * stride + 1];
+
+				for (int start = 0; start < M; start += size) {
+					const int a = 2 * (start + k);
+					const int b = a + 2 * half;
+
+					const float tr = wr * z[b] - wi * z[b + 1];
+					const float ti = wr * z[b + 1] + wi * z[b];
+
+					z[b] = z[a] - tr;
+					z[b + 1] = z[a + 1] - ti;
+					z[a] += tr;
+					z[a + 1] += ti;
+				}
+			}
+		}
+
+		// split: X[k] = E[k] + exp(-2 pi i k / N) O[k]
+		//  with E[k] = (Z[k] + conj(Z[M - k])) / 2 and O[k] = -i (Z[k] - conj(Z[M - k])) / 2
+		output[0] = z[0] + z[1];
+		output[1] = 0.f;
+		output[2 * M] = z[0] - z[1];
+		output[2 * M + 1] = 0.f;
+
+		for (int k = 1; k < M; k++) {
+			const float zr = z[2 * k];
+			const float zi = z[2 * k + 1];
+			const float cr = z[2 * (M - k)];
+			const float ci = -z[2 * (M - k) + 1];
+
+			const float er = 0.5f * (zr + cr);
+			const float ei = 0.5f * (zi + ci);
+			const float odd_r = 0.5f * (zi - ci);
+			const float odd_i = -0.5f * (zr - cr);
+
+			const float wr = _twiddle[2 * k];
+			const float wi = _twiddle[2 * k + 1];
+
+			output[2 * k] = er + wr * odd_r - wi * odd_i;
+			output[2 * k + 1] = ei + wr * odd_i + wi * odd_r;
+		}
+	}
+
+private:
+	static void swap(float &a, float &b)
+	{
+		const float tmp = a;
+		a = b;
+		b = tmp;
+	}
+
+	float *_twiddle{nullptr};
+	int _length{0};
+};
@@ -0,0 +1,182 @@
+/****************************************************************************
+ *
+ *   Copyright (C) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * Timing and accuracy of the float32 real FFT against the q15 CMSIS-DSP real FFT, for the FFT lengths of
+ * IMU_GYRO_FFT_LEN. Each transform includes the Hann window and the power spectrum, like GyroFFT::Update()
+ * and GyroFFT::FindPeaks(). The error is the RMS error of the magnitude spectrum relative to a double precision
+ * DFT of the same windowed input.
+ *
+ * Usage: gyro_fft_benchmark [repeats]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#include "arm_math.h"
+#include "arm_const_structs.h"
+
+#include "RealFFT.hpp"
+
+using namespace std::chrono;
+
+static constexpr int MAX_LENGTH = 1024;
+
+// magnitude spectrum relative RMS error, the q15 FFT output is scaled by 1/N
+template<typename T>
+static double spectrumError(const T fft[], const double reference[], int N, double scale)
+{
+	double error = 0.0;
+	double magnitude = 0.0;
+
+	for (int k = 1; k < N / 2; k++) {
+		const double real = fft[2 * k];
+		const double imag = fft[2 * k + 1];
+		const double m = scale * sqrt(real * real + imag * imag);
+		error += (m - reference[k]) * (m - reference[k]);
+		magnitude += reference[k] * reference[k];
+	}
+
+	return sqrt(error / magnitude);
+}
+
+template<typename T>
+static float powerSum(const T fft[], int N)
+{
+	float sum = 0.f;
+
+	for (int k = 1; k < N / 2; k++) {
+		const float real = fft[2 * k];
+		const float imag = fft[2 * k + 1];
+		sum += real * real + imag * imag;
+	}
+
+	return sum;
+}
+
+int main(int argc, char *argv[])
+{
+	const int repeats = (argc > 1) ? std::max(atoi(argv[1]), 1) : 5;
+
+	static q15_t samples[MAX_LENGTH];
+	static q15_t window_q15[MAX_LENGTH];
+	static float window_f32[MAX_LENGTH];
+	static q15_t input_q15[MAX_LENGTH];
+	static q15_t output_q15[2 * MAX_LENGTH];
+	static float input_f32[MAX_LENGTH];
+	static float output_f32[MAX_LENGTH + 2];
+	static double reference[MAX_LENGTH / 2];
+
+	for (int N : {256, 512, 1024}) {
+		arm_rfft_instance_q15 rfft_q15;
+		RealFFT rfft_f32;
+
+		if ((arm_rfft_init_q15(&rfft_q15, N, 0, 1) != ARM_MATH_SUCCESS) || !rfft_f32.init(N)) {
+			printf("N %d: init failed\n", N);
+			return 1;
+		}
+
+		// gyro like input: two vibration peaks and pseudo random noise, as converted by GyroFFT::Update()
+		uint32_t seed = 1;
+
+		for (int n = 0; n < N; n++) {
+			seed = seed * 1664525u + 1013904223u;
+			const float noise = 200.f * ((seed >> 8) / float(1 << 24) - 0.5f);
+			const float peak_1 = 4000.f * sinf(2.f * M_PI_F * 0.117f * n);
+			const float peak_2 = 1500.f * sinf(2.f * M_PI_F * 0.283f * n);
+			const float gyro = peak_1 + peak_2 + noise;
+			samples[n] = (int16_t)gyro / 2;
+
+			const float hanning_value = 0.5f * (1.f - cosf(2.f * M_PI_F * n / (N - 1)));
+			window_f32[n] = hanning_value;
+			arm_float_to_q15(&hanning_value, &window_q15[n], 1);
+		}
+
+		for (int k = 0; k < N / 2; k++) {
+			double real = 0.0;
+			double imag = 0.0;
+
+			for (int n = 0; n < N; n++) {
+				const double x = (double)samples[n] * window_f32[n];
+				real += x * cos(2.0 * M_PI * k * n / N);
+				imag -= x * sin(2.0 * M_PI * k * n / N);
+			}
+
+			reference[k] = sqrt(real * real + imag * imag);
+		}
+
+		const int transforms = 1000 * 1024 / N;
+		nanoseconds best_q15 = nanoseconds::max();
+		nanoseconds best_f32 = nanoseconds::max();
+		volatile float sink = 0.f;
+
+		for (int r = 0; r < repeats; r++) {
+			auto start = steady_clock::now();
+
+			for (int i = 0; i < transforms; i++) {
+				arm_mult_q15(samples, window_q15, input_q15, N);
+				arm_rfft_q15(&rfft_q15, input_q15, output_q15);
+				sink = sink + powerSum(output_q15, N);
+			}
+
+			best_q15 = std::min(best_q15, duration_cast<nanoseconds>(steady_clock::now() - start));
+
+			start = steady_clock::now();
+
+			for (int i = 0; i < transforms; i++) {
+				for (int n = 0; n < N; n++) {
+					input_f32[n] = window_f32[n] * samples[n];
+				}
+
+				rfft_f32.transform(input_f32, output_f32);
+				sink = sink + powerSum(output_f32, N);
+			}
+
+			best_f32 = std::min(best_f32, duration_cast<nanoseconds>(steady_clock::now() - start));
+		}
+
+		// q15: the window is scaled by 2^-15 and the output by 1/N
+		const double error_q15 = spectrumError(output_q15, reference, N, (double)N);
+		const double error_f32 = spectrumError(output_f32, reference, N, 1.0);
+
+		printf("N %4d: q15 %8.2f us (error %.1e), f32 %8.2f us (error %.1e)\n", N,
+		       best_q15.count() * 1e-3 / transforms, error_q15,
+		       best_f32.count() * 1e-3 / transforms, error_f32);
+	}
+
+	return 0;
+}
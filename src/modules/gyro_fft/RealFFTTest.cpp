@@ -0,0 +1,98 @@
+/****************************************************************************
+ *
+ *   Copyright (C) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * Test code for the float32 real FFT
+ * Run this test only using make tests TESTFILTER=RealFFT
+ */
+
+#include <gtest/gtest.h>
+
+#include "RealFFT.hpp"
+
+static void dft(const float input[], float output[], int N)
+{
+	for (int k = 0; k <= N / 2; k++) {
+		double real = 0.0;
+		double imag = 0.0;
+
+		for (int n = 0; n < N; n++) {
+			const double phase = -2.0 * M_PI * k * n / N;
+			real += input[n] * cos(phase);
+			imag += input[n] * sin(phase);
+		}
+
+		output[2 * k] = real;
+		output[2 * k + 1] = imag;
+	}
+}
+
+TEST(RealFFTTest, invalidLength)
+{
+	RealFFT rfft;
+	EXPECT_FALSE(rfft.init(0));
+	EXPECT_FALSE(rfft.init(2));
+	EXPECT_FALSE(rfft.init(384));
+	EXPECT_EQ(rfft.length(), 0);
+}
+
+TEST(RealFFTTest, sameAsDFT)
+{
+	for (int N : {8, 256, 1024}) {
+		RealFFT rfft;
+		ASSERT_TRUE(rfft.init(N));
+
+		float input[1024];
+		float work[1024];
+		float expected[1024 + 2];
+		float output[1024 + 2];
+
+		// sum of sines and pseudo random noise
+		uint32_t seed = 1;
+
+		for (int n = 0; n < N; n++) {
+			seed = seed * 1664525u + 1013904223u;
+			const float noise = (seed >> 8) / float(1 << 24) - 0.5f;
+			input[n] = 0.3f + sinf(2.f * M_PI_F * 3.f * n / N) + 0.5f * cosf(2.f * M_PI_F * 0.37f * n) + noise;
+			work[n] = input[n];
+		}
+
+		dft(input, expected, N);
+		rfft.transform(work, output);
+
+		for (int i = 0; i < N + 2; i++) {
+			EXPECT_NEAR(output[i], expected[i], 1e-5f * N) << "N " << N << " index " << i;
+		}
+	}
+}
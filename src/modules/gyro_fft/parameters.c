@@ -83,3 +83,46 @@ PARAM_DEFINE_INT32(IMU_GYRO_FFT_LEN, 512);
 * @group Sensors
 */
 PARAM_DEFINE_FLOAT(IMU_GYRO_FFT_SNR, 10.f);
+
+/**
+* IMU gyro FFT float32.
+*
+* Compute the FFT in float32 instead of q15 fixed point.
+* Uses more memory, but gives a higher dynamic range on boards with an FPU.
+*
+* @boolean
+* @reboot_required true
+* @group Sensors
+*/
+PARAM_DEFINE_INT32(IMU_GYRO_FFT_F32, 0);
+
+/**
+* IMU gyro FFT window overlap.
+*
+* Overlap of consecutive FFT windows. A higher overlap computes an FFT more often,
+* which updates the peak frequencies with a lower latency at a higher CPU load.
+*
+* @value 0 None
+* @value 1 50%
+* @value 2 75%
+* @value 3 87.5%
+* @reboot_required true
+* @group Sensors
+*/
+PARAM_DEFINE_INT32(IMU_GYRO_FFT_OVL, 2);
+
+/**
+* IMU gyro FFT spectrum averaging.
+*
+* Averaging length of the power spectrum in FFT windows. The first windows are averaged with
+* equal weights, afterwards each new spectrum is weighted 1/IMU_GYRO_FFT_AVG (exponential
+* moving average). The peaks and their frequencies are estimated from the averaged spectrum,
+* which gives more stable peaks, in particular with a high window overlap (IMU_GYRO_FFT_OVL).
+* Set to 1 to disable.
+*
+* @min 1
+* @max 16
+* @reboot_required true
+* @group Sensors
+*/
+PARAM_DEFINE_INT32(IMU_GYRO_FFT_AVG, 1);
@@ -101,6 +101,8 @@ void LoadMon::Run()
 
 	cpuload();
 
+	perf_histograms();
+
 #if defined(__PX4_NUTTX)
 
 	if (_param_sys_stck_en.get()) {
@@ -247,6 +249,42 @@ void LoadMon::cpuload()
 #endif
 }
 
+void LoadMon::perf_histogram_callback(perf_counter_t handle, void *user)
+{
+	LoadMon *obj = (LoadMon *)user;
+
+	if (perf_type(handle) != PC_HISTOGRAM) {
+		return;
+	}
+
+	if (obj->_perf_histogram_count++ != obj->_perf_histogram_index) {
+		return;
+	}
+
+	perf_histogram_s perf_histogram{};
+	strncpy(perf_histogram.name, perf_name(handle), sizeof(perf_histogram.name) - 1);
+	perf_histogram.event_count = perf_event_count(handle);
+	perf_histogram.p50 = perf_percentile(handle, 0.5f);
+	perf_histogram.p90 = perf_percentile(handle, 0.9f);
+	perf_histogram.p99 = perf_percentile(handle, 0.99f);
+	perf_histogram.p999 = perf_percentile(handle, 0.999f);
+	perf_histogram.max = perf_percentile(handle, 1.f);
+	perf_histogram.timestamp = hrt_absolute_time();
+
+	obj->_perf_histogram_pub.publish(perf_histogram);
+}
+
+void LoadMon::perf_histograms()
+{
+	_perf_histogram_count = 0;
+	perf_iterate_all(perf_histogram_callback, this);
+
+	// Continue with the next histogram counter next cycle
+	if (_perf_histogram_count > 0) {
+		_perf_histogram_index = (_perf_histogram_index + 1) % _perf_histogram_count;
+	}
+}
+
 #if defined(__PX4_NUTTX)
 void LoadMon::stack_usage()
 {
@@ -315,6 +353,9 @@ int LoadMon::print_usage(const char *reason)
 Background process running periodically on the low priority work queue to calculate the CPU load and RAM
 usage and publish the `cpuload` topic.
 
+It also publishes the percentiles of the histogram perf counters (`PC_HISTOGRAM`) as `perf_histogram`,
+one counter per cycle, so they can be logged.
+
 On NuttX it also checks the stack usage of each process and if it falls below 300 bytes, a warning is output,
 which will also appear in the log file.
 )DESCR_STR");
@@ -46,6 +46,7 @@
 #include <px4_platform/cpuload.h>
 #include <uORB/Publication.hpp>
 #include <uORB/topics/cpuload.h>
+#include <uORB/topics/perf_histogram.h>
 #include <uORB/topics/task_stack_info.h>
 
 #if defined(__PX4_LINUX)
@@ -81,6 +82,16 @@ private:
 	/** Do a calculation of the CPU load and publish it. */
 	void cpuload();
 
+	/** Publish the percentiles of the next PC_HISTOGRAM perf counter. */
+	void perf_histograms();
+
+	static void perf_histogram_callback(perf_counter_t handle, void *user);
+
+	int _perf_histogram_index{0};
+	int _perf_histogram_count{0};
+
+	uORB::Publication<perf_histogram_s> _perf_histogram_pub{ORB_ID(perf_histogram)};
+
 	/* Stack check only available on Nuttx */
 #if defined(__PX4_NUTTX)
 	/* Calculate stack usage */
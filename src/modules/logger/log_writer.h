@@ -168,6 +168,11 @@ public:
 		return false;
 	}
 
+	void set_compression(bool enable)
+	{
+		if (_log_writer_file) { _log_writer_file->set_compression(enable); }
+	}
+
 #if defined(PX4_CRYPTO)
 	void set_encryption_parameters(px4_crypto_algorithm_t algorithm, uint8_t key_idx,  uint8_t exchange_key_idx)
 	{
@@ -48,6 +48,9 @@
 # include <systemlib/hardfault_log.h>
 #endif // __PX4_NUTTX
 
+#define HEATSHRINK_DYNAMIC_ALLOC 0
+#include <lib/heatshrink/heatshrink/heatshrink_encoder.h>
+
 using namespace time_literals;
 
 
@@ -56,6 +59,68 @@ namespace px4
 namespace logger
 {
 constexpr size_t LogWriterFile::_min_write_chunk;
+constexpr size_t LogWriterFile::_compression_block_size;
+
+/**
+ * Block compression state (heatshrink, the same codec used for the uORB message formats).
+ * The encoder is reset for every block, so that each block can be decoded on its own.
+ */
+struct LogWriterFile::Compressor {
+	heatshrink_encoder encoder;
+	uint8_t block[sizeof(ulog_compressed_block_s) + _compression_block_size];
+
+	/**
+	 * Compress a block
+	 * @return compressed size, or 0 if the data does not compress into out_size bytes
+	 */
+	size_t compress(const uint8_t *in, size_t in_size, uint8_t *out, size_t out_size)
+	{
+		heatshrink_encoder_reset(&encoder);
+
+		size_t in_pos = 0;
+		size_t out_pos = 0;
+
+		while (in_pos < in_size) {
+			size_t sunk = 0;
+
+			if (heatshrink_encoder_sink(&encoder, const_cast<uint8_t *>(in + in_pos), in_size - in_pos, &sunk) < 0) {
+				return 0;
+			}
+
+			in_pos += sunk;
+
+			if (!poll(out, out_size, out_pos)) {
+				return 0;
+			}
+		}
+
+		while (heatshrink_encoder_finish(&encoder) == HSER_FINISH_MORE) {
+			if (!poll(out, out_size, out_pos)) {
+				return 0;
+			}
+		}
+
+		return out_pos;
+	}
+
+private:
+	bool poll(uint8_t *out, size_t out_size, size_t &out_pos)
+	{
+		HSE_poll_res res;
+
+		do {
+			if (out_pos >= out_size) {
+				return false;
+			}
+
+			size_t output_size = 0;
+			res = heatshrink_encoder_poll(&encoder, out + out_pos, out_size - out_pos, &output_size);
+			out_pos += output_size;
+		} while (res == HSER_POLL_MORE);
+
+		return res == HSER_POLL_EMPTY;
+	}
+};
 
 LogWriterFile::LogWriterFile(size_t buffer_size)
 	: _buffers{
@@ -74,6 +139,7 @@ LogWriterFile::LogWriterFile(size_t buffer_size)
 {
 	pthread_mutex_init(&_mtx, nullptr);
 	pthread_cond_init(&_cv, nullptr);
+	_perf_compress = perf_alloc(PC_ELAPSED, "logger_compress");
 }
 
 bool LogWriterFile::init()
@@ -85,6 +151,9 @@ LogWriterFile::~LogWriterFile()
 {
 	pthread_mutex_destroy(&_mtx);
 	pthread_cond_destroy(&_cv);
+
+	delete _compressor;
+	perf_free(_perf_compress);
 }
 
 #if defined(PX4_CRYPTO)
@@ -187,6 +256,44 @@ bool LogWriterFile::init_logfile_encryption(const LogType type)
 }
 #endif // PX4_CRYPTO
 
+bool LogWriterFile::init_logfile_compression(const LogType type)
+{
+	LogFileBuffer &buffer = _buffers[(int)type];
+	buffer._compressed = false;
+
+	// the mission log is written in small pieces, which do not compress well
+	if (!_compression_enabled || type != LogType::Full) {
+		return true;
+	}
+
+	if (_compressor == nullptr) {
+		_compressor = new Compressor();
+
+		if (_compressor == nullptr) {
+			PX4_ERR("alloc failed");
+			return false;
+		}
+	}
+
+	// write the header to the beginning of the log file
+	ulog_compressed_header_s header = {
+		.magic = {'U', 'L', 'o', 'g', 'C', 'm', 'p'},
+		.hdr_ver = 1,
+		.timestamp = hrt_absolute_time(),
+		.algorithm = ULOG_COMPRESSION_HEATSHRINK,
+		.window_bits = HEATSHRINK_STATIC_WINDOW_BITS,
+		.lookahead_bits = HEATSHRINK_STATIC_LOOKAHEAD_BITS,
+		.reserved = 0
+	};
+
+	if (::write(buffer.fd(), &header, sizeof(header)) != sizeof(header)) {
+		PX4_ERR("Writing the compression header to disk failed");
+		return false;
+	}
+
+	buffer._compressed = true;
+	return true;
+}
 
 bool LogWriterFile::start_log(LogType type, const char *filename)
 {
@@ -230,6 +337,14 @@ bool LogWriterFile::start_log(LogType type, const char *filename)
 
 #endif
 
+		if (!init_logfile_compression(type)) {
+			PX4_ERR("Failed to start compressed logging");
+			_buffers[(int)type]._should_run = false;
+			_buffers[(int)type].close_file();
+			_buffers[(int)type].reset();
+			return false;
+		}
+
 		PX4_INFO("Opened %s log file: %s", log_type_str(type), filename);
 		notify();
 		return true;
@@ -410,13 +525,13 @@ void LogWriterFile::run()
 
 #endif
 
-					int written = buffer.write_to_file(read_ptr, available, call_fsync);
+					int written = write_to_file(buffer, read_ptr, available, call_fsync);
 
 					if (written < 0) {
 						// retry once
 						PX4_ERR("write failed errno:%i (%s), retrying", errno, strerror(errno));
 						px4_usleep(10000); // 10 milliseconds
-						written = buffer.write_to_file(read_ptr, available, call_fsync);
+						written = write_to_file(buffer, read_ptr, available, call_fsync);
 					}
 
 					/* buffer.mark_read() requires _mtx to be locked */
@@ -490,6 +605,57 @@ void LogWriterFile::run()
 	}
 }
 
+int LogWriterFile::write_to_file(LogFileBuffer &buffer, void *ptr, size_t size, bool call_fsync)
+{
+	if (buffer._compressed) {
+		return write_compressed(buffer, static_cast<const uint8_t *>(ptr), size, call_fsync);
+	}
+
+	return buffer.write_to_file(ptr, size, call_fsync);
+}
+
+int LogWriterFile::write_compressed(LogFileBuffer &buffer, const uint8_t *ptr, size_t size, bool call_fsync)
+{
+	ulog_compressed_block_s *block = reinterpret_cast<ulog_compressed_block_s *>(_compressor->block);
+	size_t written = 0;
+
+	while (written < size) {
+		const size_t block_size = math::min(size - written, _compression_block_size);
+
+		perf_begin(_perf_compress);
+		size_t data_size = _compressor->compress(ptr + written, block_size, block->data, block_size);
+		perf_end(_perf_compress);
+
+		block->magic[0] = ULOG_COMPRESSED_BLOCK_MAGIC_0;
+		block->magic[1] = ULOG_COMPRESSED_BLOCK_MAGIC_1;
+		block->decompressed_size = block_size;
+		block->flags = 0;
+		block->reserved = 0;
+
+		if (data_size == 0) {
+			// incompressible: store the data as-is
+			memcpy(block->data, ptr + written, block_size);
+			data_size = block_size;
+			block->flags = ULOG_COMPRESSED_BLOCK_FLAG_STORED;
+		}
+
+		block->data_size = data_size;
+		block->crc = ulog_compressed_block_crc(*block, block->data);
+
+		const ssize_t total_size = sizeof(ulog_compressed_block_s) + data_size;
+		const bool last_block = (written + block_size >= size);
+
+		if (buffer.write_to_file(block, total_size, call_fsync && last_block) != total_size) {
+			// report what was written so far, so that it is not written twice
+			return (written > 0) ? (int)written : -1;
+		}
+
+		written += block_size;
+	}
+
+	return written;
+}
+
 int LogWriterFile::write_message(LogType type, void *ptr, size_t size, uint64_t dropout_start)
 {
 	if (_need_reliable_transfer) {
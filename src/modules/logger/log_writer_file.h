@@ -136,6 +136,12 @@ public:
 
 	pthread_t thread_id() const { return _thread; }
 
+	/**
+	 * Enable compression of the full log (applies to the next started log).
+	 * The file then starts with a ulog_compressed_header_s, followed by independently compressed blocks.
+	 */
+	void set_compression(bool enable) { _compression_enabled = enable; }
+
 #if defined(PX4_CRYPTO)
 	void set_encryption_parameters(px4_crypto_algorithm_t algorithm, uint8_t key_idx,  uint8_t exchange_key_idx)
 	{
@@ -166,6 +172,11 @@ private:
 	/* 512 didn't seem to work properly, 4096 should match the FAT cluster size */
 	static constexpr size_t	_min_write_chunk = 4096;
 
+	/* maximum amount of (uncompressed) data per compressed block */
+	static constexpr size_t _compression_block_size = _min_write_chunk;
+
+	struct Compressor;
+
 	class LogFileBuffer
 	{
 	public:
@@ -202,6 +213,7 @@ private:
 		size_t count() const { return _count; }
 
 		bool _should_run = false;
+		bool _compressed = false;
 		px4::atomic_bool _had_write_error{false};
 	private:
 		size_t _buffer_size;
@@ -217,6 +229,20 @@ private:
 
 	LogFileBuffer _buffers[(int)LogType::Count];
 
+	/**
+	 * Write data from a log buffer to its file (compressing it if enabled)
+	 * @return number of bytes of ptr written, <0 on error
+	 */
+	int write_to_file(LogFileBuffer &buffer, void *ptr, size_t size, bool call_fsync);
+
+	int write_compressed(LogFileBuffer &buffer, const uint8_t *ptr, size_t size, bool call_fsync);
+
+	bool init_logfile_compression(const LogType type);
+
+	Compressor		*_compressor{nullptr}; ///< only accessed from the writer thread (once allocated)
+	bool			_compression_enabled{false};
+	perf_counter_t		_perf_compress{nullptr};
+
 	px4::atomic_bool	_exit_thread{false};
 	bool			_need_reliable_transfer{false};
 	px4::atomic_bool	_want_fsync{false};
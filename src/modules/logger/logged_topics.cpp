@@ -98,6 +98,7 @@ void LoggedTopics::add_default_topics()
 	add_topic("offboard_control_mode", 100);
 	add_topic("onboard_computer_status", 10);
 	add_topic("parameter_update");
+	add_optional_topic("perf_histogram");
 	add_topic("position_controller_status", 500);
 	add_topic("position_controller_landing_status", 100);
 	add_optional_topic("pure_pursuit_status", 100);
@@ -360,6 +361,14 @@ void LoggedTopics::add_mavlink_tunnel()
 	add_topic("mavlink_tunnel");
 }
 
+void LoggedTopics::add_perf_counter_topics()
+{
+	add_optional_topic("perf_counters");
+	add_optional_topic("perf_histogram");
+	add_optional_topic("work_item_trace");
+	add_topic("cpuload");
+}
+
 int LoggedTopics::add_topics_from_file(const char *fname)
 {
 	int ntopics = 0;
@@ -570,4 +579,8 @@ void LoggedTopics::initialize_configured_topics(SDLogProfileMask profile)
 	if (profile & SDLogProfileMask::MAVLINK_TUNNEL) {
 		add_mavlink_tunnel();
 	}
+
+	if (profile & SDLogProfileMask::PERF_COUNTERS) {
+		add_perf_counter_topics();
+	}
 }
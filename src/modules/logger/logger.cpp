@@ -191,8 +191,9 @@ int Logger::task_spawn(int argc, char *argv[])
 int Logger::print_status()
 {
 	PX4_INFO("Running in mode: %s", configured_backend_mode());
-	PX4_INFO("Number of subscriptions: %i (%i bytes)", _num_subscriptions,
-		 (int)(_num_subscriptions * sizeof(LoggerSubscription)));
+	PX4_INFO("Number of subscriptions: %i (%i bytes)%s", _num_subscriptions,
+		 (int)(_num_subscriptions * sizeof(LoggerSubscription)), _updated_topics ? ", event-driven" : "");
+	perf_print_counter(_topic_update_perf);
 
 	bool is_logging = false;
 
@@ -416,6 +417,9 @@ Logger::~Logger()
 
 	delete[](_msg_buffer);
 	delete[](_subscriptions);
+	delete[](_updated_topics);
+
+	perf_free(_topic_update_perf);
 }
 
 void Logger::update_params()
@@ -464,6 +468,10 @@ bool Logger::copy_if_updated(int sub_idx, void *buffer, bool try_to_subscribe)
 
 	} else if (try_to_subscribe) {
 		if (sub.subscribe()) {
+			if (_updated_topics) {
+				sub.registerCallback();
+			}
+
 			write_add_logged_msg(LogType::Full, sub);
 
 			if (sub_idx < _num_mission_subs) {
@@ -478,6 +486,57 @@ bool Logger::copy_if_updated(int sub_idx, void *buffer, bool try_to_subscribe)
 	return updated;
 }
 
+size_t Logger::write_subscription_update(int sub_idx, bool try_to_subscribe, hrt_abstime loop_time)
+{
+	LoggerSubscription &sub = _subscriptions[sub_idx];
+	size_t written = 0;
+
+	/* if this topic has been updated, copy the new data into the message buffer
+	 * and write a message to the log
+	 */
+	if (copy_if_updated(sub_idx, _msg_buffer + sizeof(ulog_message_data_s), try_to_subscribe)) {
+		// each message consists of a header followed by an orb data object
+		const size_t msg_size = sizeof(ulog_message_data_s) + sub.get_topic()->o_size_no_padding;
+		const uint16_t write_msg_size = static_cast<uint16_t>(msg_size - ULOG_MSG_HEADER_LEN);
+		const uint16_t write_msg_id = sub.msg_id;
+
+		//write one byte after another (necessary because of alignment)
+		_msg_buffer[0] = (uint8_t)write_msg_size;
+		_msg_buffer[1] = (uint8_t)(write_msg_size >> 8);
+		_msg_buffer[2] = static_cast<uint8_t>(ULogMessageType::DATA);
+		_msg_buffer[3] = (uint8_t)write_msg_id;
+		_msg_buffer[4] = (uint8_t)(write_msg_id >> 8);
+
+		// PX4_INFO("topic: %s, size = %zu, out_size = %zu", sub.get_topic()->o_name, sub.get_topic()->o_size, msg_size);
+
+		// full log
+		if (write_message(LogType::Full, _msg_buffer, msg_size)) {
+			written = msg_size;
+		}
+
+		// mission log
+		if (sub_idx < _num_mission_subs) {
+			if (_writer.is_started(LogType::Mission)) {
+				if (_mission_subscriptions[sub_idx].next_write_time < (loop_time / 100000)) {
+					unsigned delta_time = _mission_subscriptions[sub_idx].min_delta_ms;
+
+					if (delta_time > 0) {
+						_mission_subscriptions[sub_idx].next_write_time = (loop_time / 100000) + delta_time / 100;
+					}
+
+					write_message(LogType::Mission, _msg_buffer, msg_size);
+				}
+			}
+		}
+
+	} else if (_updated_topics && sub.valid() && (sub.get_interval_us() > 0)) {
+		// the update might have been held back by the topic interval: keep checking it until the interval passed
+		mark_updated(sub_idx);
+	}
+
+	return written;
+}
+
 const char *Logger::configured_backend_mode() const
 {
 	switch (_writer.backend()) {
@@ -549,19 +608,42 @@ bool Logger::initialize_topics()
 
 	delete[](_subscriptions);
 	_subscriptions = nullptr;
+	delete[](_updated_topics);
+	_updated_topics = nullptr;
 
 	if (logged_topics.subscriptions().count > 0) {
-		_subscriptions = new LoggerSubscription[logged_topics.subscriptions().count];
+		const int count = logged_topics.subscriptions().count;
+		_subscriptions = new LoggerSubscription[count];
 
 		if (!_subscriptions) {
 			PX4_ERR("alloc failed");
 			return false;
 		}
 
-		for (int i = 0; i < logged_topics.subscriptions().count; ++i) {
+		if (_param_sdlog_evt_drv.get()) {
+			_updated_topics = new px4::atomic<uint32_t>[(count + 31) / 32];
+
+			if (!_updated_topics) {
+				PX4_ERR("alloc failed");
+				return false;
+			}
+		}
+
+		for (int i = 0; i < count; ++i) {
 			const LoggedTopics::RequestedSubscription &sub = logged_topics.subscriptions().sub[i];
 			_subscriptions[i] = LoggerSubscription(sub.id, sub.interval_ms, sub.instance);
-			_subscriptions[i].subscribe();
+
+			if (_updated_topics) {
+				_subscriptions[i].updated_topics = _updated_topics;
+				_subscriptions[i].index = i;
+
+				if (_subscriptions[i].subscribe()) {
+					_subscriptions[i].registerCallback();
+				}
+
+			} else {
+				_subscriptions[i].subscribe();
+			}
 		}
 	}
 
@@ -749,53 +831,42 @@ void Logger::run()
 			/* wait for lock on log buffer */
 			_writer.lock();
 
-			for (int sub_idx = 0; sub_idx < _num_subscriptions; ++sub_idx) {
-				LoggerSubscription &sub = _subscriptions[sub_idx];
-				/* if this topic has been updated, copy the new data into the message buffer
-				 * and write a message to the log
-				 */
-				const bool try_to_subscribe = (sub_idx == next_subscribe_topic_index);
-
-				if (copy_if_updated(sub_idx, _msg_buffer + sizeof(ulog_message_data_s), try_to_subscribe)) {
-					// each message consists of a header followed by an orb data object
-					const size_t msg_size = sizeof(ulog_message_data_s) + sub.get_topic()->o_size_no_padding;
-					const uint16_t write_msg_size = static_cast<uint16_t>(msg_size - ULOG_MSG_HEADER_LEN);
-					const uint16_t write_msg_id = sub.msg_id;
+			perf_begin(_topic_update_perf);
 
-					//write one byte after another (necessary because of alignment)
-					_msg_buffer[0] = (uint8_t)write_msg_size;
-					_msg_buffer[1] = (uint8_t)(write_msg_size >> 8);
-					_msg_buffer[2] = static_cast<uint8_t>(ULogMessageType::DATA);
-					_msg_buffer[3] = (uint8_t)write_msg_id;
-					_msg_buffer[4] = (uint8_t)(write_msg_id >> 8);
-
-					// PX4_INFO("topic: %s, size = %zu, out_size = %zu", sub.get_topic()->o_name, sub.get_topic()->o_size, msg_size);
-
-					// full log
-					if (write_message(LogType::Full, _msg_buffer, msg_size)) {
-
-#ifdef DBGPRINT
-						total_bytes += msg_size;
-#endif /* DBGPRINT */
+			if (_updated_topics) {
+				// event-driven: only check the topics that got updated since the last iteration
+				if (!was_started) {
+					// log the current data of all topics when logging starts
+					for (int sub_idx = 0; sub_idx < _num_subscriptions; ++sub_idx) {
+						mark_updated(sub_idx);
 					}
+				}
+
+				if (next_subscribe_topic_index != -1) {
+					mark_updated(next_subscribe_topic_index);
+				}
 
-					// mission log
-					if (sub_idx < _num_mission_subs) {
-						if (_writer.is_started(LogType::Mission)) {
-							if (_mission_subscriptions[sub_idx].next_write_time < (loop_time / 100000)) {
-								unsigned delta_time = _mission_subscriptions[sub_idx].min_delta_ms;
+				const int num_words = (_num_subscriptions + 31) / 32;
 
-								if (delta_time > 0) {
-									_mission_subscriptions[sub_idx].next_write_time = (loop_time / 100000) + delta_time / 100;
-								}
+				for (int word = 0; word < num_words; ++word) {
+					uint32_t updated = _updated_topics[word].fetch_and(0);
 
-								write_message(LogType::Mission, _msg_buffer, msg_size);
-							}
+					for (int bit = 0; updated != 0; ++bit, updated >>= 1) {
+						if (updated & 1) {
+							const int sub_idx = word * 32 + bit;
+							total_bytes += write_subscription_update(sub_idx, sub_idx == next_subscribe_topic_index, loop_time);
 						}
 					}
 				}
+
+			} else {
+				for (int sub_idx = 0; sub_idx < _num_subscriptions; ++sub_idx) {
+					total_bytes += write_subscription_update(sub_idx, sub_idx == next_subscribe_topic_index, loop_time);
+				}
 			}
 
+			perf_end(_topic_update_perf);
+
 			// check for new events
 			handle_event_updates(total_bytes);
 
@@ -877,8 +948,10 @@ void Logger::run()
 			// - we avoid subscribing to many topics at once, when logging starts
 			// - we'll get the data immediately once we start logging (no need to wait for the next subscribe timeout)
 			if (next_subscribe_topic_index != -1) {
-				if (!_subscriptions[next_subscribe_topic_index].valid()) {
-					_subscriptions[next_subscribe_topic_index].subscribe();
+				LoggerSubscription &sub = _subscriptions[next_subscribe_topic_index];
+
+				if (!sub.valid() && sub.subscribe() && _updated_topics) {
+					sub.registerCallback();
 				}
 
 				if (++next_subscribe_topic_index >= _num_subscriptions) {
@@ -1303,15 +1376,19 @@ int Logger::get_log_file_name(LogType type, char *file_name, size_t file_name_si
 		replay_suffix = "_replayed";
 	}
 
-	const char *crypto_suffix = "";
+	const char *file_suffix = "";
 #if defined(PX4_CRYPTO)
 
 	if (_param_sdlog_crypto_algorithm.get() != 0) {
-		crypto_suffix = "e";
+		file_suffix = "e";
 	}
 
 #endif
 
+	if (type == LogType::Full && compression_enabled()) {
+		file_suffix = "z";
+	}
+
 	char *log_file_name = _file_name[(int)type].log_file_name;
 
 	if (time_ok) {
@@ -1324,7 +1401,7 @@ int Logger::get_log_file_name(LogType type, char *file_name, size_t file_name_si
 		char log_file_name_time[16] = "";
 		strftime(log_file_name_time, sizeof(log_file_name_time), "%H_%M_%S", &tt);
 		snprintf(log_file_name, sizeof(LogFileName::log_file_name), "%s%s.ulg%s", log_file_name_time, replay_suffix,
-			 crypto_suffix);
+			 file_suffix);
 		snprintf(file_name + n, file_name_size - n, "/%s", log_file_name);
 
 		if (notify) {
@@ -1355,7 +1432,7 @@ int Logger::get_log_file_name(LogType type, char *file_name, size_t file_name_si
 		while (file_number <= MAX_NO_LOGFILE) {
 			/* format log file path: e.g. /fs/microsd/log/sess001/log001.ulg */
 			snprintf(log_file_name, sizeof(LogFileName::log_file_name), "log%03" PRIu16 "%s.ulg%s", file_number, replay_suffix,
-				 crypto_suffix);
+				 file_suffix);
 			snprintf(file_name + n, file_name_size - n, "/%s", log_file_name);
 
 			if (!util::file_exist(file_name)) {
@@ -1420,6 +1497,7 @@ void Logger::start_log_file(LogType type)
 		_param_sdlog_crypto_key.get(),
 		_param_sdlog_crypto_exchange_key.get());
 #endif
+	_writer.set_compression(compression_enabled());
 
 	if (_writer.start_log_file(type, file_name)) {
 		_writer.select_write_backend(LogWriter::BackendFile);
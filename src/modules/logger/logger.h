@@ -44,12 +44,15 @@
 #include <version/version.h>
 #include <parameters/param.h>
 #include <px4_platform_common/printload.h>
+#include <px4_platform_common/atomic.h>
 #include <px4_platform_common/module.h>
 #include <px4_platform_common/module_params.h>
+#include <lib/perf/perf_counter.h>
 
 #include <uORB/PublicationMulti.hpp>
 #include <uORB/Subscription.hpp>
 #include <uORB/SubscriptionInterval.hpp>
+#include <uORB/SubscriptionCallback.hpp>
 #include <uORB/topics/logger_status.h>
 #include <uORB/topics/log_message.h>
 #include <uORB/topics/manual_control_setpoint.h>
@@ -71,13 +74,28 @@ namespace logger
 
 static constexpr uint8_t MSG_ID_INVALID = UINT8_MAX;
 
-struct LoggerSubscription : public uORB::SubscriptionInterval {
-	LoggerSubscription() = default;
+/**
+ * Logged topic. In event-driven mode (SDLOG_EVT_DRV) the subscription registers an update callback,
+ * which marks the topic in the logger's update bitmap, so that the logger only needs to check updated topics.
+ */
+struct LoggerSubscription : public uORB::SubscriptionCallback {
+	LoggerSubscription() : uORB::SubscriptionCallback(nullptr) {}
 
 	LoggerSubscription(ORB_ID id, uint32_t interval_ms = 0, uint8_t instance = 0) :
-		uORB::SubscriptionInterval(id, interval_ms * 1000, instance)
+		uORB::SubscriptionCallback(get_orb_meta(id), interval_ms * 1000, instance)
 	{}
 
+	void call() override
+	{
+		// called from the publisher's context
+		if (updated_topics) {
+			updated_topics[index / 32].fetch_or(1u << (index % 32));
+		}
+	}
+
+	px4::atomic<uint32_t> *updated_topics{nullptr}; ///< update bitmap, only set in event-driven mode
+	uint16_t index{0}; ///< index of the subscription in the bitmap
+
 	uint8_t msg_id{MSG_ID_INVALID};
 };
 
@@ -228,6 +246,19 @@ private:
 		       && (_writer.backend() & LogWriter::BackendMavlink) != 0;
 	}
 
+	/** check if the full log file is written compressed (not supported together with encryption) */
+	bool compression_enabled()
+	{
+#if defined(PX4_CRYPTO)
+
+		if (_param_sdlog_crypto_algorithm.get() != 0) {
+			return false;
+		}
+
+#endif
+		return _param_sdlog_compress.get();
+	}
+
 	/** get the configured backend as string */
 	const char *configured_backend_mode() const;
 
@@ -280,6 +311,22 @@ private:
 
 	inline bool copy_if_updated(int sub_idx, void *buffer, bool try_to_subscribe);
 
+	/**
+	 * Check a subscription for updates and write it to the full & mission log
+	 * @return number of bytes written to the full log
+	 */
+	size_t write_subscription_update(int sub_idx, bool try_to_subscribe, hrt_abstime loop_time);
+
+	/**
+	 * In event-driven mode, mark a subscription to be checked in the next logger iteration
+	 */
+	void mark_updated(int sub_idx)
+	{
+		if (_updated_topics) {
+			_updated_topics[sub_idx / 32].fetch_or(1u << (sub_idx % 32));
+		}
+	}
+
 	/**
 	 * Write exactly one ulog message to the logger and handle dropouts.
 	 * Must be called with _writer.lock() held.
@@ -354,6 +401,7 @@ private:
 
 	LoggerSubscription	 			*_subscriptions{nullptr}; ///< all subscriptions for full & mission log (in front)
 	int						_num_subscriptions{0};
+	px4::atomic<uint32_t>				*_updated_topics{nullptr}; ///< update bitmap of _subscriptions (event-driven mode only)
 	MissionSubscription 				_mission_subscriptions[MAX_MISSION_TOPICS_NUM] {}; ///< additional data for mission subscriptions
 	int						_num_mission_subs{0};
 	LoggerSubscription				_event_subscription; ///< Subscription for the event topic (handled separately)
@@ -383,6 +431,8 @@ private:
 
 	uint32_t					_message_gaps{0};
 
+	perf_counter_t					_topic_update_perf{perf_alloc(PC_ELAPSED, "logger: topic updates")};
+
 	timer_callback_data_s				_timer_callback_data{};
 
 	uORB::Subscription				_manual_control_setpoint_sub{ORB_ID(manual_control_setpoint)};
@@ -397,7 +447,9 @@ private:
 		(ParamInt<px4::params::SDLOG_PROFILE>) _param_sdlog_profile,
 		(ParamInt<px4::params::SDLOG_MISSION>) _param_sdlog_mission,
 		(ParamBool<px4::params::SDLOG_BOOT_BAT>) _param_sdlog_boot_bat,
-		(ParamBool<px4::params::SDLOG_UUID>) _param_sdlog_uuid
+		(ParamBool<px4::params::SDLOG_UUID>) _param_sdlog_uuid,
+		(ParamBool<px4::params::SDLOG_EVT_DRV>) _param_sdlog_evt_drv,
+		(ParamBool<px4::params::SDLOG_COMPRESS>) _param_sdlog_compress
 #if defined(PX4_CRYPTO)
 		, (ParamInt<px4::params::SDLOG_ALGORITHM>) _param_sdlog_crypto_algorithm,
 		(ParamInt<px4::params::SDLOG_KEY>) _param_sdlog_crypto_key,
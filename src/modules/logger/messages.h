@@ -33,7 +33,9 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <crc32.h>
 
 enum class ULogMessageType : uint8_t {
 	FORMAT = 'F',
@@ -61,6 +63,60 @@ struct ulog_file_header_s {
 	uint64_t timestamp;
 };
 
+/** first bytes of a compressed log file, followed by ulog_compressed_block_s blocks */
+struct ulog_compressed_header_s {
+	/* magic identifying the file content */
+	uint8_t magic[7];
+
+	/* version of this header */
+	uint8_t hdr_ver;
+
+	/* file creation timestamp */
+	uint64_t timestamp;
+
+	/* compression algorithm (ULOG_COMPRESSION_HEATSHRINK) */
+	uint8_t algorithm;
+
+	/* algorithm parameters (heatshrink: window and lookahead size in bits) */
+	uint8_t window_bits;
+	uint8_t lookahead_bits;
+
+	uint8_t reserved;
+};
+
+#define ULOG_COMPRESSION_HEATSHRINK 1
+
+#define ULOG_COMPRESSED_BLOCK_MAGIC_0 'Z'
+#define ULOG_COMPRESSED_BLOCK_MAGIC_1 'B'
+#define ULOG_COMPRESSED_BLOCK_FLAG_STORED (1 << 0) ///< block data is not compressed
+
+/**
+ * Header of a compressed block. Each block is compressed independently, so that the data of a
+ * truncated or partially corrupted log can be recovered (a decoder can resync on the block magic).
+ * The CRC tells a real block apart from corrupt data that happens to contain the magic.
+ * The decompressed blocks concatenated form the ULog file.
+ */
+struct ulog_compressed_block_s {
+	uint8_t magic[2];
+	uint16_t data_size; ///< size of the (compressed) data following the header
+	uint16_t decompressed_size;
+	uint8_t flags;
+	uint8_t reserved;
+	uint32_t crc; ///< see ulog_compressed_block_crc()
+	uint8_t data[0];
+};
+
+/**
+ * CRC-32 of a compressed block: crc32() of the header fields data_size to reserved, continued over the
+ * data_size bytes of data (this is zlib.crc32(header_fields + data, 0xffffffff) ^ 0xffffffff).
+ */
+inline uint32_t ulog_compressed_block_crc(const ulog_compressed_block_s &block, const uint8_t *data)
+{
+	const size_t fields_offset = offsetof(ulog_compressed_block_s, data_size);
+	const uint8_t *fields = reinterpret_cast<const uint8_t *>(&block) + fields_offset;
+	return crc32part(data, block.data_size, crc32(fields, offsetof(ulog_compressed_block_s, crc) - fields_offset));
+}
+
 /** first bytes of the crypto key file */
 struct ulog_key_header_s {
 	/* magic identifying the file content */
@@ -127,9 +127,10 @@ PARAM_DEFINE_INT32(SDLOG_MISSION, 0);
  * 8 : Raw FIFO high-rate IMU (Gyro)
  * 9 : Raw FIFO high-rate IMU (Accel)
  * 10: Logging of mavlink tunnel message (useful for payload communication debugging)
+ * 11: Perf counter telemetry (perf_counters, perf_histogram, see PERF_TLM_EN) and work queue traces (work_item_trace)
  *
  * @min 0
- * @max 2047
+ * @max 4095
  * @bit 0 Default set (general log analysis)
  * @bit 1 Estimator replay (EKF2)
  * @bit 2 Thermal calibration
@@ -141,6 +142,7 @@ PARAM_DEFINE_INT32(SDLOG_MISSION, 0);
  * @bit 8 Raw FIFO high-rate IMU (Gyro)
  * @bit 9 Raw FIFO high-rate IMU (Accel)
  * @bit 10 Mavlink tunnel message logging
+ * @bit 11 Perf counter telemetry
  * @reboot_required true
  * @group SD Logging
  */
@@ -177,6 +179,36 @@ PARAM_DEFINE_INT32(SDLOG_DIRS_MAX, 0);
  */
 PARAM_DEFINE_INT32(SDLOG_UUID, 1);
 
+/**
+ * Event-driven topic updates
+ *
+ * If enabled, the logged topics notify the logger on each publication, and the logger
+ * only checks the updated topics instead of polling all of them in every iteration.
+ * This shortens the logger iteration with large topic sets (e.g. the debug or high rate profiles),
+ * but moves work to the publishers: every publication of a logged topic notifies the logger.
+ * The total CPU load is about the same, so only enable it if the logger itself is too slow.
+ *
+ * @boolean
+ * @reboot_required true
+ * @group SD Logging
+ */
+PARAM_DEFINE_INT32(SDLOG_EVT_DRV, 0);
+
+/**
+ * Compress log files
+ *
+ * If enabled, the full log is written compressed (.ulgz file), reducing the SD card bandwidth
+ * needed for high rate logging. The data is compressed in independent blocks, so that truncated
+ * logs can still be recovered. Use Tools/decompress_ulog.py to convert a log back to a .ulg file.
+ * Replay reads compressed logs directly.
+ *
+ * Not used if log encryption is enabled (SDLOG_ALGORITHM).
+ *
+ * @boolean
+ * @group SD Logging
+ */
+PARAM_DEFINE_INT32(SDLOG_COMPRESS, 0);
+
 /**
  * Logfile Encryption algorithm
  *
@@ -0,0 +1,157 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file mavlink_frame_parser.cpp
+ * Parser for a buffer of received MAVLink data.
+ */
+
+#include "mavlink_frame_parser.h"
+
+#include <string.h>
+
+size_t
+MavlinkFrameParser::parse(mavlink_channel_t channel, const uint8_t *buf, size_t len, size_t keep_max,
+			  mavlink_message_t msgs[], int max_msgs, int &received)
+{
+	mavlink_status_t *status = mavlink_get_channel_status(channel);
+	size_t i = 0;
+	received = 0;
+
+	while ((i < len) && (received < max_msgs)) {
+		if ((buf[i] == MAVLINK_STX)
+		    && ((status->parse_state == MAVLINK_PARSE_STATE_IDLE)
+			|| (status->parse_state == MAVLINK_PARSE_STATE_UNINIT))) {
+
+			const size_t remaining = len - i;
+			const size_t frame_len = MAVLINK_NUM_NON_PAYLOAD_BYTES + ((remaining > 1) ? buf[i + 1] : 0);
+
+			if (remaining < frame_len) {
+				if (frame_len <= keep_max) {
+					// wait for the rest of the frame
+					break;
+				}
+
+			} else if (parse_frame(status, &buf[i], msgs[received])) {
+				received++;
+				i += frame_len;
+				continue;
+			}
+		}
+
+		if (mavlink_parse_char(channel, buf[i], &msgs[received], &_status)) {
+			received++;
+		}
+
+		i++;
+	}
+
+	return i;
+}
+
+bool
+MavlinkFrameParser::parse_frame(mavlink_status_t *status, const uint8_t *frame, mavlink_message_t &msg)
+{
+	const uint8_t payload_len = frame[1];
+	const uint8_t incompat_flags = frame[2];
+
+	if ((incompat_flags != 0) || (status->signing != nullptr)) {
+		return false;
+	}
+
+	const uint32_t msgid = frame[7] | (frame[8] << 8) | ((uint32_t)frame[9] << 16);
+	const mavlink_msg_entry_t *entry = mavlink_get_msg_entry(msgid);
+
+#if defined(MAVLINK_CHECK_MESSAGE_LENGTH)
+
+	if ((entry != nullptr) && ((payload_len < entry->min_msg_len) || (payload_len > entry->max_msg_len))) {
+		return false;
+	}
+
+#endif // MAVLINK_CHECK_MESSAGE_LENGTH
+
+	// checksum over the header without STX, the payload and the CRC extra byte
+	uint16_t checksum;
+	crc_init(&checksum);
+	crc_accumulate_buffer(&checksum, (const char *)&frame[1], MAVLINK_CORE_HEADER_LEN + payload_len);
+	crc_accumulate((entry != nullptr) ? entry->crc_extra : 0, &checksum);
+
+	const uint8_t *ck = &frame[MAVLINK_NUM_HEADER_BYTES + payload_len];
+
+	if ((ck[0] != (checksum & 0xFF)) || (ck[1] != (checksum >> 8))) {
+		return false;
+	}
+
+	msg.checksum = checksum;
+	msg.magic = MAVLINK_STX;
+	msg.len = payload_len;
+	msg.incompat_flags = incompat_flags;
+	msg.compat_flags = frame[3];
+	msg.seq = frame[4];
+	msg.sysid = frame[5];
+	msg.compid = frame[6];
+	msg.msgid = msgid;
+	memcpy(_MAV_PAYLOAD_NON_CONST(&msg), &frame[MAVLINK_NUM_HEADER_BYTES], payload_len);
+
+	// zero-fill truncated payloads
+	if ((entry != nullptr) && (payload_len < entry->max_msg_len)) {
+		memset(&_MAV_PAYLOAD_NON_CONST(&msg)[payload_len], 0, entry->max_msg_len - payload_len);
+	}
+
+	msg.ck[0] = ck[0];
+	msg.ck[1] = ck[1];
+
+	// channel and receiver status as left by mavlink_parse_char() after a complete frame
+	status->flags &= ~MAVLINK_STATUS_FLAG_IN_MAVLINK1;
+	status->msg_received = MAVLINK_FRAMING_OK;
+	status->parse_state = MAVLINK_PARSE_STATE_IDLE;
+	status->packet_idx = payload_len;
+	status->current_rx_seq = msg.seq;
+
+	if (status->packet_rx_success_count == 0) {
+		status->packet_rx_drop_count = 0;
+	}
+
+	status->packet_rx_success_count++;
+
+	_status.parse_state = status->parse_state;
+	_status.packet_idx = status->packet_idx;
+	_status.current_rx_seq = status->current_rx_seq + 1;
+	_status.packet_rx_success_count = status->packet_rx_success_count;
+	_status.packet_rx_drop_count = status->parse_error;
+	_status.flags = status->flags;
+
+	status->parse_error = 0;
+
+	return true;
+}
@@ -0,0 +1,82 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file mavlink_frame_parser.h
+ * Parser for a buffer of received MAVLink data.
+ */
+
+#pragma once
+
+#include "mavlink_bridge_header.h"
+
+#include <stddef.h>
+
+/**
+ * Complete MAVLink 2 frames found at a frame boundary are validated and decoded directly
+ * out of the receive buffer. Everything else (MAVLink 1, signed frames, CRC errors,
+ * resynchronisation) goes through mavlink_parse_char(), and the fast path leaves the
+ * channel and receiver status exactly as mavlink_parse_char() would.
+ */
+class MavlinkFrameParser
+{
+public:
+	/**
+	 * Parse messages out of a receive buffer.
+	 *
+	 * @param channel MAVLink channel, its status is updated
+	 * @param msgs output: the parsed messages
+	 * @param max_msgs size of msgs, parsing stops once it is full
+	 * @param received output: number of parsed messages
+	 * @param keep_max maximum length of an incomplete frame at the end of the buffer that is
+	 *                 left for the next call instead of feeding it to the byte parser
+	 * @return number of consumed bytes
+	 */
+	size_t parse(mavlink_channel_t channel, const uint8_t *buf, size_t len, size_t keep_max,
+		     mavlink_message_t msgs[], int max_msgs, int &received);
+
+	/**
+	 * Receiver status, as returned by mavlink_parse_char().
+	 */
+	const mavlink_status_t &status() const { return _status; }
+
+private:
+	/**
+	 * Take a complete MAVLink 2 frame, with the same checks and status updates as mavlink_parse_char().
+	 *
+	 * @return false if the frame has to go through the byte parser (signed, incompatible flags or bad CRC)
+	 */
+	bool parse_frame(mavlink_status_t *status, const uint8_t *frame, mavlink_message_t &msg);
+
+	mavlink_status_t _status{}; ///< receiver status, used for mavlink_parse_char()
+};
@@ -37,11 +37,17 @@
 #include <crc32.h>
 #include <unistd.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <fcntl.h>
 #include <sys/stat.h>
 #include <errno.h>
 #include <cstring>
 
+#include <parameters/param.h>
+
+#define HEATSHRINK_DYNAMIC_ALLOC 0
+#include <lib/heatshrink/heatshrink/heatshrink_encoder.h>
+
 #include "mavlink_ftp.h"
 #include "mavlink_tests/mavlink_ftp_test.h"
 
@@ -50,6 +56,7 @@
 using namespace time_literals;
 
 constexpr const char MavlinkFTP::_root_dir[];
+constexpr const char MavlinkFTP::_param_dir[];
 
 MavlinkFTP::MavlinkFTP(Mavlink &mavlink) :
 	_mavlink(mavlink)
@@ -60,6 +67,10 @@ MavlinkFTP::MavlinkFTP(Mavlink &mavlink) :
 
 MavlinkFTP::~MavlinkFTP()
 {
+	if (_session_info.fd >= 0) {
+		_closeSession();
+	}
+
 	delete[] _work_buffer1;
 	delete[] _work_buffer2;
 }
@@ -508,7 +519,20 @@ MavlinkFTP::_workOpen(PayloadHeader *payload, int oflag)
 		return kErrNoSessionsAvailable;
 	}
 
-	_constructPath(_work_buffer1, _work_buffer1_len, _data_as_cstring(payload));
+	const char *path = _data_as_cstring(payload);
+	const bool param_file = oflag == O_RDONLY && strncmp(path, _param_dir, _param_dir_len) == 0;
+
+	if (param_file) {
+		// generate the parameter file, which is then read like any other file
+		ErrorCode ret = _generateParamFile(path + _param_dir_len);
+
+		if (ret != kErrNone) {
+			return ret;
+		}
+
+	} else {
+		_constructPath(_work_buffer1, _work_buffer1_len, path);
+	}
 
 	PX4_DEBUG("FTP: open '%s'", _work_buffer1);
 
@@ -522,6 +546,11 @@ MavlinkFTP::_workOpen(PayloadHeader *payload, int oflag)
 		if (oflag & O_RDONLY) {
 			_our_errno = errno;
 			PX4_ERR("stat failed read: %s", strerror(_our_errno));
+
+			if (param_file) {
+				_removeParamFiles();
+			}
+
 			return kErrFailErrno;
 
 		} else {
@@ -538,12 +567,19 @@ MavlinkFTP::_workOpen(PayloadHeader *payload, int oflag)
 	if (fd < 0) {
 		_our_errno = errno;
 		PX4_ERR("open failed: %s", strerror(_our_errno));
+
+		if (param_file) {
+			_removeParamFiles();
+		}
+
 		return kErrFailErrno;
 	}
 
 	_session_info.fd = fd;
 	_session_info.file_size = fileSize;
 	_session_info.stream_download = false;
+	// the generated parameter files only live as long as the session, see _closeSession()
+	_session_info.param_file = param_file;
 
 	payload->session = 0;
 	payload->size = sizeof(uint32_t);
@@ -552,6 +588,180 @@ MavlinkFTP::_workOpen(PayloadHeader *payload, int oflag)
 	return kErrNone;
 }
 
+MavlinkFTP::ErrorCode
+MavlinkFTP::_generateParamFile(const char *name)
+{
+	// optional hash of the parameter set the client has: only the parameters changed since are exported
+	uint32_t since_hash = 0;
+	const char *query = strchr(name, '?');
+	const size_t name_len = query ? query - name : strlen(name);
+
+	if (query) {
+		static constexpr const char since[] = "?since=";
+
+		if (strncmp(query, since, sizeof(since) - 1) != 0) {
+			_our_errno = ENOENT;
+			return kErrFailErrno;
+		}
+
+		since_hash = strtoul(query + sizeof(since) - 1, nullptr, 0);
+	}
+
+	static constexpr const char bson_name[] = "param.bson";
+	static constexpr const char compressed_name[] = "param.bson.hs";
+	bool compress = false;
+
+	if (name_len == sizeof(compressed_name) - 1 && strncmp(name, compressed_name, name_len) == 0) {
+		compress = true;
+
+	} else if (name_len != sizeof(bson_name) - 1 || strncmp(name, bson_name, name_len) != 0) {
+		_our_errno = ENOENT;
+		return kErrFailErrno;
+	}
+
+	char bson_path[64];
+	_paramFilePath(bson_path, sizeof(bson_path));
+
+	const int param_count = param_export_delta(bson_path, since_hash);
+
+	if (param_count < 0) {
+		_our_errno = EIO;
+		PX4_ERR("parameter export failed");
+		_removeParamFiles();
+		return kErrFailErrno;
+	}
+
+	PX4_DEBUG("FTP: exported %d parameters (since hash %" PRIu32 ")", param_count, since_hash);
+
+	if (compress) {
+		snprintf(_work_buffer1, _work_buffer1_len, "%s.hs", bson_path);
+
+		if (!_compressFile(bson_path, _work_buffer1)) {
+			_our_errno = EIO;
+			PX4_ERR("parameter compression failed");
+			_removeParamFiles();
+			return kErrFailErrno;
+		}
+
+	} else {
+		strncpy(_work_buffer1, bson_path, _work_buffer1_len);
+		_work_buffer1[_work_buffer1_len - 1] = '\0';
+	}
+
+	return kErrNone;
+}
+
+void
+MavlinkFTP::_paramFilePath(char *dst, size_t dst_len)
+{
+	// each mavlink instance has its own files, so that transfers on different links do not interfere
+	snprintf(dst, dst_len, PX4_STORAGEDIR "/.param%" PRIu8 ".bson", _getServerChannel());
+}
+
+void
+MavlinkFTP::_closeSession()
+{
+	::close(_session_info.fd);
+	_session_info.fd = -1;
+	_session_info.stream_download = false;
+
+	if (_session_info.param_file) {
+		_removeParamFiles();
+		_session_info.param_file = false;
+	}
+}
+
+void
+MavlinkFTP::_removeParamFiles()
+{
+	char path[64];
+	_paramFilePath(path, sizeof(path));
+	::unlink(path);
+	strncat(path, ".hs", sizeof(path) - strlen(path) - 1);
+	::unlink(path);
+}
+
+bool
+MavlinkFTP::_compressFile(const char *src_path, const char *dst_path)
+{
+	// the encoder holds the window (a few hundred bytes), only allocate it while compressing
+	heatshrink_encoder *encoder = new heatshrink_encoder;
+
+	if (encoder == nullptr) {
+		return false;
+	}
+
+	int src_fd = ::open(src_path, O_RDONLY);
+	int dst_fd = ::open(dst_path, O_CREAT | O_TRUNC | O_WRONLY, PX4_O_MODE_666);
+
+	uint8_t *in = reinterpret_cast<uint8_t *>(_work_buffer2);
+	uint8_t out[128];
+	bool success = src_fd >= 0 && dst_fd >= 0;
+
+	// write out everything the encoder has ready
+	auto drain = [&]() {
+		HSE_poll_res res;
+
+		do {
+			size_t output_size = 0;
+			res = heatshrink_encoder_poll(encoder, out, sizeof(out), &output_size);
+
+			if (res < 0 || ::write(dst_fd, out, output_size) != static_cast<ssize_t>(output_size)) {
+				return false;
+			}
+		} while (res == HSER_POLL_MORE);
+
+		return true;
+	};
+
+	heatshrink_encoder_reset(encoder);
+
+	while (success) {
+		const ssize_t bytes_read = ::read(src_fd, in, _work_buffer2_len);
+
+		if (bytes_read <= 0) {
+			success = bytes_read == 0;
+			break;
+		}
+
+		size_t in_pos = 0;
+
+		while (success && in_pos < static_cast<size_t>(bytes_read)) {
+			size_t sunk = 0;
+
+			if (heatshrink_encoder_sink(encoder, in + in_pos, bytes_read - in_pos, &sunk) < 0) {
+				success = false;
+			}
+
+			in_pos += sunk;
+			success = success && drain();
+		}
+	}
+
+	if (success) {
+		HSE_finish_res res = heatshrink_encoder_finish(encoder);
+
+		while (success && res == HSER_FINISH_MORE) {
+			success = drain();
+			res = heatshrink_encoder_finish(encoder);
+		}
+
+		success = success && res == HSER_FINISH_DONE;
+	}
+
+	if (src_fd >= 0) {
+		::close(src_fd);
+	}
+
+	if (dst_fd >= 0) {
+		::close(dst_fd);
+	}
+
+	delete encoder;
+
+	return success;
+}
+
 /// @brief Responds to a Read command
 MavlinkFTP::ErrorCode
 MavlinkFTP::_workRead(PayloadHeader *payload)
@@ -795,9 +1005,7 @@ MavlinkFTP::_workTerminate(PayloadHeader *payload)
 	}
 
 	PX4_DEBUG("work terminate: close");
-	::close(_session_info.fd);
-	_session_info.fd = -1;
-	_session_info.stream_download = false;
+	_closeSession();
 
 	payload->size = 0;
 
@@ -811,9 +1019,7 @@ MavlinkFTP::_workReset(PayloadHeader *payload)
 	PX4_DEBUG("work reset: close");
 
 	if (_session_info.fd != -1) {
-		::close(_session_info.fd);
-		_session_info.fd = -1;
-		_session_info.stream_download = false;
+		_closeSession();
 	}
 
 	payload->size = 0;
@@ -1030,9 +1236,7 @@ void MavlinkFTP::send()
 	} else if (_session_info.fd != -1) {
 		// close session without activity
 		if (hrt_elapsed_time(&_last_work_buffer_access) > 10_s) {
-			::close(_session_info.fd);
-			_session_info.fd = -1;
-			_session_info.stream_download = false;
+			_closeSession();
 			_last_reply_valid = false;
 			PX4_WARN("Session was closed without activity");
 		}
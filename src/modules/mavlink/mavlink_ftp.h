@@ -147,6 +147,28 @@ private:
 	ErrorCode	_workRename(PayloadHeader *payload);
 	ErrorCode	_workCalcFileCRC32(PayloadHeader *payload);
 
+	/**
+	 * Generate a virtual parameter file (@PARAM/param.bson[.hs][?since=<hash>]).
+	 * The path of the generated file is stored in _work_buffer1.
+	 * @param name file name after the @PARAM/ prefix
+	 */
+	ErrorCode	_generateParamFile(const char *name);
+
+	/**
+	 * Compress a file with heatshrink (window and lookahead size as for the compressed uORB message formats)
+	 * @return true on success
+	 */
+	bool		_compressFile(const char *src_path, const char *dst_path);
+
+	/// Path of the generated parameter file of this mavlink instance (the compressed file has a .hs suffix)
+	void		_paramFilePath(char *dst, size_t dst_len);
+
+	/// Remove the generated parameter files of this mavlink instance (if present)
+	void		_removeParamFiles();
+
+	/// Close the session file, and remove it if it is a generated parameter file
+	void		_closeSession();
+
 	uint8_t _getServerSystemId(void);
 	uint8_t _getServerComponentId(void);
 	uint8_t _getServerChannel(void);
@@ -180,6 +202,7 @@ private:
 		uint8_t		stream_target_system_id;
 		uint8_t         stream_target_component_id;
 		unsigned	stream_chunk_transmitted;
+		bool		param_file;	///< the session file is a generated parameter file
 	};
 	struct SessionInfo _session_info {};	///< Session info, fd=-1 for no active session
 
@@ -208,6 +231,11 @@ private:
 #endif
 	static constexpr const int _root_dir_len = sizeof(_root_dir) - 1;
 
+	// virtual directory of the parameter files, generated on open: the full parameter set, or the parameters
+	// changed since the parameter hash (_HASH_CHECK) a client already has
+	static constexpr const char _param_dir[] = "@PARAM/";
+	static constexpr const int _param_dir_len = sizeof(_param_dir) - 1;
+
 	bool _last_reply_valid = false;
 	uint8_t _last_reply[MAVLINK_MSG_ID_FILE_TRANSFER_PROTOCOL_LEN - MAVLINK_MSG_FILE_TRANSFER_PROTOCOL_FIELD_PAYLOAD_LEN
 								      + sizeof(PayloadHeader) + sizeof(uint32_t)];
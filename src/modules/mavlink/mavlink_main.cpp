@@ -766,6 +766,18 @@ void Mavlink::send_finish()
 		return;
 	}
 
+#if defined(MAVLINK_UDP)
+
+	if (_udp_batch != nullptr) {
+		// packet is sent with the rest of this iteration in udp_batch_send()
+		udp_batch_add();
+		_buf_fill = 0;
+		pthread_mutex_unlock(&_send_mutex);
+		return;
+	}
+
+#endif // MAVLINK_UDP
+
 	int ret = -1;
 
 	// send message to UART
@@ -782,11 +794,15 @@ void Mavlink::send_finish()
 		if (_src_addr_initialized) {
 # endif // CONFIG_NET
 			ret = sendto(_socket_fd, _buf, _buf_fill, 0, (struct sockaddr *)&_src_addr, sizeof(_src_addr));
+			_udp_tx_syscalls++;
 # if defined(CONFIG_NET)
 		}
 
 # endif // CONFIG_NET
 
+		_udp_tx_packets++;
+		_udp_tx_datagrams++;
+
 		if ((_mode != MAVLINK_MODE_ONBOARD) && broadcast_enabled() &&
 		    (!get_client_source_initialized() || !is_gcs_connected())) {
 
@@ -797,6 +813,7 @@ void Mavlink::send_finish()
 			if (_broadcast_address_found && _buf_fill > 0) {
 
 				int bret = sendto(_socket_fd, _buf, _buf_fill, 0, (struct sockaddr *)&_bcast_addr, sizeof(_bcast_addr));
+				_udp_tx_syscalls++;
 
 				if (bret <= 0) {
 					if (!_broadcast_failed_warned) {
@@ -841,6 +858,158 @@ void Mavlink::send_bytes(const uint8_t *buf, unsigned packet_len)
 }
 
 #ifdef MAVLINK_UDP
+void Mavlink::udp_batch_add()
+{
+	UdpBatch &batch = *_udp_batch;
+
+	if ((batch.count == 0) || (batch.len[batch.count - 1] + _buf_fill > UDP_BATCH_DATAGRAM_SIZE)) {
+		// start a new datagram, flush first if all are in use
+		if (batch.count == UDP_BATCH_DATAGRAMS) {
+			udp_batch_flush();
+		}
+
+		batch.len[batch.count] = 0;
+		batch.packets[batch.count] = 0;
+		batch.count++;
+	}
+
+	const unsigned i = batch.count - 1;
+	memcpy(&batch.buf[i][batch.len[i]], _buf, _buf_fill);
+	batch.len[i] += _buf_fill;
+	batch.packets[i]++;
+	_udp_tx_packets++;
+}
+
+void Mavlink::udp_batch_flush()
+{
+	UdpBatch &batch = *_udp_batch;
+
+	if (batch.count == 0) {
+		return;
+	}
+
+	// destinations: partner (index 0) and broadcast
+	const struct sockaddr_in *dest[2] {};
+	unsigned dest_count = 0;
+	bool partner = false;
+
+# if defined(CONFIG_NET)
+
+	if (_src_addr_initialized) {
+# endif // CONFIG_NET
+		dest[dest_count++] = &_src_addr;
+		partner = true;
+# if defined(CONFIG_NET)
+	}
+
+# endif // CONFIG_NET
+
+	if ((_mode != MAVLINK_MODE_ONBOARD) && broadcast_enabled() &&
+	    (!get_client_source_initialized() || !is_gcs_connected())) {
+
+		if (!_broadcast_address_found) {
+			find_broadcast_address();
+		}
+
+		if (_broadcast_address_found) {
+			dest[dest_count++] = &_bcast_addr;
+		}
+	}
+
+	// bytes sent per destination and datagram, -1 on error
+	int sent[2][UDP_BATCH_DATAGRAMS];
+
+	for (unsigned d = 0; d < dest_count; d++) {
+		for (unsigned i = 0; i < batch.count; i++) {
+			sent[d][i] = -1;
+		}
+	}
+
+# if defined(__PX4_LINUX)
+	// all datagrams to all destinations with a single system call
+	struct iovec iov[UDP_BATCH_DATAGRAMS];
+	struct mmsghdr msgs[2 * UDP_BATCH_DATAGRAMS] {};
+	unsigned msg_count = 0;
+
+	for (unsigned i = 0; i < batch.count; i++) {
+		iov[i].iov_base = batch.buf[i];
+		iov[i].iov_len = batch.len[i];
+	}
+
+	for (unsigned d = 0; d < dest_count; d++) {
+		for (unsigned i = 0; i < batch.count; i++) {
+			msgs[msg_count].msg_hdr.msg_name = (void *)dest[d];
+			msgs[msg_count].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+			msgs[msg_count].msg_hdr.msg_iov = &iov[i];
+			msgs[msg_count].msg_hdr.msg_iovlen = 1;
+			msg_count++;
+		}
+	}
+
+	if (msg_count > 0) {
+		int ret = sendmmsg(_socket_fd, msgs, msg_count, 0);
+		_udp_tx_syscalls++;
+
+		for (int m = 0; m < ret; m++) {
+			sent[m / batch.count][m % batch.count] = msgs[m].msg_len;
+		}
+	}
+
+# else
+
+	for (unsigned d = 0; d < dest_count; d++) {
+		for (unsigned i = 0; i < batch.count; i++) {
+			sent[d][i] = sendto(_socket_fd, batch.buf[i], batch.len[i], 0, (struct sockaddr *)dest[d],
+					    sizeof(struct sockaddr_in));
+			_udp_tx_syscalls++;
+		}
+	}
+
+# endif // __PX4_LINUX
+
+	for (unsigned i = 0; i < batch.count; i++) {
+		if (partner && (sent[0][i] == (int)batch.len[i])) {
+			_tstatus.tx_message_count += batch.packets[i];
+			count_txbytes(batch.len[i]);
+			_last_write_success_time = _last_write_try_time;
+
+		} else {
+			count_txerrbytes(batch.len[i]);
+		}
+	}
+
+	if (dest_count > (partner ? 1u : 0u)) {
+		const unsigned d = dest_count - 1;
+		bool bcast_failed = false;
+
+		for (unsigned i = 0; i < batch.count; i++) {
+			bcast_failed |= (sent[d][i] <= 0);
+		}
+
+		if (bcast_failed) {
+			if (!_broadcast_failed_warned) {
+				PX4_ERR("sending broadcast failed, errno: %d: %s", errno, strerror(errno));
+				_broadcast_failed_warned = true;
+			}
+
+		} else {
+			_broadcast_failed_warned = false;
+		}
+	}
+
+	_udp_tx_datagrams += batch.count;
+	batch.count = 0;
+}
+
+void Mavlink::udp_batch_send()
+{
+	if (_udp_batch != nullptr) {
+		pthread_mutex_lock(&_send_mutex);
+		udp_batch_flush();
+		pthread_mutex_unlock(&_send_mutex);
+	}
+}
+
 void Mavlink::find_broadcast_address()
 {
 	struct ifconf ifconf;
@@ -1185,9 +1354,11 @@ Mavlink::configure_stream(const char *stream_name, const float rate)
 			if (interval != 0) {
 				/* set new interval */
 				stream->set_interval(interval);
+				_stream_scheduler.reschedule(stream);
 
 			} else {
 				/* delete stream */
+				_stream_scheduler.remove(stream);
 				_streams.deleteNode(stream);
 				return OK; // must finish with loop after node is deleted
 			}
@@ -1202,6 +1373,12 @@ Mavlink::configure_stream(const char *stream_name, const float rate)
 
 	if (stream != nullptr) {
 		stream->set_interval(interval);
+
+		if (!_stream_scheduler.add(stream)) {
+			delete stream;
+			return PX4_ERROR;
+		}
+
 		_streams.add(stream);
 
 		return OK;
@@ -1296,33 +1473,15 @@ Mavlink::close_shell()
 void
 Mavlink::update_rate_mult()
 {
-	float const_rate = 0.0f;
-	float rate = 0.0f;
+	/* requested bandwidth of the streams per priority class */
+	float requested[MavlinkStream::PRIORITY_COUNT] {};
 
-	/* scale down rates if their theoretical bandwidth is exceeding the link bandwidth */
 	for (const auto &stream : _streams) {
-		if (stream->const_rate()) {
-			const_rate += (stream->get_interval() > 0) ? stream->get_size_avg() * 1000000.0f / stream->get_interval() : 0;
-
-		} else {
-			rate += (stream->get_interval() > 0) ? stream->get_size_avg() * 1000000.0f / stream->get_interval() : 0;
+		if (stream->get_interval() > 0) {
+			requested[(unsigned)stream->get_priority()] += stream->get_size_avg() * 1000000.0f / stream->get_interval();
 		}
 	}
 
-	float mavlink_ulog_streaming_rate_inv = 1.0f;
-
-	if (_mavlink_ulog) {
-		mavlink_ulog_streaming_rate_inv = 1.0f - _mavlink_ulog->current_data_rate();
-	}
-
-	/* scale up and down as the link permits */
-	float bandwidth_mult = (float)(_datarate * mavlink_ulog_streaming_rate_inv - const_rate) / rate;
-
-	/* if we do not have flow control, limit to the set data rate */
-	if (!get_flow_control_enabled()) {
-		bandwidth_mult = fminf(1.0f, bandwidth_mult);
-	}
-
 	float hardware_mult = 1.0f;
 	bool log_radio_timeout = false;
 
@@ -1354,11 +1513,37 @@ Mavlink::update_rate_mult()
 		PX4_ERR("instance %d: RADIO_STATUS timeout", _instance_id);
 	}
 
-	/* pick the minimum from bandwidth mult and hardware mult as limit */
-	_rate_mult = fminf(bandwidth_mult, hardware_mult);
+	/* link capacity, reduced by the radio TX buffer / TX error feedback */
+	const float capacity = _datarate * hardware_mult;
+
+	/* reserve the critical streams and the measured traffic outside of the streams
+	 * (command acks, mission and parameter protocol, forwarding, ULog streaming) */
+	const float other_rate = math::max(_tstatus.tx_rate_avg - _stream_scheduler.get_tx_rate(), 0.0f);
+	_tx_reserved_rate = requested[(unsigned)MavlinkStream::Priority::CRITICAL] + other_rate;
+
+	/* share the remaining bandwidth in order of priority */
+	float available = capacity - _tx_reserved_rate;
+	float requested_scaled = 0.0f;
+	float allocated_scaled = 0.0f;
+
+	for (unsigned priority = (unsigned)MavlinkStream::Priority::HIGH; priority < MavlinkStream::PRIORITY_COUNT; priority++) {
+		float mult = 1.0f;
+
+		if (requested[priority] > 0.0f) {
+			mult = available / requested[priority];
+		}
+
+		/* ensure the rate multiplier never drops below 5% so that something is always sent */
+		mult = math::constrain(mult, 0.05f, 1.0f);
+
+		_priority_rate_mult[priority] = mult;
+		available = math::max(available - requested[priority] * mult, 0.0f);
 
-	/* ensure the rate multiplier never drops below 5% so that something is always sent */
-	_rate_mult = math::constrain(_rate_mult, 0.05f, 1.0f);
+		requested_scaled += requested[priority];
+		allocated_scaled += requested[priority] * mult;
+	}
+
+	_rate_mult = (requested_scaled > 0.0f) ? (allocated_scaled / requested_scaled) : 1.0f;
 }
 
 void
@@ -1924,7 +2109,7 @@ Mavlink::task_main(int argc, char *argv[])
 	int temp_int_arg;
 #endif
 
-	while ((ch = px4_getopt(argc, argv, "b:r:d:n:u:o:m:t:c:F:fswxzZp", &myoptind, &myoptarg)) != EOF) {
+	while ((ch = px4_getopt(argc, argv, "b:r:d:n:u:o:m:t:c:F:fswxzZpB", &myoptind, &myoptarg)) != EOF) {
 		switch (ch) {
 		case 'b':
 			if (px4_get_parameter_value(myoptarg, _baudrate) != 0) {
@@ -2010,6 +2195,10 @@ Mavlink::task_main(int argc, char *argv[])
 			_mav_broadcast = BROADCAST_MODE_ON;
 			break;
 
+		case 'B':
+			_udp_batching = true;
+			break;
+
 #if defined(CONFIG_NET_IGMP) && defined(CONFIG_NET_ROUTE)
 
 		// multicast
@@ -2036,6 +2225,7 @@ Mavlink::task_main(int argc, char *argv[])
 #else
 
 		case 'p':
+		case 'B':
 		case 'u':
 		case 'o':
 		case 't':
@@ -2321,6 +2511,14 @@ Mavlink::task_main(int argc, char *argv[])
 	/* init socket if necessary */
 	if (get_protocol() == Protocol::UDP) {
 		init_udp();
+
+		if (_udp_batching) {
+			_udp_batch = new UdpBatch{};
+
+			if (_udp_batch == nullptr) {
+				PX4_ERR("UDP batch alloc failed, sending unbatched");
+			}
+		}
 	}
 
 #endif // MAVLINK_UDP
@@ -2340,15 +2538,39 @@ Mavlink::task_main(int argc, char *argv[])
 
 	_task_running.store(true);
 
+	hrt_abstime next_iteration = 0;
+
 	while (!should_exit()) {
 		/* main loop */
-		px4_usleep(_main_loop_delay);
+		if (should_transmit()) {
+			// sleep until the next iteration, the earliest due stream or a stream wakeup topic update
+			_stream_scheduler.wait(next_iteration);
+
+			const hrt_abstime now = hrt_absolute_time();
+
+			if (now < next_iteration) {
+				// in between iterations only update the due streams
+				_stream_scheduler.update(now, _main_loop_delay);
+#if defined(MAVLINK_UDP)
+				udp_batch_send();
+#endif // MAVLINK_UDP
+				continue;
+			}
+
+		} else {
+			px4_usleep(_main_loop_delay);
+		}
+
+		next_iteration = hrt_absolute_time() + _main_loop_delay;
 
 		if (!should_transmit()) {
 			check_requested_subscriptions();
 			handleStatus();
 			handleCommands();
 			handleAndGetCurrentCommandAck();
+#if defined(MAVLINK_UDP)
+			udp_batch_send();
+#endif // MAVLINK_UDP
 			continue;
 		}
 
@@ -2392,11 +2614,11 @@ Mavlink::task_main(int argc, char *argv[])
 
 		check_requested_subscriptions();
 
-		/* update streams */
-		for (const auto &stream : _streams) {
-			stream->update(t);
+		/* update due streams */
+		_stream_scheduler.update(t, _main_loop_delay);
 
-			if (!_first_heartbeat_sent) {
+		if (!_first_heartbeat_sent) {
+			for (const auto &stream : _streams) {
 				if (_mode == MAVLINK_MODE_IRIDIUM) {
 					if (stream->get_id() == MAVLINK_MSG_ID_HIGH_LATENCY2) {
 						_first_heartbeat_sent = stream->first_message_sent();
@@ -2480,6 +2702,8 @@ Mavlink::task_main(int argc, char *argv[])
 				_tstatus.tx_error_rate_avg = _bytes_txerr / dt;
 				_tstatus.rx_rate_avg = _bytes_rx / dt;
 
+				_stream_scheduler.update_rates(dt);
+
 				_bytes_tx = 0;
 				_bytes_txerr = 0;
 				_bytes_rx = 0;
@@ -2493,15 +2717,26 @@ Mavlink::task_main(int argc, char *argv[])
 			publish_telemetry_status();
 		}
 
+#if defined(MAVLINK_UDP)
+		// send everything queued in this iteration
+		udp_batch_send();
+#endif // MAVLINK_UDP
+
 		perf_end(_loop_perf);
 	}
 
 	_receiver.stop();
 
+#if defined(MAVLINK_UDP)
+	delete _udp_batch;
+	_udp_batch = nullptr;
+#endif // MAVLINK_UDP
+
 	delete _subscribe_to_stream;
 	_subscribe_to_stream = nullptr;
 
 	/* delete streams */
+	_stream_scheduler.remove_all();
 	_streams.clear();
 
 	if (_uart_fd >= 0) {
@@ -2985,7 +3220,10 @@ Mavlink::display_status()
 	printf("\trates:\n");
 	printf("\t  tx: %.1f B/s\n", (double)_tstatus.tx_rate_avg);
 	printf("\t  txerr: %.1f B/s\n", (double)_tstatus.tx_error_rate_avg);
-	printf("\t  tx rate mult: %.3f\n", (double)_rate_mult);
+	printf("\t  tx rate mult: %.3f (high: %.3f, normal: %.3f, low: %.3f)\n", (double)_rate_mult,
+	       (double)get_rate_mult(MavlinkStream::Priority::HIGH), (double)get_rate_mult(MavlinkStream::Priority::NORMAL),
+	       (double)get_rate_mult(MavlinkStream::Priority::LOW));
+	printf("\t  tx reserved: %.1f B/s\n", (double)_tx_reserved_rate);
 	printf("\t  tx rate max: %i B/s\n", _datarate);
 	printf("\t  rx: %.1f B/s\n", (double)_tstatus.rx_rate_avg);
 	printf("\t  rx loss: %.1f%%\n", (double)_tstatus.rx_message_lost_rate);
@@ -3031,6 +3269,9 @@ Mavlink::display_status()
 		}
 
 #endif
+		printf("\tUDP tx%s: %" PRIu32 " packets, %" PRIu32 " datagrams (%.2f packets/datagram), %" PRIu32 " syscalls\n",
+		       (_udp_batch != nullptr) ? " (batched)" : "", _udp_tx_packets, _udp_tx_datagrams,
+		       (double)_udp_tx_packets / (double)math::max(_udp_tx_datagrams, (uint32_t)1), _udp_tx_syscalls);
 		break;
 #endif // MAVLINK_UDP
 
@@ -3052,13 +3293,15 @@ Mavlink::display_status()
 void
 Mavlink::display_status_streams()
 {
-	printf("\t%-20s%-16s %s\n", "Name", "Rate Config (current) [Hz]", "Message Size (if active) [B]");
+	static constexpr const char *priority_str[MavlinkStream::PRIORITY_COUNT] {"crit", "high", "norm", "low"};
 
-	const float rate_mult = _rate_mult;
+	printf("\t%-30s%-6s%-26s%-15s%-14s%-13s%s\n", "Name", "Prio", "Rate Config (current) [Hz]", "Achieved [Hz]",
+	       "Latency [ms]", "Jitter [ms]", "Message Size (if active) [B]");
 
 	for (const auto &stream : _streams) {
 		const int interval = stream->get_interval();
 		const unsigned size = stream->get_size();
+		const MavlinkStream::Priority priority = stream->get_priority();
 		char rate_str[20];
 
 		if (interval < 0) {
@@ -3068,11 +3311,21 @@ Mavlink::display_status_streams()
 			float rate = 1000000.0f / (float)interval;
 			// Note that the actual current rate can be lower if the associated uORB topic updates at a
 			// lower rate.
-			float rate_current = stream->const_rate() ? rate : rate * rate_mult;
+			float rate_current = (priority == MavlinkStream::Priority::CRITICAL) ? rate : rate * get_rate_mult(priority);
 			snprintf(rate_str, sizeof(rate_str), "%6.2f (%.3f)", (double)rate, (double)rate_current);
 		}
 
-		printf("\t%-30s%-16s", stream->get_name(), rate_str);
+		printf("\t%-30s%-6s%-26s", stream->get_name(), priority_str[(unsigned)priority], rate_str);
+
+		MavlinkStreamScheduler::Statistics statistics;
+
+		if (_stream_scheduler.get_statistics(stream, statistics)) {
+			printf("%-15.3f%-14.2f%-13.2f", (double)statistics.rate, (double)statistics.latency_us * 1e-3,
+			       (double)statistics.jitter_us * 1e-3);
+
+		} else {
+			printf("%-15s%-14s%-13s", "-", "-", "-");
+		}
 
 		if (size > 0) {
 			printf(" %3u\n", size);
@@ -3378,6 +3631,7 @@ $ mavlink stream -u 14556 -s HIGHRES_IMU -r 50
 	PRINT_MODULE_USAGE_PARAM_INT('r', 0, 10, 10000000, "Maximum sending data rate in B/s (if 0, use baudrate / 20)", true);
 #if defined(CONFIG_NET) || defined(__PX4_POSIX)
 	PRINT_MODULE_USAGE_PARAM_FLAG('p', "Enable Broadcast", true);
+	PRINT_MODULE_USAGE_PARAM_FLAG('B', "Batch the packets of each iteration into MTU sized UDP datagrams", true);
 	PRINT_MODULE_USAGE_PARAM_INT('u', 14556, 0, 65536, "Select UDP Network Port (local)", true);
 	PRINT_MODULE_USAGE_PARAM_INT('o', 14550, 0, 65536, "Select UDP Network Port (remote)", true);
 	PRINT_MODULE_USAGE_PARAM_STRING('t', "127.0.0.1", nullptr, "Partner IP (broadcasting can be enabled via -p flag)", true);
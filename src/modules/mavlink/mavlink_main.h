@@ -84,6 +84,7 @@
 #include "mavlink_messages.h"
 #include "mavlink_receiver.h"
 #include "mavlink_shell.h"
+#include "mavlink_stream_scheduler.h"
 #include "mavlink_ulog.h"
 
 #define DEFAULT_BAUD_RATE       57600
@@ -415,6 +416,11 @@ public:
 
 	float			get_rate_mult() const { return _rate_mult; }
 
+	/**
+	 * @return rate multiplier of a stream priority class
+	 */
+	float			get_rate_mult(MavlinkStream::Priority priority) const { return _priority_rate_mult[(unsigned)priority]; }
+
 	float			get_baudrate() { return _baudrate; }
 
 	/* Functions for waiting to start transmission until message received. */
@@ -569,6 +575,7 @@ private:
 	unsigned		_main_loop_delay{1000};	/**< mainloop delay, depends on data rate */
 
 	List<MavlinkStream *>		_streams;
+	MavlinkStreamScheduler		_stream_scheduler;
 
 	MavlinkShell		*_mavlink_shell{nullptr};
 	MavlinkULog		*_mavlink_ulog{nullptr};
@@ -587,7 +594,9 @@ private:
 
 	int			_baudrate{57600};
 	int			_datarate{1000};		///< data rate for normal streams (attitude, position, etc.)
-	float			_rate_mult{1.0f};
+	float			_rate_mult{1.0f};			///< allocated / requested bandwidth of the scaled streams
+	float			_priority_rate_mult[MavlinkStream::PRIORITY_COUNT] {1.0f, 1.0f, 1.0f, 1.0f};
+	float			_tx_reserved_rate{0.0f};		///< reserved for critical streams and other traffic [B/s]
 	float			_high_latency_freq{0.015f};	///< frequency of HIGH_LATENCY2 stream
 
 	bool			_radio_status_available{false};
@@ -632,6 +641,24 @@ private:
 
 	unsigned short		_network_port{14556};
 	unsigned short		_remote_port{DEFAULT_REMOTE_PORT_UDP};
+
+	// UDP transmit batching: packets are coalesced into MTU sized datagrams, sent once per main loop iteration
+	static constexpr unsigned UDP_BATCH_DATAGRAM_SIZE{1472}; // Ethernet MTU - IPv4 & UDP headers
+	static constexpr unsigned UDP_BATCH_DATAGRAMS{4};
+
+	struct UdpBatch {
+		uint8_t buf[UDP_BATCH_DATAGRAMS][UDP_BATCH_DATAGRAM_SIZE];
+		uint16_t len[UDP_BATCH_DATAGRAMS];
+		uint16_t packets[UDP_BATCH_DATAGRAMS];
+		unsigned count; // datagrams in use
+	};
+
+	UdpBatch		*_udp_batch{nullptr};
+	bool			_udp_batching{false};
+
+	uint32_t		_udp_tx_packets{0};
+	uint32_t		_udp_tx_datagrams{0};
+	uint32_t		_udp_tx_syscalls{0};
 #endif // MAVLINK_UDP
 
 	uint8_t			_buf[MAVLINK_MAX_PACKET_LEN] {};
@@ -732,6 +759,21 @@ private:
 #if defined(MAVLINK_UDP)
 	void find_broadcast_address();
 
+	/**
+	 * Append the packet in _buf to the UDP batch, _send_mutex must be held.
+	 */
+	void udp_batch_add();
+
+	/**
+	 * Send all batched datagrams to the partner and broadcast address, _send_mutex must be held.
+	 */
+	void udp_batch_flush();
+
+	/**
+	 * Send the UDP batch (if any) at the end of a main loop iteration.
+	 */
+	void udp_batch_send();
+
 	void init_udp();
 #endif // MAVLINK_UDP
 
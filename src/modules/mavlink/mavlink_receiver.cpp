@@ -79,6 +79,9 @@ MavlinkReceiver::~MavlinkReceiver()
 	delete[] _received_msg_stats;
 #endif // !CONSTRAINED_FLASH
 
+	perf_free(_parse_perf);
+	perf_free(_parse_messages_perf);
+
 	_distance_sensor_pub.unadvertise();
 	_gps_inject_data_pub.unadvertise();
 	_rc_pub.unadvertise();
@@ -3103,6 +3106,125 @@ void MavlinkReceiver::handle_message_open_drone_id_system(
 
 	_open_drone_id_system_pub.publish(odid_system);
 }
+
+size_t
+MavlinkReceiver::parse_buffer(const uint8_t *buf, size_t len, size_t keep_max)
+{
+	size_t i = 0;
+
+	while (i < len) {
+		// parse a batch of messages, then dispatch them
+		perf_begin(_parse_perf);
+		int received = 0;
+		i += _frame_parser.parse(_mavlink.get_channel(), &buf[i], len - i, keep_max, _rx_batch, RX_BATCH_SIZE, received);
+		perf_end(_parse_perf);
+
+		for (int k = 0; k < received; k++) {
+			dispatch_message(_rx_batch[k]);
+		}
+
+		if (received > 0) {
+			// Received first message, unlock wait to transmit '-w' command-line flag
+			_mavlink.set_has_received_messages(true);
+		}
+
+		if (received < RX_BATCH_SIZE) {
+			// the whole buffer is parsed, or the rest is an incomplete frame
+			break;
+		}
+	}
+
+	return i;
+}
+
+void
+MavlinkReceiver::dispatch_message(mavlink_message_t &msg)
+{
+	/* check if we received version 2 and request a switch. */
+	if (msg.magic == MAVLINK_STX) {
+		/* this will only switch to proto version 2 if allowed in settings */
+		_mavlink.set_proto_version(2);
+	}
+
+	switch (_mavlink.get_mode()) {
+	case Mavlink::MAVLINK_MODE::MAVLINK_MODE_GIMBAL:
+		handle_messages_in_gimbal_mode(msg);
+		break;
+
+	default:
+		handle_message(&msg);
+		break;
+	}
+
+	update_rx_stats(msg);
+
+	if (_message_statistics_enabled) {
+		update_message_statistics(msg);
+	}
+
+	perf_count(_parse_messages_perf);
+}
+
+void
+MavlinkReceiver::update_rx_status(ssize_t nread)
+{
+	_mavlink.count_rxbytes(nread);
+
+	telemetry_status_s &tstatus = _mavlink.telemetry_status();
+	tstatus.rx_message_count = _total_received_counter;
+	tstatus.rx_message_lost_count = _total_lost_counter;
+	tstatus.rx_message_lost_rate = static_cast<float>(_total_lost_counter) / static_cast<float>(_total_received_counter);
+
+	const mavlink_status_t &status = _frame_parser.status();
+
+	if (_mavlink_status_last_buffer_overrun != status.buffer_overrun) {
+		tstatus.rx_buffer_overruns++;
+		_mavlink_status_last_buffer_overrun = status.buffer_overrun;
+	}
+
+	if (_mavlink_status_last_parse_error != status.parse_error) {
+		tstatus.rx_parse_errors++;
+		_mavlink_status_last_parse_error = status.parse_error;
+	}
+
+	if (_mavlink_status_last_packet_rx_drop_count != status.packet_rx_drop_count) {
+		tstatus.rx_packet_drop_count++;
+		_mavlink_status_last_packet_rx_drop_count = status.packet_rx_drop_count;
+	}
+}
+
+#if defined(MAVLINK_UDP)
+bool
+MavlinkReceiver::handle_udp_source(const sockaddr_in &srcaddr)
+{
+	struct sockaddr_in &srcaddr_last = _mavlink.get_client_source_address();
+
+	int localhost = (127 << 24) + 1;
+
+	if (!_mavlink.get_client_source_initialized()) {
+
+		// set the address either if localhost or if 3 seconds have passed
+		// this ensures that a GCS running on localhost can get a hold of
+		// the system within the first N seconds
+		hrt_abstime stime = _mavlink.get_start_time();
+
+		if ((stime != 0 && (hrt_elapsed_time(&stime) > 3_s))
+		    || (srcaddr_last.sin_addr.s_addr == htonl(localhost))) {
+
+			srcaddr_last.sin_addr.s_addr = srcaddr.sin_addr.s_addr;
+			srcaddr_last.sin_port = srcaddr.sin_port;
+
+			_mavlink.set_client_source_initialized();
+
+			PX4_INFO("partner IP: %s", inet_ntoa(srcaddr.sin_addr));
+		}
+	}
+
+	// only start accepting messages on UDP once we're sure who we talk to
+	return _mavlink.get_client_source_initialized();
+}
+#endif // MAVLINK_UDP
+
 void
 MavlinkReceiver::run()
 {
@@ -3118,7 +3240,8 @@ MavlinkReceiver::run()
 
 #if defined(__PX4_POSIX)
 	/* 1500 is the Wifi MTU, so we make sure to fit a full packet */
-	uint8_t buf[1600 * 5];
+	static constexpr size_t DATAGRAM_SIZE = 1600;
+	uint8_t buf[DATAGRAM_SIZE * 5];
 #elif defined(CONFIG_NET)
 	/* 1500 is the Wifi MTU, so we make sure to fit a full packet */
 	uint8_t buf[1000];
@@ -3126,7 +3249,9 @@ MavlinkReceiver::run()
 	/* the serial port buffers internally as well, we just need to fit a small chunk */
 	uint8_t buf[64];
 #endif
-	mavlink_message_t msg;
+
+	// serial: unparsed start of a frame from the previous read, completed by the next read
+	size_t buf_fill = 0;
 
 	struct pollfd fds[1] = {};
 
@@ -3136,8 +3261,25 @@ MavlinkReceiver::run()
 	}
 
 #if defined(MAVLINK_UDP)
+# if defined(__PX4_LINUX)
+	// receive up to 5 datagrams per system call, parsed in place
+	static constexpr unsigned DATAGRAMS = sizeof(buf) / DATAGRAM_SIZE;
+	struct mmsghdr msgs[DATAGRAMS] {};
+	struct iovec iov[DATAGRAMS] {};
+	struct sockaddr_in srcaddrs[DATAGRAMS] {};
+
+	for (unsigned k = 0; k < DATAGRAMS; k++) {
+		iov[k].iov_base = &buf[k * DATAGRAM_SIZE];
+		iov[k].iov_len = DATAGRAM_SIZE;
+		msgs[k].msg_hdr.msg_iov = &iov[k];
+		msgs[k].msg_hdr.msg_iovlen = 1;
+		msgs[k].msg_hdr.msg_name = &srcaddrs[k];
+	}
+
+# else
 	struct sockaddr_in srcaddr = {};
 	socklen_t addrlen = sizeof(srcaddr);
+# endif // __PX4_LINUX
 
 	if (_mavlink.get_protocol() == Protocol::UDP) {
 		fds[0].fd = _mavlink.get_socket_fd();
@@ -3166,103 +3308,53 @@ MavlinkReceiver::run()
 		if (ret > 0) {
 			if (_mavlink.get_protocol() == Protocol::SERIAL) {
 				/* non-blocking read. read may return negative values */
-				nread = ::read(fds[0].fd, buf, sizeof(buf));
+				nread = ::read(fds[0].fd, &buf[buf_fill], sizeof(buf) - buf_fill);
 
 				if (nread == -1 && errno == ENOTCONN) { // Not connected (can happen for USB)
 					usleep(100000);
 				}
-			}
-
-#if defined(MAVLINK_UDP)
-
-			else if (_mavlink.get_protocol() == Protocol::UDP) {
-				if (fds[0].revents & POLLIN) {
-					nread = recvfrom(_mavlink.get_socket_fd(), buf, sizeof(buf), 0, (struct sockaddr *)&srcaddr, &addrlen);
-				}
-
-				struct sockaddr_in &srcaddr_last = _mavlink.get_client_source_address();
-
-				int localhost = (127 << 24) + 1;
 
-				if (!_mavlink.get_client_source_initialized()) {
-
-					// set the address either if localhost or if 3 seconds have passed
-					// this ensures that a GCS running on localhost can get a hold of
-					// the system within the first N seconds
-					hrt_abstime stime = _mavlink.get_start_time();
-
-					if ((stime != 0 && (hrt_elapsed_time(&stime) > 3_s))
-					    || (srcaddr_last.sin_addr.s_addr == htonl(localhost))) {
-
-						srcaddr_last.sin_addr.s_addr = srcaddr.sin_addr.s_addr;
-						srcaddr_last.sin_port = srcaddr.sin_port;
+				/* if read failed, nothing is parsed */
+				if (nread > 0) {
+					const size_t len = buf_fill + nread;
+					const size_t parsed = parse_buffer(buf, len, sizeof(buf) / 2);
 
-						_mavlink.set_client_source_initialized();
+					buf_fill = len - parsed;
+					memmove(buf, &buf[parsed], buf_fill);
 
-						PX4_INFO("partner IP: %s", inet_ntoa(srcaddr.sin_addr));
-					}
+					update_rx_status(nread);
 				}
 			}
 
-			// only start accepting messages on UDP once we're sure who we talk to
-			if (_mavlink.get_protocol() != Protocol::UDP || _mavlink.get_client_source_initialized()) {
-#endif // MAVLINK_UDP
-
-				/* if read failed, this loop won't execute */
-				for (ssize_t i = 0; i < nread; i++) {
-					if (mavlink_parse_char(_mavlink.get_channel(), buf[i], &msg, &_status)) {
-
-						/* check if we received version 2 and request a switch. */
-						if (!(_mavlink.get_status()->flags & MAVLINK_STATUS_FLAG_IN_MAVLINK1)) {
-							/* this will only switch to proto version 2 if allowed in settings */
-							_mavlink.set_proto_version(2);
-						}
+#if defined(MAVLINK_UDP)
 
-						switch (_mavlink.get_mode()) {
-						case Mavlink::MAVLINK_MODE::MAVLINK_MODE_GIMBAL:
-							handle_messages_in_gimbal_mode(msg);
-							break;
+			else if (_mavlink.get_protocol() == Protocol::UDP) {
+				if (fds[0].revents & POLLIN) {
+# if defined(__PX4_LINUX)
 
-						default:
-							handle_message(&msg);
-							break;
-						}
+					for (unsigned k = 0; k < DATAGRAMS; k++) {
+						msgs[k].msg_hdr.msg_namelen = sizeof(srcaddrs[k]);
+					}
 
-						_mavlink.set_has_received_messages(true); // Received first message, unlock wait to transmit '-w' command-line flag
-						update_rx_stats(msg);
+					const int count = recvmmsg(_mavlink.get_socket_fd(), msgs, DATAGRAMS, MSG_DONTWAIT, nullptr);
 
-						if (_message_statistics_enabled) {
-							update_message_statistics(msg);
+					for (int k = 0; k < count; k++) {
+						if (handle_udp_source(srcaddrs[k]) && (msgs[k].msg_len > 0)) {
+							parse_buffer(&buf[k * DATAGRAM_SIZE], msgs[k].msg_len, 0);
+							update_rx_status(msgs[k].msg_len);
 						}
 					}
-				}
-
-				/* count received bytes (nread will be -1 on read error) */
-				if (nread > 0) {
-					_mavlink.count_rxbytes(nread);
-
-					telemetry_status_s &tstatus = _mavlink.telemetry_status();
-					tstatus.rx_message_count = _total_received_counter;
-					tstatus.rx_message_lost_count = _total_lost_counter;
-					tstatus.rx_message_lost_rate = static_cast<float>(_total_lost_counter) / static_cast<float>(_total_received_counter);
 
-					if (_mavlink_status_last_buffer_overrun != _status.buffer_overrun) {
-						tstatus.rx_buffer_overruns++;
-						_mavlink_status_last_buffer_overrun = _status.buffer_overrun;
-					}
+# else
+					nread = recvfrom(_mavlink.get_socket_fd(), buf, sizeof(buf), 0, (struct sockaddr *)&srcaddr, &addrlen);
 
-					if (_mavlink_status_last_parse_error != _status.parse_error) {
-						tstatus.rx_parse_errors++;
-						_mavlink_status_last_parse_error = _status.parse_error;
+					if (handle_udp_source(srcaddr) && (nread > 0)) {
+						parse_buffer(buf, nread, 0);
+						update_rx_status(nread);
 					}
 
-					if (_mavlink_status_last_packet_rx_drop_count != _status.packet_rx_drop_count) {
-						tstatus.rx_packet_drop_count++;
-						_mavlink_status_last_packet_rx_drop_count = _status.packet_rx_drop_count;
-					}
+# endif // __PX4_LINUX
 				}
-
-#if defined(MAVLINK_UDP)
 			}
 
 #endif // MAVLINK_UDP
@@ -43,6 +43,7 @@
 
 #pragma once
 
+#include "mavlink_frame_parser.h"
 #include "mavlink_ftp.h"
 #include "mavlink_log_handler.h"
 #include "mavlink_mission.h"
@@ -157,6 +158,30 @@ private:
 	void handle_message(mavlink_message_t *msg);
 	void handle_messages_in_gimbal_mode(mavlink_message_t &msg);
 
+	/**
+	 * Parse and dispatch all messages of a receive buffer.
+	 *
+	 * Messages are parsed with MavlinkFrameParser in batches of RX_BATCH_SIZE and then dispatched.
+	 *
+	 * @param keep_max maximum length of an incomplete frame at the end of the buffer that is
+	 *                 left for the next read instead of feeding it to the byte parser
+	 * @return number of consumed bytes, the rest is the start of an incomplete frame
+	 */
+	size_t parse_buffer(const uint8_t *buf, size_t len, size_t keep_max);
+
+	void dispatch_message(mavlink_message_t &msg);
+
+	void update_rx_status(ssize_t nread);
+
+#if defined(MAVLINK_UDP)
+	/**
+	 * Take the partner address from the first datagrams.
+	 *
+	 * @return true once messages are accepted
+	 */
+	bool handle_udp_source(const sockaddr_in &srcaddr);
+#endif // MAVLINK_UDP
+
 	void handle_message_adsb_vehicle(mavlink_message_t *msg);
 	void handle_message_att_pos_mocap(mavlink_message_t *msg);
 	void handle_message_battery_status(mavlink_message_t *msg);
@@ -256,7 +281,13 @@ private:
 	MavlinkTimesync			_mavlink_timesync;
 	MavlinkStatustextHandler	_mavlink_statustext_handler;
 
-	mavlink_status_t		_status{}; ///< receiver status, used for mavlink_parse_char()
+	MavlinkFrameParser		_frame_parser{};
+
+	static constexpr int RX_BATCH_SIZE{8};
+	mavlink_message_t		_rx_batch[RX_BATCH_SIZE] {}; ///< parsed messages waiting for dispatch
+
+	perf_counter_t _parse_perf{perf_alloc(PC_ELAPSED, MODULE_NAME": rx parse")};
+	perf_counter_t _parse_messages_perf{perf_alloc(PC_COUNT, MODULE_NAME": rx messages")};
 
 	orb_advert_t _mavlink_log_pub{nullptr};
 
@@ -82,11 +82,7 @@ MavlinkStream::update(const hrt_abstime &t)
 	}
 
 	int64_t dt = t - _last_sent;
-	int interval = _interval;
-
-	if (!const_rate()) {
-		interval /= _mavlink->get_rate_mult();
-	}
+	const int interval = get_effective_interval();
 
 	// We don't need to send anything if the inverval is 0. send() will be called manually.
 	if (interval == 0) {
@@ -128,3 +124,38 @@ MavlinkStream::update(const hrt_abstime &t)
 
 	return -1;
 }
+
+hrt_abstime
+MavlinkStream::get_next_due()
+{
+	if (_last_sent == 0) {
+		return 0;
+	}
+
+	const int interval = get_effective_interval();
+
+	if (interval < 0) {
+		// unlimited rate
+		return 0;
+
+	} else if (interval == 0) {
+		return UINT64_MAX;
+	}
+
+	// same condition as in update(): dt > interval - 30% of the main loop delay
+	const int64_t due = (int64_t)_last_sent + interval - (_mavlink->get_main_loop_delay() / 10) * 3 + 1;
+
+	return (due > 0) ? due : 0;
+}
+
+int
+MavlinkStream::get_effective_interval()
+{
+	int interval = _interval;
+
+	if (get_priority() != Priority::CRITICAL) {
+		interval /= _mavlink->get_rate_mult(get_priority());
+	}
+
+	return interval;
+}
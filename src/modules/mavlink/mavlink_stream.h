@@ -44,6 +44,7 @@
 #include <drivers/drv_hrt.h>
 #include <px4_platform_common/module_params.h>
 #include <containers/List.hpp>
+#include <uORB/uORB.h>
 
 class Mavlink;
 
@@ -52,6 +53,18 @@ class MavlinkStream : public ListNode<MavlinkStream *>
 
 public:
 
+	/**
+	 * Priority class used to share the link bandwidth, the lower classes are scaled down first.
+	 */
+	enum class Priority : uint8_t {
+		CRITICAL = 0,	///< never scaled, bandwidth is reserved
+		HIGH,
+		NORMAL,
+		LOW,
+	};
+
+	static constexpr unsigned PRIORITY_COUNT{4};
+
 	MavlinkStream(Mavlink *mavlink);
 	virtual ~MavlinkStream() = default;
 
@@ -87,6 +100,11 @@ public:
 	 */
 	virtual bool const_rate() { return false; }
 
+	/**
+	 * @return the priority class of the stream for the link rate control
+	 */
+	virtual Priority get_priority() { return const_rate() ? Priority::CRITICAL : Priority::NORMAL; }
+
 	/**
 	 * Get maximal total messages size on update
 	 */
@@ -122,6 +140,31 @@ public:
 	 */
 	void reset_last_sent() { _last_sent = 0; }
 
+	/**
+	 * @return the time of the last send on the fixed rate schedule, 0 if never sent
+	 */
+	hrt_abstime get_last_sent() const { return _last_sent; }
+
+	/**
+	 * Get the earliest time at which update() sends the next message (if there is data)
+	 *
+	 * @return 0 if due immediately, UINT64_MAX if the stream is only sent on request
+	 */
+	hrt_abstime get_next_due();
+
+	/**
+	 * Topic whose publications make the stream send immediately if it is due,
+	 * instead of waiting for the next main loop iteration.
+	 *
+	 * @return nullptr if the stream is polled only
+	 */
+	virtual const orb_metadata *get_wakeup_topic() const { return nullptr; }
+
+	/**
+	 * @return true if update_data() has to run at the main loop rate, not only when the stream is due
+	 */
+	virtual bool needs_polling() const { return false; }
+
 protected:
 	Mavlink      *const _mavlink;
 	int _interval{1000000};		///< if set to negative value = unlimited rate
@@ -132,11 +175,17 @@ protected:
 	 * Function to collect/update data for the streams at a high rate independent of
 	 * actual stream rate.
 	 *
-	 * This function is called at every iteration of the mavlink module.
+	 * This function is called at every iteration of the mavlink module if needs_polling()
+	 * returns true, otherwise only when the stream is updated.
 	 */
 	virtual void update_data() { }
 
 private:
+	/**
+	 * @return the interval scaled by the rate multiplier of the priority class
+	 */
+	int get_effective_interval();
+
 	hrt_abstime _last_sent{0};
 	bool _first_message_sent{false};
 };
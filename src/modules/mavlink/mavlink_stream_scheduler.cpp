@@ -0,0 +1,364 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file mavlink_stream_scheduler.cpp
+ * Event driven scheduling of the MAVLink streams.
+ */
+
+#include "mavlink_stream_scheduler.h"
+
+#include <lib/mathlib/mathlib.h>
+#include <px4_time.h>
+
+MavlinkStreamScheduler::~MavlinkStreamScheduler()
+{
+	remove_all();
+
+	delete[] _heap;
+
+	pthread_mutex_destroy(&_mutex);
+	pthread_cond_destroy(&_cv);
+}
+
+bool MavlinkStreamScheduler::add(MavlinkStream *stream)
+{
+	if (_count == _capacity) {
+		const unsigned capacity = math::max(2 * _capacity, 16u);
+		Entry **heap = new Entry *[capacity];
+
+		if (heap == nullptr) {
+			return false;
+		}
+
+		for (unsigned i = 0; i < _count; i++) {
+			heap[i] = _heap[i];
+		}
+
+		delete[] _heap;
+		_heap = heap;
+		_capacity = capacity;
+	}
+
+	Entry *entry = new Entry{};
+
+	if (entry == nullptr) {
+		return false;
+	}
+
+	entry->stream = stream;
+
+	if (stream->get_wakeup_topic() != nullptr) {
+		entry->wakeup = new Wakeup(*this, stream->get_wakeup_topic());
+
+		if (entry->wakeup != nullptr) {
+			entry->wakeup->registerCallback();
+		}
+	}
+
+	// due immediately
+	entry->due = 0;
+	entry->index = _count;
+	_heap[_count++] = entry;
+	sift_up(entry->index);
+
+	return true;
+}
+
+void MavlinkStreamScheduler::remove(MavlinkStream *stream)
+{
+	Entry *entry = find(stream);
+
+	if (entry == nullptr) {
+		return;
+	}
+
+	const unsigned index = entry->index;
+	_count--;
+
+	if (index != _count) {
+		// move the last element into the gap
+		swap(index, _count);
+		sift_down(index);
+		sift_up(index);
+	}
+
+	delete entry->wakeup;
+	delete entry;
+}
+
+void MavlinkStreamScheduler::remove_all()
+{
+	for (unsigned i = 0; i < _count; i++) {
+		delete _heap[i]->wakeup;
+		delete _heap[i];
+	}
+
+	_count = 0;
+}
+
+void MavlinkStreamScheduler::reschedule(MavlinkStream *stream)
+{
+	Entry *entry = find(stream);
+
+	if (entry != nullptr) {
+		set_due(entry, 0);
+	}
+}
+
+void MavlinkStreamScheduler::wait(hrt_abstime timeout_time)
+{
+	if ((_count > 0) && (_heap[0]->due < timeout_time)) {
+		timeout_time = _heap[0]->due;
+	}
+
+	const hrt_abstime now = hrt_absolute_time();
+
+	if (timeout_time <= now) {
+		return;
+	}
+
+	pthread_mutex_lock(&_mutex);
+
+	// A wakeup between this check and the wait is lost, and handled at timeout_time instead.
+	// The wakeup callbacks do not take the mutex (same as uORB::SubscriptionBlocking): they run in the
+	// publisher's context, which must never block on the mavlink thread.
+	if (!_wakeup_pending.load()) {
+		// Calculate an absolute time in the future
+		struct timespec ts;
+		px4_clock_gettime(CLOCK_REALTIME, &ts);
+		uint64_t nsecs = ts.tv_nsec + (timeout_time - now) * 1000;
+		static constexpr unsigned billion = (1000 * 1000 * 1000);
+		ts.tv_sec += nsecs / billion;
+		nsecs -= (nsecs / billion) * billion;
+		ts.tv_nsec = nsecs;
+
+		px4_pthread_cond_timedwait(&_cv, &_mutex, &ts);
+	}
+
+	pthread_mutex_unlock(&_mutex);
+}
+
+void MavlinkStreamScheduler::update(const hrt_abstime now, const hrt_abstime poll_interval)
+{
+	if (_wakeup_pending.load()) {
+		_wakeup_pending.store(false);
+
+		// due times are only decreased, so no entry is skipped while the heap is reordered
+		for (unsigned i = 0; i < _count; i++) {
+			Entry *entry = _heap[i];
+
+			if ((entry->wakeup != nullptr) && entry->wakeup->pending.load()) {
+				entry->wakeup->pending.store(false);
+
+				const hrt_abstime due = math::max(entry->stream->get_next_due(), entry->wakeup->wakeup_time.load());
+
+				if (due < entry->due) {
+					set_due(entry, due);
+				}
+			}
+		}
+	}
+
+	while ((_count > 0) && (_heap[0]->due <= now)) {
+		Entry *entry = _heap[0];
+
+		const hrt_abstime last_sent = entry->stream->get_last_sent();
+
+		entry->stream->update(now);
+
+		if (entry->stream->get_last_sent() != last_sent) {
+			update_statistics(*entry, now);
+		}
+
+		hrt_abstime due = entry->stream->get_next_due();
+		const bool waiting = (due <= now);
+
+		if (waiting || (due == UINT64_MAX)) {
+			// nothing to send yet, unlimited rate or only sent on request: poll, update_data() still needs to run
+			due = now + poll_interval;
+
+		} else if (entry->stream->needs_polling()) {
+			// update_data() aggregates data in between the sends
+			due = math::min(due, now + poll_interval);
+		}
+
+		if (entry->wakeup != nullptr) {
+			entry->wakeup->armed.store(waiting);
+		}
+
+		set_due(entry, due);
+	}
+}
+
+void MavlinkStreamScheduler::update_rates(const float dt)
+{
+	if (dt <= 0.f) {
+		return;
+	}
+
+	float tx_rate = 0.f;
+
+	for (unsigned i = 0; i < _count; i++) {
+		Entry *entry = _heap[i];
+		entry->rate = entry->sent_count / dt;
+		entry->sent_count = 0;
+
+		tx_rate += entry->rate * entry->stream->get_size_avg();
+	}
+
+	_tx_rate = tx_rate;
+}
+
+bool MavlinkStreamScheduler::get_statistics(const MavlinkStream *stream, Statistics &statistics) const
+{
+	const Entry *entry = find(stream);
+
+	if (entry == nullptr) {
+		return false;
+	}
+
+	statistics.latency_us = entry->latency_avg;
+	statistics.jitter_us = entry->jitter_avg;
+	statistics.rate = entry->rate;
+
+	return true;
+}
+
+void MavlinkStreamScheduler::Wakeup::call()
+{
+	if (armed.load()) {
+		armed.store(false);
+		wakeup_time.store(hrt_absolute_time());
+		pending.store(true);
+
+		_scheduler._wakeup_pending.store(true);
+		pthread_cond_signal(&_scheduler._cv);
+	}
+}
+
+MavlinkStreamScheduler::Entry *MavlinkStreamScheduler::find(const MavlinkStream *stream) const
+{
+	for (unsigned i = 0; i < _count; i++) {
+		if (_heap[i]->stream == stream) {
+			return _heap[i];
+		}
+	}
+
+	return nullptr;
+}
+
+void MavlinkStreamScheduler::set_due(Entry *entry, hrt_abstime due)
+{
+	const hrt_abstime due_prev = entry->due;
+	entry->due = due;
+
+	if (due < due_prev) {
+		sift_up(entry->index);
+
+	} else {
+		sift_down(entry->index);
+	}
+}
+
+void MavlinkStreamScheduler::sift_up(unsigned index)
+{
+	while (index > 0) {
+		const unsigned parent = (index - 1) / 2;
+
+		if (_heap[index]->due >= _heap[parent]->due) {
+			break;
+		}
+
+		swap(index, parent);
+		index = parent;
+	}
+}
+
+void MavlinkStreamScheduler::sift_down(unsigned index)
+{
+	for (;;) {
+		const unsigned left = 2 * index + 1;
+		const unsigned right = left + 1;
+		unsigned smallest = index;
+
+		if ((left < _count) && (_heap[left]->due < _heap[smallest]->due)) {
+			smallest = left;
+		}
+
+		if ((right < _count) && (_heap[right]->due < _heap[smallest]->due)) {
+			smallest = right;
+		}
+
+		if (smallest == index) {
+			break;
+		}
+
+		swap(index, smallest);
+		index = smallest;
+	}
+}
+
+void MavlinkStreamScheduler::swap(unsigned a, unsigned b)
+{
+	Entry *entry = _heap[a];
+	_heap[a] = _heap[b];
+	_heap[b] = entry;
+	_heap[a]->index = a;
+	_heap[b]->index = b;
+}
+
+void MavlinkStreamScheduler::update_statistics(Entry &entry, const hrt_abstime now)
+{
+	static constexpr float ALPHA = 0.1f; // moving average weight
+
+	entry.sent_count++;
+
+	if (entry.due > 0) {
+		entry.latency_avg += ALPHA * ((float)(now - entry.due) - entry.latency_avg);
+	}
+
+	if (entry.last_sent > 0) {
+		const float interval = now - entry.last_sent;
+
+		if (entry.interval_avg > 0.f) {
+			entry.interval_avg += ALPHA * (interval - entry.interval_avg);
+			entry.jitter_avg += ALPHA * (fabsf(interval - entry.interval_avg) - entry.jitter_avg);
+
+		} else {
+			entry.interval_avg = interval;
+		}
+	}
+
+	entry.last_sent = now;
+}
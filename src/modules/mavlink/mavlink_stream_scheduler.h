@@ -0,0 +1,177 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file mavlink_stream_scheduler.h
+ * Event driven scheduling of the MAVLink streams.
+ */
+
+#pragma once
+
+#include "mavlink_stream.h"
+
+#include <drivers/drv_hrt.h>
+#include <px4_platform_common/atomic.h>
+#include <uORB/SubscriptionCallback.hpp>
+
+#include <pthread.h>
+
+/**
+ * The streams are kept in a binary min-heap ordered by the time of their next update.
+ * The main loop sleeps until the earliest of these, or until the wakeup topic of a
+ * stream waiting for new data is published, and then only updates the due streams.
+ */
+class MavlinkStreamScheduler
+{
+public:
+	MavlinkStreamScheduler() = default;
+	~MavlinkStreamScheduler();
+
+	// no copy, assignment, move, move assignment
+	MavlinkStreamScheduler(const MavlinkStreamScheduler &) = delete;
+	MavlinkStreamScheduler &operator=(const MavlinkStreamScheduler &) = delete;
+	MavlinkStreamScheduler(MavlinkStreamScheduler &&) = delete;
+	MavlinkStreamScheduler &operator=(MavlinkStreamScheduler &&) = delete;
+
+	/**
+	 * Add a stream, it is due immediately.
+	 *
+	 * @return false on allocation failure
+	 */
+	bool add(MavlinkStream *stream);
+
+	/**
+	 * Remove a stream, must be called before the stream is deleted.
+	 */
+	void remove(MavlinkStream *stream);
+
+	void remove_all();
+
+	/**
+	 * Make a stream due immediately, e.g. after its interval changed.
+	 */
+	void reschedule(MavlinkStream *stream);
+
+	/**
+	 * Block until the earliest stream is due, a wakeup topic is published or timeout_time is reached.
+	 */
+	void wait(hrt_abstime timeout_time);
+
+	/**
+	 * Update all streams that are due.
+	 *
+	 * @param now current time
+	 * @param poll_interval time until a stream is updated again if it has nothing to send
+	 */
+	void update(const hrt_abstime now, const hrt_abstime poll_interval);
+
+	/**
+	 * Update the achieved send rates, called periodically.
+	 *
+	 * @param dt time since the last call [s]
+	 */
+	void update_rates(const float dt);
+
+	/**
+	 * @return bandwidth used by all streams during the last update_rates() period [B/s]
+	 */
+	float get_tx_rate() const { return _tx_rate; }
+
+	struct Statistics {
+		float latency_us; ///< average delay of the sent updates from their scheduled time
+		float jitter_us;  ///< average deviation of the send interval from its mean
+		float rate;       ///< achieved send rate [Hz]
+	};
+
+	/**
+	 * Get the scheduling statistics of a stream
+	 *
+	 * @return false if the stream is not scheduled
+	 */
+	bool get_statistics(const MavlinkStream *stream, Statistics &statistics) const;
+
+private:
+
+	class Wakeup : public uORB::SubscriptionCallback
+	{
+	public:
+		Wakeup(MavlinkStreamScheduler &scheduler, const orb_metadata *meta) :
+			uORB::SubscriptionCallback(meta),
+			_scheduler(scheduler)
+		{
+		}
+
+		void call() override;
+
+		px4::atomic_bool armed{false};            ///< the stream is due and waiting for data
+		px4::atomic_bool pending{false};          ///< woken up, not yet handled by update()
+		px4::atomic<hrt_abstime> wakeup_time{0};  ///< time of the waking publication
+
+	private:
+		MavlinkStreamScheduler &_scheduler;
+	};
+
+	struct Entry {
+		MavlinkStream *stream;
+		Wakeup *wakeup;
+		hrt_abstime due;
+		hrt_abstime last_sent;
+		float interval_avg;
+		float latency_avg;
+		float jitter_avg;
+		float rate;
+		unsigned sent_count;
+		unsigned index; ///< position in the heap
+	};
+
+	Entry *find(const MavlinkStream *stream) const;
+
+	void set_due(Entry *entry, hrt_abstime due);
+	void sift_up(unsigned index);
+	void sift_down(unsigned index);
+	void swap(unsigned a, unsigned b);
+
+	void update_statistics(Entry &entry, const hrt_abstime now);
+
+	Entry **_heap{nullptr};
+	unsigned _count{0};
+	unsigned _capacity{0};
+
+	float _tx_rate{0.f};
+
+	px4::atomic_bool _wakeup_pending{false};
+
+	pthread_mutex_t _mutex = PTHREAD_MUTEX_INITIALIZER; ///< only used by wait()
+	pthread_cond_t _cv = PTHREAD_COND_INITIALIZER;
+};
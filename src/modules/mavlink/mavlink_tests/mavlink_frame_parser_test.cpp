@@ -0,0 +1,329 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/// @file mavlink_frame_parser_test.cpp
+/// Checks that MavlinkFrameParser gives the same messages and status as mavlink_parse_char()
+
+#include <string.h>
+
+#include <lib/mathlib/mathlib.h>
+
+#include "mavlink_frame_parser_test.h"
+
+// the parsers work on the status and buffer of a channel, which are provided by the instance registered for it
+extern Mavlink *mavlink_module_instances[MAVLINK_COMM_NUM_BUFFERS];
+
+void MavlinkFrameParserTest::_init()
+{
+	// use two unused channels for the test instances
+	for (int i = 0; i < MAVLINK_COMM_NUM_BUFFERS; i++) {
+		if (mavlink_module_instances[i] == nullptr) {
+			if (_channel_block < 0) {
+				_channel_block = i;
+				mavlink_module_instances[i] = &_mavlink_block;
+
+			} else {
+				_channel_byte = i;
+				mavlink_module_instances[i] = &_mavlink_byte;
+				break;
+			}
+		}
+	}
+
+	_tx_status = {};
+	_tx_signing = {};
+	_stream_len = 0;
+}
+
+void MavlinkFrameParserTest::_cleanup()
+{
+	if (_channel_block >= 0) {
+		mavlink_module_instances[_channel_block] = nullptr;
+		_channel_block = -1;
+	}
+
+	if (_channel_byte >= 0) {
+		mavlink_module_instances[_channel_byte] = nullptr;
+		_channel_byte = -1;
+	}
+}
+
+void MavlinkFrameParserTest::_append_frame(uint32_t msgid, const void *payload, uint8_t min_len, uint8_t len,
+		uint8_t crc_extra)
+{
+	mavlink_message_t msg{};
+	msg.msgid = msgid;
+	memcpy(_MAV_PAYLOAD_NON_CONST(&msg), payload, len);
+	mavlink_finalize_message_buffer(&msg, 1, 1, &_tx_status, min_len, len, crc_extra);
+
+	if (_stream_len + MAVLINK_MAX_PACKET_LEN <= STREAM_SIZE) {
+		_stream_len += mavlink_msg_to_send_buffer(&_stream[_stream_len], &msg);
+	}
+}
+
+void MavlinkFrameParserTest::_append_frames()
+{
+	mavlink_heartbeat_t heartbeat{};
+	heartbeat.type = MAV_TYPE_GCS;
+	heartbeat.autopilot = MAV_AUTOPILOT_INVALID;
+	heartbeat.system_status = MAV_STATE_ACTIVE;
+	heartbeat.mavlink_version = 3;
+	_append_frame(MAVLINK_MSG_ID_HEARTBEAT, &heartbeat, MAVLINK_MSG_ID_HEARTBEAT_MIN_LEN, MAVLINK_MSG_ID_HEARTBEAT_LEN,
+		      MAVLINK_MSG_ID_HEARTBEAT_CRC);
+
+	mavlink_attitude_t attitude{};
+	attitude.time_boot_ms = 123456;
+	attitude.roll = 0.1f;
+	attitude.pitch = -0.2f;
+	attitude.yaw = 3.f;
+	attitude.rollspeed = 0.01f;
+	attitude.pitchspeed = -0.02f;
+	attitude.yawspeed = 0.03f;
+	_append_frame(MAVLINK_MSG_ID_ATTITUDE, &attitude, MAVLINK_MSG_ID_ATTITUDE_MIN_LEN, MAVLINK_MSG_ID_ATTITUDE_LEN,
+		      MAVLINK_MSG_ID_ATTITUDE_CRC);
+
+	// the trailing zero fields are truncated in MAVLink 2 frames
+	mavlink_command_long_t command_long{};
+	command_long.command = MAV_CMD_COMPONENT_ARM_DISARM;
+	command_long.param1 = 1.f;
+	_append_frame(MAVLINK_MSG_ID_COMMAND_LONG, &command_long, MAVLINK_MSG_ID_COMMAND_LONG_MIN_LEN,
+		      MAVLINK_MSG_ID_COMMAND_LONG_LEN, MAVLINK_MSG_ID_COMMAND_LONG_CRC);
+}
+
+bool MavlinkFrameParserTest::_compare_status(const mavlink_status_t &a, const mavlink_status_t &b)
+{
+	ut_compare("msg_received differs", a.msg_received, b.msg_received);
+	ut_compare("buffer_overrun differs", a.buffer_overrun, b.buffer_overrun);
+	ut_compare("parse_error differs", a.parse_error, b.parse_error);
+	ut_compare("parse_state differs", a.parse_state, b.parse_state);
+	ut_compare("packet_idx differs", a.packet_idx, b.packet_idx);
+	ut_compare("current_rx_seq differs", a.current_rx_seq, b.current_rx_seq);
+	ut_compare("packet_rx_success_count differs", a.packet_rx_success_count, b.packet_rx_success_count);
+	ut_compare("packet_rx_drop_count differs", a.packet_rx_drop_count, b.packet_rx_drop_count);
+	ut_compare("flags differ", a.flags, b.flags);
+	ut_compare("signature_wait differs", a.signature_wait, b.signature_wait);
+
+	return true;
+}
+
+bool MavlinkFrameParserTest::_compare_parsers(size_t chunk_size, size_t keep_max)
+{
+	ut_assert("No free MAVLink channels", (_channel_block >= 0) && (_channel_byte >= 0));
+
+	const mavlink_channel_t channel_block = static_cast<mavlink_channel_t>(_channel_block);
+	const mavlink_channel_t channel_byte = static_cast<mavlink_channel_t>(_channel_byte);
+
+	*_mavlink_block.get_status() = {};
+	*_mavlink_block.get_buffer() = {};
+	*_mavlink_byte.get_status() = {};
+	*_mavlink_byte.get_buffer() = {};
+
+	// reference
+	mavlink_status_t byte_status{};
+	int byte_count = 0;
+
+	for (size_t i = 0; i < _stream_len; i++) {
+		if (mavlink_parse_char(channel_byte, _stream[i], &_byte_msgs[byte_count], &byte_status)) {
+			ut_less_than("Too many messages", byte_count, MAX_MESSAGES - 1);
+			byte_count++;
+		}
+	}
+
+	// frame parser, the incomplete frame at the end of a chunk is carried over
+	MavlinkFrameParser parser{};
+	uint8_t buf[RX_BUFFER_SIZE];
+	size_t buf_fill = 0;
+	size_t stream_pos = 0;
+	int block_count = 0;
+
+	while (stream_pos < _stream_len || buf_fill > 0) {
+		size_t n = math::min(chunk_size, math::min(RX_BUFFER_SIZE - buf_fill, _stream_len - stream_pos));
+		memcpy(&buf[buf_fill], &_stream[stream_pos], n);
+		stream_pos += n;
+
+		const size_t len = buf_fill + n;
+		// at the end of the stream nothing is left for a next read
+		const size_t keep = (stream_pos < _stream_len) ? keep_max : 0;
+		int received = 0;
+		const size_t parsed = parser.parse(channel_block, buf, len, keep, &_block_msgs[block_count],
+						   MAX_MESSAGES - block_count, received);
+		block_count += received;
+		ut_less_than("Too many messages", block_count, MAX_MESSAGES);
+
+		buf_fill = len - parsed;
+		memmove(buf, &buf[parsed], buf_fill);
+	}
+
+	ut_compare("Number of messages differs", block_count, byte_count);
+
+	for (int k = 0; k < block_count; k++) {
+		const mavlink_message_t &a = _block_msgs[k];
+		const mavlink_message_t &b = _byte_msgs[k];
+
+		ut_compare("magic differs", a.magic, b.magic);
+		ut_compare("len differs", a.len, b.len);
+		ut_compare("incompat_flags differ", a.incompat_flags, b.incompat_flags);
+		ut_compare("compat_flags differ", a.compat_flags, b.compat_flags);
+		ut_compare("seq differs", a.seq, b.seq);
+		ut_compare("sysid differs", a.sysid, b.sysid);
+		ut_compare("compid differs", a.compid, b.compid);
+		ut_compare("msgid differs", a.msgid, b.msgid);
+		ut_compare("checksum differs", a.checksum, b.checksum);
+
+		// including the zero-filled part of truncated payloads
+		const mavlink_msg_entry_t *entry = mavlink_get_msg_entry(a.msgid);
+		const size_t payload_len = (entry != nullptr) ? math::max(a.len, entry->max_msg_len) : a.len;
+		ut_compare("payload differs", memcmp(_MAV_PAYLOAD(&a), _MAV_PAYLOAD(&b), payload_len), 0);
+
+		if (a.incompat_flags & MAVLINK_IFLAG_SIGNED) {
+			ut_compare("signature differs", memcmp(a.signature, b.signature, MAVLINK_SIGNATURE_BLOCK_LEN), 0);
+		}
+	}
+
+	ut_assert("Channel status differs", _compare_status(*_mavlink_block.get_status(), *_mavlink_byte.get_status()));
+	ut_assert("Receiver status differs", _compare_status(parser.status(), byte_status));
+
+	return true;
+}
+
+bool MavlinkFrameParserTest::_compare_parsers_all()
+{
+	static constexpr size_t chunk_sizes[] {1, 7, 64, 263, RX_BUFFER_SIZE};
+
+	for (size_t chunk_size : chunk_sizes) {
+		// UDP (every chunk is parsed completely) and serial (incomplete frames are carried over)
+		ut_assert("UDP receive differs", _compare_parsers(chunk_size, 0));
+		ut_assert("Serial receive differs", _compare_parsers(chunk_size, RX_BUFFER_SIZE / 2));
+	}
+
+	return true;
+}
+
+bool MavlinkFrameParserTest::_complete_frames_test()
+{
+	for (int i = 0; i < 4; i++) {
+		_append_frames();
+	}
+
+	return _compare_parsers_all();
+}
+
+bool MavlinkFrameParserTest::_split_frames_test()
+{
+	for (int i = 0; i < 4; i++) {
+		_append_frames();
+	}
+
+	// ends with an incomplete frame
+	_stream_len -= 5;
+
+	return _compare_parsers_all();
+}
+
+bool MavlinkFrameParserTest::_bad_crc_test()
+{
+	_append_frames();
+
+	// corrupt the payload of the next frame
+	const size_t payload_pos = _stream_len + MAVLINK_NUM_HEADER_BYTES;
+	_append_frames();
+	_stream[payload_pos] ^= 0x55;
+
+	// and the checksum of the last frame
+	_append_frames();
+	_stream[_stream_len - 1] ^= 0x55;
+
+	_append_frames();
+
+	return _compare_parsers_all();
+}
+
+bool MavlinkFrameParserTest::_stray_stx_test()
+{
+	_stream[_stream_len++] = MAVLINK_STX;
+	_append_frames();
+	_stream[_stream_len++] = MAVLINK_STX;
+	_stream[_stream_len++] = 0x00;
+	_append_frames();
+	_stream[_stream_len++] = MAVLINK_STX;
+	_append_frames();
+	_stream[_stream_len++] = MAVLINK_STX;
+
+	return _compare_parsers_all();
+}
+
+bool MavlinkFrameParserTest::_signed_frames_test()
+{
+	_append_frames();
+
+	_tx_signing.flags = MAVLINK_SIGNING_FLAG_SIGN_OUTGOING;
+	_tx_signing.link_id = 1;
+	_tx_signing.timestamp = 1000;
+	memset(_tx_signing.secret_key, 0x42, sizeof(_tx_signing.secret_key));
+	_tx_status.signing = &_tx_signing;
+	_append_frames();
+	_append_frames();
+
+	_tx_status.signing = nullptr;
+	_append_frames();
+
+	return _compare_parsers_all();
+}
+
+bool MavlinkFrameParserTest::_mavlink1_frames_test()
+{
+	_tx_status.flags |= MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
+	_append_frames();
+
+	_tx_status.flags &= ~MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
+	_append_frames();
+
+	_tx_status.flags |= MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
+	_append_frames();
+
+	return _compare_parsers_all();
+}
+
+bool MavlinkFrameParserTest::run_tests()
+{
+	ut_run_test(_complete_frames_test);
+	ut_run_test(_split_frames_test);
+	ut_run_test(_bad_crc_test);
+	ut_run_test(_stray_stx_test);
+	ut_run_test(_signed_frames_test);
+	ut_run_test(_mavlink1_frames_test);
+
+	return (_tests_failed == 0);
+}
+
+ut_declare_test(mavlink_frame_parser_test, MavlinkFrameParserTest)
@@ -0,0 +1,102 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/// @file mavlink_frame_parser_test.h
+/// Checks that MavlinkFrameParser gives the same messages and status as mavlink_parse_char()
+
+#pragma once
+
+#include <unit_test.h>
+#include "../mavlink_bridge_header.h"
+#include "../mavlink_frame_parser.h"
+#include "../mavlink_main.h"
+
+class MavlinkFrameParserTest : public UnitTest
+{
+public:
+	MavlinkFrameParserTest() = default;
+	virtual ~MavlinkFrameParserTest() = default;
+
+	virtual bool run_tests(void);
+
+	// We don't want any of these
+	MavlinkFrameParserTest(const MavlinkFrameParserTest &) = delete;
+	MavlinkFrameParserTest &operator=(const MavlinkFrameParserTest &) = delete;
+
+private:
+	virtual void _init(void);
+	virtual void _cleanup(void);
+
+	bool _complete_frames_test(void);
+	bool _split_frames_test(void);
+	bool _bad_crc_test(void);
+	bool _stray_stx_test(void);
+	bool _signed_frames_test(void);
+	bool _mavlink1_frames_test(void);
+
+	/// Append a heartbeat, an attitude and a command_long frame (with a truncated payload) to the test stream
+	void _append_frames();
+	void _append_frame(uint32_t msgid, const void *payload, uint8_t min_len, uint8_t len, uint8_t crc_extra);
+
+	/**
+	 * Parse the test stream byte by byte with mavlink_parse_char() and in chunks with MavlinkFrameParser
+	 * (carrying an incomplete frame over to the next chunk like the serial receive path) and compare
+	 * the messages, the channel status and the receiver status.
+	 */
+	bool _compare_parsers(size_t chunk_size, size_t keep_max);
+
+	/// _compare_parsers() for a range of chunk sizes, with and without carrying incomplete frames over
+	bool _compare_parsers_all();
+
+	bool _compare_status(const mavlink_status_t &a, const mavlink_status_t &b);
+
+	static constexpr int MAX_MESSAGES = 32;
+	static constexpr size_t STREAM_SIZE = 4096;
+	static constexpr size_t RX_BUFFER_SIZE = 600;	///< serial receive buffer, at least twice the maximum frame size
+
+	Mavlink			_mavlink_block;		///< instance providing the channel for the frame parser
+	Mavlink			_mavlink_byte;		///< instance providing the channel for mavlink_parse_char()
+	int			_channel_block{-1};
+	int			_channel_byte{-1};
+
+	mavlink_status_t	_tx_status{};		///< status used to build the test stream
+	mavlink_signing_t	_tx_signing{};
+
+	uint8_t			_stream[STREAM_SIZE] {};
+	size_t			_stream_len{0};
+
+	mavlink_message_t	_block_msgs[MAX_MESSAGES] {};
+	mavlink_message_t	_byte_msgs[MAX_MESSAGES] {};
+};
+
+bool mavlink_frame_parser_test(void);
@@ -39,6 +39,9 @@
 #include <stdio.h>
 #include <fcntl.h>
 
+#define HEATSHRINK_DYNAMIC_ALLOC 0
+#include <lib/heatshrink/heatshrink/heatshrink_decoder.h>
+
 #include "mavlink_ftp_test.h"
 #include "../mavlink_ftp.h"
 
@@ -57,6 +60,48 @@ static const char *_test_files[] = {
 constexpr uint32_t MAX_DATA_LEN = MAVLINK_MSG_FILE_TRANSFER_PROTOCOL_FIELD_PAYLOAD_LEN - sizeof(
 		MavlinkFTP::PayloadHeader);
 
+/**
+ * Decompress a heatshrink compressed buffer
+ * @param decoded_size output: number of decompressed bytes
+ * @return false on a decoder error, or if the data does not fit into out
+ */
+static bool heatshrink_decode(uint8_t *in, size_t in_size, uint8_t *out, size_t out_size, size_t &decoded_size)
+{
+	heatshrink_decoder decoder;
+	heatshrink_decoder_reset(&decoder);
+
+	size_t in_pos = 0;
+	decoded_size = 0;
+
+	while (in_pos < in_size) {
+		size_t sunk = 0;
+
+		if (heatshrink_decoder_sink(&decoder, in + in_pos, in_size - in_pos, &sunk) < 0) {
+			return false;
+		}
+
+		in_pos += sunk;
+
+		HSD_poll_res res;
+
+		do {
+			if (decoded_size == out_size) {
+				return false;
+			}
+
+			size_t output_size = 0;
+			res = heatshrink_decoder_poll(&decoder, out + decoded_size, out_size - decoded_size, &output_size);
+			decoded_size += output_size;
+		} while (res == HSDR_POLL_MORE);
+
+		if (res < 0) {
+			return false;
+		}
+	}
+
+	return heatshrink_decoder_finish(&decoder) == HSDR_FINISH_DONE;
+}
+
 const MavlinkFtpTest::DownloadTestCase MavlinkFtpTest::_rgDownloadTestCases[] = {
 	{ _test_files[0], MAX_DATA_LEN - 1, true, false },	// Read takes less than single packet
 	{ _test_files[1], MAX_DATA_LEN,	    true, true },	// Read completely fills single packet
@@ -410,6 +455,126 @@ bool MavlinkFtpTest::_open_terminate_test()
 	return true;
 }
 
+/// @brief Tests for correct reponse to an Open command on the generated parameter files
+bool MavlinkFtpTest::_open_param_test()
+{
+	MavlinkFTP::PayloadHeader		payload {};
+	const MavlinkFTP::PayloadHeader		*reply;
+	const char				*file = "@PARAM/param.bson.hs";
+	const char				*bad_file = "@PARAM/param.txt";
+
+	payload.opcode = MavlinkFTP::kCmdOpenFileRO;
+	payload.offset = 0;
+	payload.size = strlen(file) + 1;
+
+	bool success = _send_receive_msg(&payload,	// FTP payload header
+					 (uint8_t *)file,	// Data to start into FTP message payload
+					 payload.size,	// size in bytes of data
+					 &reply);	// Payload inside FTP message response
+
+	if (!success) {
+		return false;
+	}
+
+	ut_compare("Didn't get Ack back", reply->opcode, MavlinkFTP::kRspAck);
+	ut_compare("Incorrect payload size", reply->size, sizeof(uint32_t));
+	const uint32_t size = *reinterpret_cast<const uint32_t *>(&reply->data[0]);
+	ut_assert("Empty parameter file", size > 0);
+	const uint8_t session = reply->session;
+
+	// the uncompressed export lives next to the compressed file while the session is open
+	char param_path[64];
+	struct stat st;
+	_ftp_server->_paramFilePath(param_path, sizeof(param_path));
+	ut_compare("stat failed", stat(param_path, &st), 0);
+	ut_assert("Empty uncompressed parameter file", st.st_size > 0);
+
+	uint8_t *bson = new uint8_t[st.st_size];
+	uint8_t *compressed = new uint8_t[size];
+	// one spare byte, so that a decompressed file that is too long is detected
+	uint8_t *decompressed = new uint8_t[st.st_size + 1];
+
+	int fd = ::open(param_path, O_RDONLY);
+	const bool bson_read = fd >= 0 && ::read(fd, bson, st.st_size) == st.st_size;
+
+	if (fd >= 0) {
+		::close(fd);
+	}
+
+	// download the compressed file
+	payload.opcode = MavlinkFTP::kCmdReadFile;
+	payload.session = session;
+	payload.offset = 0;
+
+	while (success && payload.offset < size) {
+		payload.size = size - payload.offset > MAX_DATA_LEN ? MAX_DATA_LEN : size - payload.offset;
+
+		success = _send_receive_msg(&payload,	// FTP payload header
+					    nullptr,	// Data to start into FTP message payload
+					    0,		// size in bytes of data
+					    &reply);	// Payload inside FTP message response
+
+		if (success && reply->opcode == MavlinkFTP::kRspAck && reply->size == payload.size) {
+			memcpy(compressed + payload.offset, reply->data, reply->size);
+			payload.offset += reply->size;
+
+		} else {
+			success = false;
+		}
+	}
+
+	size_t decompressed_size = 0;
+	const bool decoded = success && heatshrink_decode(compressed, size, decompressed, st.st_size + 1, decompressed_size);
+	const bool equal = decoded && decompressed_size == (size_t)st.st_size && memcmp(bson, decompressed, st.st_size) == 0;
+
+	delete[] bson;
+	delete[] compressed;
+	delete[] decompressed;
+
+	ut_assert("Reading the uncompressed parameter file failed", bson_read);
+	ut_assert("Download of the compressed parameter file failed", success);
+	ut_assert("Decompression failed", decoded);
+	ut_assert("Decompressed parameter file differs", equal);
+
+	payload.opcode = MavlinkFTP::kCmdTerminateSession;
+	payload.session = session;
+	payload.size = 0;
+
+	success = _send_receive_msg(&payload,	// FTP payload header
+				    nullptr,	// Data to start into FTP message payload
+				    0,		// size in bytes of data
+				    &reply);	// Payload inside FTP message response
+
+	if (!success) {
+		return false;
+	}
+
+	ut_compare("Didn't get Ack back", reply->opcode, MavlinkFTP::kRspAck);
+
+	// the generated files are removed with the session
+	ut_assert("Parameter file not removed", stat(param_path, &st) != 0);
+	strncat(param_path, ".hs", sizeof(param_path) - strlen(param_path) - 1);
+	ut_assert("Compressed parameter file not removed", stat(param_path, &st) != 0);
+
+	payload.opcode = MavlinkFTP::kCmdOpenFileRO;
+	payload.offset = 0;
+	payload.size = strlen(bad_file) + 1;
+
+	success = _send_receive_msg(&payload,	// FTP payload header
+				    (uint8_t *)bad_file,	// Data to start into FTP message payload
+				    payload.size,	// size in bytes of data
+				    &reply);	// Payload inside FTP message response
+
+	if (!success) {
+		return false;
+	}
+
+	ut_compare("Didn't get Nak back", reply->opcode, MavlinkFTP::kRspNak);
+	ut_compare("Incorrect error code", reply->data[0], MavlinkFTP::kErrFileNotFound);
+
+	return true;
+}
+
 /// @brief Tests for correct reponse to a Terminate command on an invalid session.
 bool MavlinkFtpTest::_terminate_badsession_test()
 {
@@ -1013,6 +1178,7 @@ bool MavlinkFtpTest::run_tests()
 	ut_run_test(_list_eof_test);
 	ut_run_test(_open_badfile_test);
 	ut_run_test(_open_terminate_test);
+	ut_run_test(_open_param_test);
 	ut_run_test(_terminate_badsession_test);
 	ut_run_test(_read_test);
 	ut_run_test(_read_badsession_test);
@@ -86,6 +86,7 @@ private:
 	bool _list_eof_test(void);
 	bool _open_badfile_test(void);
 	bool _open_terminate_test(void);
+	bool _open_param_test(void);
 	bool _terminate_badsession_test(void);
 	bool _read_test(void);
 	bool _read_badsession_test(void);
@@ -48,11 +48,15 @@ public:
 	const char *get_name() const override { return get_name_static(); }
 	uint16_t get_id() override { return get_id_static(); }
 
+	Priority get_priority() override { return Priority::HIGH; }
+
 	unsigned get_size() override
 	{
 		return _att_sub.advertised() ? MAVLINK_MSG_ID_ATTITUDE_LEN + MAVLINK_NUM_NON_PAYLOAD_BYTES : 0;
 	}
 
+	const orb_metadata *get_wakeup_topic() const override { return ORB_ID(vehicle_attitude); }
+
 private:
 	explicit MavlinkStreamAttitude(Mavlink *mavlink) : MavlinkStream(mavlink) {}
 
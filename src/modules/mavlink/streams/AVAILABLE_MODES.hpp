@@ -174,6 +174,8 @@ private:
 		return ret;
 	}
 
+	bool needs_polling() const override { return true; }
+
 	void update_data() override
 	{
 		// Keep track of externally registered modes
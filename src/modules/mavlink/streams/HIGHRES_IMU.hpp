@@ -60,6 +60,9 @@ public:
 		return MAVLINK_MSG_ID_HIGHRES_IMU_LEN + MAVLINK_NUM_NON_PAYLOAD_BYTES;
 	}
 
+	// wakes up on the first IMU instance, other selected instances are polled
+	const orb_metadata *get_wakeup_topic() const override { return ORB_ID(vehicle_imu); }
+
 private:
 	explicit MavlinkStreamHighresIMU(Mavlink *mavlink) : MavlinkStream(mavlink) {}
 
@@ -52,6 +52,8 @@ public:
 		return _vehicle_odometry_sub.advertised() ? MAVLINK_MSG_ID_ODOMETRY_LEN + MAVLINK_NUM_NON_PAYLOAD_BYTES : 0;
 	}
 
+	const orb_metadata *get_wakeup_topic() const override { return ORB_ID(vehicle_odometry); }
+
 private:
 	explicit MavlinkStreamOdometry(Mavlink *mavlink) : MavlinkStream(mavlink) {}
 
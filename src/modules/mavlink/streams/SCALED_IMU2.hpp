@@ -52,6 +52,8 @@ public:
 	const char *get_name() const override { return get_name_static(); }
 	uint16_t get_id() override { return get_id_static(); }
 
+	Priority get_priority() override { return Priority::LOW; }
+
 	unsigned get_size() override
 	{
 		if (_vehicle_imu_sub.advertised() || _sensor_mag_sub.advertised()) {
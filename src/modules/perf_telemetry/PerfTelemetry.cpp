@@ -0,0 +1,317 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2025 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "PerfTelemetry.hpp"
+
+#include <drivers/drv_hrt.h>
+#include <lib/mathlib/mathlib.h>
+
+#include <string.h>
+
+PerfTelemetry::PerfTelemetry() :
+	ModuleParams(nullptr),
+	ScheduledWorkItem(MODULE_NAME, px4::wq_configurations::lp_default)
+{
+}
+
+PerfTelemetry::~PerfTelemetry()
+{
+	ScheduleClear();
+	perf_free(_cycle_perf);
+
+	delete[] _counters;
+	delete[] _counters_prev;
+}
+
+bool PerfTelemetry::init()
+{
+	ScheduleOnInterval(CHUNK_INTERVAL);
+	return true;
+}
+
+uint32_t PerfTelemetry::name_hash(const char *name)
+{
+	// FNV-1a
+	uint32_t hash = 2166136261u;
+
+	while (*name != '\0') {
+		hash ^= (uint8_t) * name++;
+		hash *= 16777619u;
+	}
+
+	return hash;
+}
+
+void PerfTelemetry::count_callback(perf_counter_t handle, void *user)
+{
+	++*(int *)user;
+}
+
+void PerfTelemetry::snapshot_callback(perf_counter_t handle, void *user)
+{
+	PerfTelemetry *obj = (PerfTelemetry *)user;
+
+	if (obj->_count >= obj->_capacity) {
+		return; // counter added since the counting pass, catch it next time
+	}
+
+	Counter &counter = obj->_counters[obj->_count];
+	counter.handle = handle;
+	counter.name = perf_name(handle);
+	counter.type = perf_type(handle);
+	counter.events_total = perf_event_count(handle);
+	counter.elapsed_total = perf_elapsed_total(handle);
+	counter.max = perf_max(handle);
+
+	// find the counter in the previous snapshot, the order rarely changes (new counters are added to the front)
+	const Counter *prev = nullptr;
+
+	for (int i = 0; i < obj->_count_prev; i++) {
+		const Counter &candidate = obj->_counters_prev[(obj->_count_iterated + i) % obj->_count_prev];
+
+		if ((candidate.handle == handle) && (candidate.name == counter.name)) {
+			prev = &candidate;
+			obj->_count_iterated = (obj->_count_iterated + i + 1) % obj->_count_prev;
+			break;
+		}
+	}
+
+	if (prev != nullptr) {
+		counter.id = prev->id;
+
+		// a counter reset starts from 0 again
+		const uint64_t events = (counter.events_total >= prev->events_total) ? counter.events_total - prev->events_total :
+					counter.events_total;
+		const uint64_t elapsed = (counter.elapsed_total >= prev->elapsed_total) ? counter.elapsed_total - prev->elapsed_total :
+					 counter.elapsed_total;
+
+		counter.events = math::min(events, (uint64_t)UINT32_MAX);
+		counter.elapsed = math::min(elapsed, (uint64_t)UINT32_MAX);
+
+	} else {
+		counter.id = name_hash(counter.name);
+		counter.events = math::min(counter.events_total, (uint64_t)UINT32_MAX);
+		counter.elapsed = math::min(counter.elapsed_total, (uint64_t)UINT32_MAX);
+	}
+
+	obj->_count++;
+}
+
+bool PerfTelemetry::snapshot()
+{
+	int num_counters = 0;
+	perf_iterate_all(count_callback, &num_counters);
+
+	num_counters = math::min(num_counters, MAX_CHUNKS * MAX_COUNTERS);
+
+	if (num_counters > _capacity) {
+		// leave some room for counters allocated later
+		const int capacity = math::min(num_counters + MAX_COUNTERS, MAX_CHUNKS * MAX_COUNTERS);
+		Counter *counters = new Counter[capacity];
+		Counter *counters_prev = new Counter[capacity];
+
+		if ((counters == nullptr) || (counters_prev == nullptr)) {
+			delete[] counters;
+			delete[] counters_prev;
+			return false;
+		}
+
+		if (_count > 0) {
+			memcpy(counters, _counters, _count * sizeof(Counter));
+		}
+
+		delete[] _counters;
+		delete[] _counters_prev;
+		_counters = counters;
+		_counters_prev = counters_prev;
+		_capacity = capacity;
+	}
+
+	// the current snapshot becomes the previous one
+	Counter *tmp = _counters_prev;
+	_counters_prev = _counters;
+	_counters = tmp;
+	_count_prev = _count;
+	_count = 0;
+	_count_iterated = 0;
+
+	_timestamp_snapshot = hrt_absolute_time();
+	perf_iterate_all(snapshot_callback, this);
+
+	_num_chunks = (_count + MAX_COUNTERS - 1) / MAX_COUNTERS;
+	_next_chunk = 0;
+	_snapshot_index++;
+
+	if (_name_index >= _count) {
+		_name_index = 0;
+	}
+
+	// copy the names now, the counters could be freed until the chunks are published
+	for (int chunk = 0; chunk < _num_chunks; chunk++) {
+		const Counter &counter = _counters[_name_index];
+		strncpy(_chunk_names[chunk], counter.name, sizeof(_chunk_names[chunk]) - 1);
+		_chunk_names[chunk][sizeof(_chunk_names[chunk]) - 1] = '\0';
+		_chunk_name_ids[chunk] = counter.id;
+		_name_index = (_name_index + 1) % _count;
+	}
+
+	return _count > 0;
+}
+
+void PerfTelemetry::publish_chunk()
+{
+	perf_counters_s perf_counters{};
+	perf_counters.timestamp_snapshot = _timestamp_snapshot;
+	perf_counters.snapshot = _snapshot_index;
+	perf_counters.chunk = _next_chunk;
+	perf_counters.num_chunks = _num_chunks;
+
+	const int first = _next_chunk * MAX_COUNTERS;
+	const int count = math::min(_count - first, MAX_COUNTERS);
+	perf_counters.count = count;
+
+	for (int i = 0; i < count; i++) {
+		const Counter &counter = _counters[first + i];
+		perf_counters.id[i] = counter.id;
+		perf_counters.type[i] = counter.type;
+		perf_counters.events[i] = counter.events;
+		perf_counters.elapsed[i] = counter.elapsed;
+		perf_counters.max[i] = counter.max;
+	}
+
+	perf_counters.name_id = _chunk_name_ids[_next_chunk];
+	memcpy(perf_counters.name, _chunk_names[_next_chunk], sizeof(perf_counters.name));
+
+	perf_counters.timestamp = hrt_absolute_time();
+	_perf_counters_pub.publish(perf_counters);
+
+	_next_chunk++;
+}
+
+void PerfTelemetry::Run()
+{
+	if (should_exit()) {
+		ScheduleClear();
+		exit_and_cleanup();
+		return;
+	}
+
+	if (_parameter_update_sub.updated()) {
+		parameter_update_s param_update;
+		_parameter_update_sub.copy(&param_update);
+		updateParams();
+	}
+
+	if (_next_chunk < _num_chunks) {
+		publish_chunk();
+		return;
+	}
+
+	const hrt_abstime interval = math::max(_param_perf_tlm_intv.get(), 0.1f) * 1e6f;
+
+	if (hrt_elapsed_time(&_timestamp_snapshot) >= interval) {
+		perf_begin(_cycle_perf);
+
+		if (snapshot()) {
+			publish_chunk();
+		}
+
+		perf_end(_cycle_perf);
+	}
+}
+
+int PerfTelemetry::print_status()
+{
+	PX4_INFO("%d counters, %d chunks per snapshot, %" PRIu32 " snapshots", _count, _num_chunks, _snapshot_index);
+	perf_print_counter(_cycle_perf);
+	return 0;
+}
+
+int PerfTelemetry::task_spawn(int argc, char *argv[])
+{
+	PerfTelemetry *instance = new PerfTelemetry();
+
+	if (instance) {
+		_object.store(instance);
+		_task_id = task_id_is_work_queue;
+
+		if (instance->init()) {
+			return PX4_OK;
+		}
+
+	} else {
+		PX4_ERR("alloc failed");
+	}
+
+	delete instance;
+	_object.store(nullptr);
+	_task_id = -1;
+
+	return PX4_ERROR;
+}
+
+int PerfTelemetry::custom_command(int argc, char *argv[])
+{
+	return print_usage("unknown command");
+}
+
+int PerfTelemetry::print_usage(const char *reason)
+{
+	if (reason) {
+		PX4_WARN("%s\n", reason);
+	}
+
+	PRINT_MODULE_DESCRIPTION(
+		R"DESCR_STR(
+### Description
+Periodically takes a snapshot of all perf counters and publishes it as `perf_counters`, split into
+chunks of up to 16 counters which are published one at a time at a low rate.
+
+Each entry holds the number of events and the elapsed time since the previous snapshot, and the largest
+measurement so far. Counters are identified by the hash of their name, and each chunk also carries one
+counter name (cycling through all of them) so the ids can be resolved in post-flight analysis.
+
+The topic is logged with the perf counter logging profile (`SDLOG_PROFILE`).
+)DESCR_STR");
+
+	PRINT_MODULE_USAGE_NAME("perf_telemetry", "system");
+	PRINT_MODULE_USAGE_COMMAND("start");
+	PRINT_MODULE_USAGE_DEFAULT_COMMANDS();
+
+	return 0;
+}
+
+extern "C" __EXPORT int perf_telemetry_main(int argc, char *argv[])
+{
+	return PerfTelemetry::main(argc, argv);
+}
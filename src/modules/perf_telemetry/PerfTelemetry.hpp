@@ -0,0 +1,120 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2025 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <lib/perf/perf_counter.h>
+#include <px4_platform_common/defines.h>
+#include <px4_platform_common/module.h>
+#include <px4_platform_common/module_params.h>
+#include <px4_platform_common/px4_work_queue/ScheduledWorkItem.hpp>
+#include <uORB/Publication.hpp>
+#include <uORB/SubscriptionInterval.hpp>
+#include <uORB/topics/parameter_update.h>
+#include <uORB/topics/perf_counters.h>
+
+using namespace time_literals;
+
+class PerfTelemetry : public ModuleBase<PerfTelemetry>, public ModuleParams, public px4::ScheduledWorkItem
+{
+public:
+	PerfTelemetry();
+	~PerfTelemetry() override;
+
+	/** @see ModuleBase */
+	static int task_spawn(int argc, char *argv[]);
+
+	/** @see ModuleBase */
+	static int custom_command(int argc, char *argv[]);
+
+	/** @see ModuleBase */
+	static int print_usage(const char *reason = nullptr);
+
+	bool init();
+
+	int print_status() override;
+
+private:
+	static constexpr hrt_abstime CHUNK_INTERVAL{50_ms}; // one chunk per cycle
+	static constexpr int MAX_COUNTERS = perf_counters_s::MAX_COUNTERS;
+	static constexpr int MAX_CHUNKS = 16;
+
+	struct Counter {
+		perf_counter_t handle;
+		const char *name;
+		uint64_t events_total;
+		uint64_t elapsed_total;
+		uint32_t id;
+		uint32_t events;
+		uint32_t elapsed;
+		uint32_t max;
+		uint8_t type;
+	};
+
+	void Run() override;
+
+	/** Take a new snapshot of all perf counters, computing the deltas to the previous one. */
+	bool snapshot();
+	static void count_callback(perf_counter_t handle, void *user);
+	static void snapshot_callback(perf_counter_t handle, void *user);
+
+	/** Publish the next chunk of the current snapshot. */
+	void publish_chunk();
+
+	static uint32_t name_hash(const char *name);
+
+	Counter *_counters{nullptr};		///< current snapshot
+	Counter *_counters_prev{nullptr};	///< previous snapshot (to compute the deltas)
+	int _capacity{0};
+	int _count{0};
+	int _count_prev{0};
+	int _count_iterated{0};
+
+	char _chunk_names[MAX_CHUNKS][sizeof(perf_counters_s::name)] {};
+	uint32_t _chunk_name_ids[MAX_CHUNKS] {};
+	int _name_index{0};
+
+	uint32_t _snapshot_index{0};
+	hrt_abstime _timestamp_snapshot{0};
+	int _num_chunks{0};
+	int _next_chunk{0};
+
+	uORB::Publication<perf_counters_s> _perf_counters_pub{ORB_ID(perf_counters)};
+	uORB::SubscriptionInterval _parameter_update_sub{ORB_ID(parameter_update), 1_s};
+
+	perf_counter_t _cycle_perf{perf_alloc(PC_ELAPSED, MODULE_NAME": snapshot")};
+
+	DEFINE_PARAMETERS(
+		(ParamFloat<px4::params::PERF_TLM_INTV>) _param_perf_tlm_intv
+	)
+};
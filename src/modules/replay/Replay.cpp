@@ -48,8 +48,10 @@
 #include <px4_platform_common/shutdown.h>
 #include <lib/parameters/param.h>
 #include <uORB/uORBMessageFields.hpp>
+#include <lib/heatshrink/heatshrink/heatshrink_decoder.h> // HEATSHRINK_DYNAMIC_ALLOC is set by uORBMessageFields.hpp
 
 #include <cstring>
+#include <fcntl.h>
 #include <float.h>
 #include <fstream>
 #include <iostream>
@@ -59,6 +61,9 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include <logger/messages.h>
 
@@ -93,6 +98,8 @@ Replay::~Replay()
 	}
 
 	_subscriptions.clear();
+
+	unmapReplayFile();
 }
 
 void *
@@ -116,6 +123,137 @@ Replay::CompatSensorCombinedDtType::apply(void *data)
 	return data;
 }
 
+/**
+ * Decompress a single block of a compressed log
+ * @return true if the block decompressed to exactly out_size bytes
+ */
+static bool
+decompressBlock(heatshrink_decoder &decoder, uint8_t *in, size_t in_size, uint8_t *out, size_t out_size)
+{
+	heatshrink_decoder_reset(&decoder);
+
+	size_t in_pos = 0;
+	size_t out_pos = 0;
+
+	while (out_pos < out_size) {
+		if (in_pos < in_size) {
+			size_t sunk = 0;
+
+			if (heatshrink_decoder_sink(&decoder, in + in_pos, in_size - in_pos, &sunk) < 0) {
+				return false;
+			}
+
+			in_pos += sunk;
+		}
+
+		HSD_poll_res res;
+
+		do {
+			size_t output_size = 0;
+			res = heatshrink_decoder_poll(&decoder, out + out_pos, out_size - out_pos, &output_size);
+			out_pos += output_size;
+		} while (res == HSDR_POLL_MORE && out_pos < out_size);
+
+		if (res < 0) {
+			return false;
+		}
+
+		if (in_pos >= in_size && res == HSDR_POLL_EMPTY) {
+			break;
+		}
+	}
+
+	return out_pos == out_size;
+}
+
+/**
+ * Decompress a compressed log (written with SDLOG_COMPRESS).
+ * Blocks are decoded independently, so data of truncated or partially corrupted logs is recovered.
+ * @param decompressed_file_name output: name of the decompressed log
+ * @return true if the file is a compressed log and was decompressed
+ */
+static bool
+decompressLogFile(const char *file_name, string &decompressed_file_name)
+{
+	ifstream file(file_name, ios::in | ios::binary);
+	ulog_compressed_header_s header{};
+
+	if (!file.read((char *)&header, sizeof(header)) || memcmp(header.magic, "ULogCmp", sizeof(header.magic)) != 0) {
+		return false;
+	}
+
+	if (header.hdr_ver != 1 || header.algorithm != ULOG_COMPRESSION_HEATSHRINK
+	    || header.window_bits != HEATSHRINK_STATIC_WINDOW_BITS || header.lookahead_bits != HEATSHRINK_STATIC_LOOKAHEAD_BITS) {
+		PX4_ERR("unsupported log compression (version %i, algorithm %i)", header.hdr_ver, header.algorithm);
+		return false;
+	}
+
+	// log.ulgz -> log.ulg
+	decompressed_file_name = file_name;
+
+	if (decompressed_file_name.size() > 5 && decompressed_file_name.compare(decompressed_file_name.size() - 5, 5, ".ulgz") == 0) {
+		decompressed_file_name.pop_back();
+
+	} else {
+		decompressed_file_name += ".ulg";
+	}
+
+	ofstream out(decompressed_file_name, ios::out | ios::binary | ios::trunc);
+
+	if (!out.is_open()) {
+		PX4_ERR("Failed to open %s", decompressed_file_name.c_str());
+		return false;
+	}
+
+	heatshrink_decoder decoder;
+	std::vector<uint8_t> data;
+	std::vector<uint8_t> decompressed;
+	size_t skipped = 0;
+	size_t corrupt_blocks = 0;
+	ulog_compressed_block_s block;
+
+	while (file.read((char *)&block, sizeof(block))) {
+		if (block.magic[0] != ULOG_COMPRESSED_BLOCK_MAGIC_0 || block.magic[1] != ULOG_COMPRESSED_BLOCK_MAGIC_1) {
+			// resync on the next block
+			file.seekg(1 - (int)sizeof(block), ios::cur);
+			++skipped;
+			continue;
+		}
+
+		const streamoff block_start = (streamoff)file.tellg() - (streamoff)sizeof(block);
+		data.resize(block.data_size);
+
+		if (!file.read((char *)data.data(), data.size()) || ulog_compressed_block_crc(block, data.data()) != block.crc) {
+			// truncated, corrupt, or the magic is part of other data: resync after the magic
+			file.clear();
+			file.seekg(block_start + 1);
+			++corrupt_blocks;
+			continue;
+		}
+
+		if (block.flags & ULOG_COMPRESSED_BLOCK_FLAG_STORED) {
+			out.write((const char *)data.data(), data.size());
+
+		} else {
+			decompressed.resize(block.decompressed_size);
+
+			if (decompressBlock(decoder, data.data(), data.size(), decompressed.data(), decompressed.size())) {
+				out.write((const char *)decompressed.data(), decompressed.size());
+
+			} else {
+				++corrupt_blocks;
+			}
+		}
+	}
+
+	if (skipped > 0 || corrupt_blocks > 0) {
+		PX4_WARN("compressed log is corrupt (skipped %zu bytes, %zu blocks)", skipped, corrupt_blocks);
+	}
+
+	PX4_INFO("decompressed log to %s", decompressed_file_name.c_str());
+	return true;
+}
+
 void
 Replay::setupReplayFile(const char *file_name)
 {
@@ -123,6 +261,12 @@ Replay::setupReplayFile(const char *file_name)
 		free(_replay_file);
 	}
 
+	string decompressed_file_name;
+
+	if (decompressLogFile(file_name, decompressed_file_name)) {
+		file_name = decompressed_file_name.c_str();
+	}
+
 	_replay_file = strdup(file_name);
 }
 
@@ -298,7 +442,7 @@ Replay::readFileDefinitions(std::ifstream &file)
 			break;
 
 		case (int)ULogMessageType::ADD_LOGGED_MSG:
-			_data_section_start = file.tellg() - (streamoff)ULOG_MSG_HEADER_LEN;
+			_data_section_start = (uint64_t)((streamoff)file.tellg() - ULOG_MSG_HEADER_LEN);
 			return true;
 
 		case (int)ULogMessageType::INFO: //skip
@@ -418,33 +562,17 @@ string Replay::getOrbFields(const orb_metadata *meta)
 	return format;
 }
 
-Replay::ReadAndAndAddSubResult
-Replay::readAndAddSubscription(std::ifstream &file, uint16_t msg_size)
+Replay::Subscription *
+Replay::createSubscription(const uint8_t *message, uint16_t msg_size)
 {
-	_read_buffer.reserve(msg_size + 1);
-	uint8_t *message = _read_buffer.data();
-	streampos this_message_pos = file.tellg() - (streamoff)ULOG_MSG_HEADER_LEN;
-	file.read((char *)message, msg_size);
-	message[msg_size] = 0;
-
-	if (!file) {
-		return ReadAndAndAddSubResult::kFailure;
-	}
-
-	if (file.tellg() <= _subscription_file_pos) { //already read this subscription
-		return ReadAndAndAddSubResult::kIgnoringMsg;
-	}
-
-	_subscription_file_pos = file.tellg();
-
-	uint8_t multi_id = *(uint8_t *)message;
-	uint16_t msg_id = ((uint16_t)message[1]) | (((uint16_t)message[2]) << 8);
-	string topic_name((char *)message + 3);
+	uint8_t multi_id = message[0];
+	const char *message_name = (const char *)message + 3;
+	string topic_name(message_name, strnlen(message_name, msg_size - 3));
 	const orb_metadata *orb_meta = findTopic(topic_name);
 
 	if (!orb_meta) {
 		PX4_WARN("Topic %s not found internally. Will ignore it", topic_name.c_str());
-		return ReadAndAndAddSubResult::kIgnoringMsg;
+		return nullptr;
 	}
 
 	CompatBase *compat = nullptr;
@@ -520,7 +648,7 @@ Replay::readAndAddSubscription(std::ifstream &file, uint16_t msg_size)
 				}
 			}
 
-			return ReadAndAndAddSubResult::kIgnoringMsg; // not a fatal error
+			return nullptr; // not a fatal error
 		}
 	}
 
@@ -535,44 +663,16 @@ Replay::readAndAddSubscription(std::ifstream &file, uint16_t msg_size)
 
 	if (!timestamp_found) {
 		delete subscription;
-		return ReadAndAndAddSubResult::kIgnoringMsg;
+		return nullptr;
 	}
 
 	if (field_size != 8) {
 		PX4_ERR("Unsupported timestamp with size %i, ignoring the topic %s", field_size, orb_meta->o_name);
 		delete subscription;
-		return ReadAndAndAddSubResult::kIgnoringMsg;
+		return nullptr;
 	}
 
-	//find first data message (and the timestamp)
-	streampos cur_pos = file.tellg();
-	subscription->next_read_pos = this_message_pos; //this will be skipped
-
-	if (!nextDataMessage(file, *subscription, msg_id)) {
-		delete subscription;
-		return ReadAndAndAddSubResult::kFailure;
-	}
-
-	file.seekg(cur_pos);
-
-	if (!subscription->orb_meta) {
-		//no message found. This is not a fatal error
-		delete subscription;
-		return ReadAndAndAddSubResult::kIgnoringMsg;
-	}
-
-	PX4_DEBUG("adding subscription for %s (msg_id %i)", subscription->orb_meta->o_name, msg_id);
-
-	//add subscription
-	if (_subscriptions.size() <= msg_id) {
-		_subscriptions.resize(msg_id + 1);
-	}
-
-	_subscriptions[msg_id] = subscription;
-
-	onSubscriptionAdded(*_subscriptions[msg_id], msg_id);
-
-	return ReadAndAndAddSubResult::kSuccess;
+	return subscription;
 }
 
 bool
@@ -606,37 +706,28 @@ Replay::findFieldOffset(const string &format, const string &field_name, int &off
 	return false;
 }
 
-bool
-Replay::readAndHandleAdditionalMessages(std::ifstream &file, std::streampos end_position)
+void
+Replay::handleAdditionalMessages(uint64_t end_position)
 {
-	ulog_message_header_s message_header;
-
-	while (file.tellg() < end_position) {
-		file.read((char *)&message_header, ULOG_MSG_HEADER_LEN);
-
-		if (!file) {
-			return false;
-		}
-
-		switch (message_header.msg_type) {
-		case (int)ULogMessageType::PARAMETER:
-			if (!readAndApplyParameter(file, message_header.msg_size)) {
-				return false;
-			}
+	while (_next_additional_message < _additional_message_pos.size()
+	       && _additional_message_pos[_next_additional_message] < end_position) {
 
-			break;
+		const uint8_t *message = _file_data + _additional_message_pos[_next_additional_message];
+		ulog_message_header_s message_header;
+		memcpy(&message_header, message, ULOG_MSG_HEADER_LEN);
+		message += ULOG_MSG_HEADER_LEN;
 
-		case (int)ULogMessageType::DROPOUT:
-			readDropout(file, message_header.msg_size);
-			break;
+		if (message_header.msg_type == (int)ULogMessageType::PARAMETER) {
+			applyParameter(message, message_header.msg_size);
 
-		default: //skip all others
-			file.seekg(message_header.msg_size, ios::cur);
-			break;
+		} else if (message_header.msg_type == (int)ULogMessageType::DROPOUT && message_header.msg_size >= sizeof(uint16_t)) {
+			uint16_t duration;
+			memcpy(&duration, message, sizeof(duration));
+			PX4_ERR("Dropout in replayed log, %i ms", (int)duration);
 		}
-	}
 
-	return true;
+		++_next_additional_message;
+	}
 }
 
 bool
@@ -650,8 +741,19 @@ Replay::readAndApplyParameter(std::ifstream &file, uint16_t msg_size)
 		return false;
 	}
 
+	return applyParameter(message, msg_size);
+}
+
+bool
+Replay::applyParameter(const uint8_t *message, uint16_t msg_size)
+{
 	uint8_t key_len = message[0];
-	string key((char *)message + 1, key_len);
+
+	if (1 + key_len > msg_size) {
+		return false;
+	}
+
+	string key((const char *)message + 1, key_len);
 
 	size_t pos = key.find(' ');
 
@@ -682,98 +784,173 @@ Replay::readAndApplyParameter(std::ifstream &file, uint16_t msg_size)
 	return true;
 }
 
-bool
-Replay::readDropout(std::ifstream &file, uint16_t msg_size)
+void
+Replay::nextDataMessage(Subscription &subscription)
 {
-	uint16_t duration;
-	file.read((char *)&duration, sizeof(duration));
+	if (++subscription.next_data_message >= subscription.data_message_pos.size()) {
+		//no more data messages for this subscription
+		subscription.orb_meta = nullptr;
+		return;
+	}
 
-	PX4_ERR("Dropout in replayed log, %i ms", (int)duration);
-	return file.good();
+	subscription.next_read_pos = subscription.data_message_pos[subscription.next_data_message];
+	memcpy(&subscription.next_timestamp,
+	       _file_data + subscription.next_read_pos + ULOG_MSG_HEADER_LEN + 2 + subscription.timestamp_offset,
+	       sizeof(subscription.next_timestamp));
+	subscription.published = false;
 }
 
 bool
-Replay::nextDataMessage(std::ifstream &file, Subscription &subscription, int msg_id)
+Replay::mapReplayFile()
 {
-	ulog_message_header_s message_header;
-	file.seekg(subscription.next_read_pos);
-	//ignore the first message (it's data we already read)
-	file.read((char *)&message_header, ULOG_MSG_HEADER_LEN);
+	int fd = open(_replay_file, O_RDONLY);
 
-	if (file) {
-		file.seekg(message_header.msg_size, ios::cur);
+	if (fd < 0) {
+		PX4_ERR("Failed to open replay file");
+		return false;
 	}
 
-	uint16_t file_msg_id;
-	bool done = false;
+	struct stat file_stat;
 
-	while (file && !done) {
-		streampos cur_pos = file.tellg();
-		file.read((char *)&message_header, ULOG_MSG_HEADER_LEN);
+	if (fstat(fd, &file_stat) != 0 || file_stat.st_size == 0) {
+		close(fd);
+		return false;
+	}
 
-		if (!file) {
-			break;
-		}
+	void *data = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd); // the mapping stays valid
 
-		if (((streamoff)cur_pos) + ULOG_MSG_HEADER_LEN + message_header.msg_size > _read_until_file_position) {
-			file.setstate(std::ios::eofbit);
-			break;
+	if (data == MAP_FAILED) {
+		PX4_ERR("Failed to map replay file");
+		return false;
+	}
+
+	// the subscriptions are read interleaved, but overall the file is read front to back
+	madvise(data, file_stat.st_size, MADV_SEQUENTIAL);
+
+	_file_data = (const uint8_t *)data;
+	_file_size = file_stat.st_size;
+	return true;
+}
+
+void
+Replay::unmapReplayFile()
+{
+	if (_file_data) {
+		munmap((void *)_file_data, _file_size);
+		_file_data = nullptr;
+		_file_size = 0;
+	}
+}
+
+size_t
+Replay::indexDataSection()
+{
+	const uint64_t end_position = std::min((uint64_t)_file_size, (uint64_t)_read_until_file_position);
+	uint64_t pos = _data_section_start;
+	size_t num_data_messages = 0;
+
+	while (pos + ULOG_MSG_HEADER_LEN <= end_position) {
+		ulog_message_header_s message_header;
+		memcpy(&message_header, _file_data + pos, ULOG_MSG_HEADER_LEN);
+		const uint8_t *message = _file_data + pos + ULOG_MSG_HEADER_LEN;
+
+		if (pos + ULOG_MSG_HEADER_LEN + message_header.msg_size > end_position) {
+			break; // truncated message
 		}
 
 		switch (message_header.msg_type) {
+		case (int)ULogMessageType::ADD_LOGGED_MSG:
+			if (message_header.msg_size > 3) {
+				const uint16_t msg_id = ((uint16_t)message[1]) | (((uint16_t)message[2]) << 8);
+
+				if (_subscriptions.size() <= msg_id) {
+					_subscriptions.resize(msg_id + 1);
+				}
+
+				// a msg_id can be reused after a REMOVE_LOGGED_MSG
+				if (_subscriptions[msg_id]) {
+					delete _subscriptions[msg_id]->compat;
+					delete _subscriptions[msg_id];
+				}
+
+				_subscriptions[msg_id] = createSubscription(message, message_header.msg_size);
+			}
+
+			break;
+
 		case (int)ULogMessageType::DATA:
-			file.read((char *)&file_msg_id, sizeof(file_msg_id));
+			if (message_header.msg_size >= sizeof(uint16_t)) {
+				const uint16_t msg_id = ((uint16_t)message[0]) | (((uint16_t)message[1]) << 8);
+				Subscription *subscription = (msg_id < _subscriptions.size()) ? _subscriptions[msg_id] : nullptr;
 
-			if (file) {
-				if (msg_id == file_msg_id) {
-					if (message_header.msg_size == subscription.orb_meta->o_size_no_padding + 2) {
-						subscription.next_read_pos = cur_pos;
-						file.seekg(subscription.timestamp_offset, ios::cur);
-						file.read((char *)&subscription.next_timestamp, sizeof(subscription.next_timestamp));
-						subscription.published = false;
-						done = true;
+				if (subscription) {
+					if (message_header.msg_size == subscription->orb_meta->o_size_no_padding + 2) {
+						subscription->data_message_pos.push_back(pos);
+						++num_data_messages;
 
 					} else { //sanity check failed!
 						PX4_ERR("data message %s has wrong size %i (expected %i). Skipping",
-							subscription.orb_meta->o_name, message_header.msg_size,
-							subscription.orb_meta->o_size_no_padding + 2);
-						file.seekg(message_header.msg_size - sizeof(file_msg_id), ios::cur);
+							subscription->orb_meta->o_name, message_header.msg_size,
+							subscription->orb_meta->o_size_no_padding + 2);
 					}
-
-				} else { //not the one we are looking for
-					file.seekg(message_header.msg_size - sizeof(file_msg_id), ios::cur);
 				}
 			}
 
 			break;
 
-		case (int)ULogMessageType::REMOVE_LOGGED_MSG: //skip these
-		case (int)ULogMessageType::ADD_LOGGED_MSG:
 		case (int)ULogMessageType::PARAMETER:
 		case (int)ULogMessageType::DROPOUT:
+			_additional_message_pos.push_back(pos);
+			break;
+
+		case (int)ULogMessageType::REMOVE_LOGGED_MSG: //skip these
 		case (int)ULogMessageType::INFO:
 		case (int)ULogMessageType::INFO_MULTIPLE:
 		case (int)ULogMessageType::SYNC:
 		case (int)ULogMessageType::LOGGING:
+		case (int)ULogMessageType::LOGGING_TAGGED:
 		case (int)ULogMessageType::PARAMETER_DEFAULT:
-			file.seekg(message_header.msg_size, ios::cur);
 			break;
 
 		default:
 			//this really should not happen
-			PX4_ERR("unknown log message type %i, size %i (offset %i)",
-				(int)message_header.msg_type, (int)message_header.msg_size, (int)file.tellg());
-			file.seekg(message_header.msg_size, ios::cur);
+			PX4_ERR("unknown log message type %i, size %i (offset %" PRIu64 ")",
+				(int)message_header.msg_type, (int)message_header.msg_size, pos);
 			break;
 		}
+
+		pos += ULOG_MSG_HEADER_LEN + message_header.msg_size;
 	}
 
-	if (file.eof()) { //no more data messages for this subscription
-		subscription.orb_meta = nullptr;
-		file.clear();
+	// set each subscription to its first data message
+	for (size_t msg_id = 0; msg_id < _subscriptions.size(); ++msg_id) {
+		Subscription *subscription = _subscriptions[msg_id];
+
+		if (!subscription) {
+			continue;
+		}
+
+		if (subscription->data_message_pos.empty()) {
+			//no message found. This is not a fatal error
+			delete subscription->compat;
+			delete subscription;
+			_subscriptions[msg_id] = nullptr;
+			continue;
+		}
+
+		subscription->data_message_pos.shrink_to_fit();
+		subscription->next_data_message = 0;
+		subscription->next_read_pos = subscription->data_message_pos[0];
+		memcpy(&subscription->next_timestamp,
+		       _file_data + subscription->next_read_pos + ULOG_MSG_HEADER_LEN + 2 + subscription->timestamp_offset,
+		       sizeof(subscription->next_timestamp));
+
+		PX4_DEBUG("adding subscription for %s (msg_id %i)", subscription->orb_meta->o_name, (int)msg_id);
+		onSubscriptionAdded(*subscription, msg_id);
 	}
 
-	return file.good();
+	return num_data_messages;
 }
 
 const orb_metadata *
@@ -896,43 +1073,28 @@ Replay::run()
 		_speed_factor = atof(speedup);
 	}
 
+	replay_file.close();
+
+	if (!mapReplayFile()) {
+		return;
+	}
+
 	onEnterMainLoop();
 
 	_replay_start_time = hrt_absolute_time();
 
 	PX4_INFO("Replay in progress...");
 
-	// Find and add all subscriptions
-	ulog_message_header_s message_header;
-	replay_file.seekg(_data_section_start);
-
-	while (true) {
-		//we are in the Definition & Data Section Message Header section
-		replay_file.read((char *)&message_header, ULOG_MSG_HEADER_LEN);
-
-		if (!replay_file) {
-			// end of file
-			break;
-		}
+	// Find and add all subscriptions, and index their messages
+	const size_t num_data_messages = indexDataSection();
 
-		if (message_header.msg_type == (int)ULogMessageType::ADD_LOGGED_MSG) {
-			readAndAddSubscription(replay_file, message_header.msg_size);
-
-		} else {
-			// Not important for now, skip
-			replay_file.seekg(message_header.msg_size, ios::cur);
-		}
-	}
-
-	// Rewind back to the begining of the data section
-	replay_file.seekg(_data_section_start);
-	replay_file.clear();
+	PX4_INFO("Indexed %zu data messages (%.1f MB) in %.3lf s", num_data_messages, (double)_file_size / 1.e6,
+		 (double)hrt_elapsed_time(&_replay_start_time) / 1.e6);
 
 	const uint64_t timestamp_offset = getTimestampOffset();
 	uint32_t nr_published_messages = 0;
-	streampos last_additional_message_pos = _data_section_start;
 
-	while (!should_exit() && replay_file) {
+	while (!should_exit()) {
 
 		//Find the next message to publish. Messages from different subscriptions don't need
 		//to be in chronological order, so we need to check all subscriptions
@@ -964,15 +1126,12 @@ Replay::run()
 
 		if (next_file_time == 0 || next_file_time < _file_start_time) {
 			//someone didn't set the timestamp properly. Consider the message invalid
-			nextDataMessage(replay_file, sub, next_msg_id);
+			nextDataMessage(sub);
 			continue;
 		}
 
 		//handle additional messages between last and next published data
-		replay_file.seekg(last_additional_message_pos);
-		streampos next_additional_message_pos = sub.next_read_pos;
-		readAndHandleAdditionalMessages(replay_file, next_additional_message_pos);
-		last_additional_message_pos = next_additional_message_pos;
+		handleAdditionalMessages(sub.next_read_pos);
 
 		// Perform scheduled parameter changes
 		while (_next_param_change < _dynamic_parameter_schedule.size() &&
@@ -988,14 +1147,14 @@ Replay::run()
 		const uint64_t publish_timestamp = handleTopicDelay(next_file_time, timestamp_offset);
 
 		// It's time to publish
-		readTopicDataToBuffer(sub, replay_file);
+		readTopicDataToBuffer(sub);
 		memcpy(_read_buffer.data() + sub.timestamp_offset, &publish_timestamp, sizeof(uint64_t)); //adjust the timestamp
 
-		if (handleTopicUpdate(sub, _read_buffer.data(), replay_file)) {
+		if (handleTopicUpdate(sub, _read_buffer.data())) {
 			++nr_published_messages;
 		}
 
-		nextDataMessage(replay_file, sub, next_msg_id);
+		nextDataMessage(sub);
 
 		// TODO: output status (eg. every sec), including total duration...
 	}
@@ -1017,14 +1176,16 @@ Replay::run()
 	}
 
 	if (!should_exit()) {
-		PX4_INFO("Replay done (published %u msgs, %.3lf s)", nr_published_messages,
-			 (double)hrt_elapsed_time(&_replay_start_time) / 1.e6);
+		const double elapsed_s = (double)hrt_elapsed_time(&_replay_start_time) / 1.e6;
+		PX4_INFO("Replay done (published %u msgs, %.3lf s, %.1f MB/s)", nr_published_messages, elapsed_s,
+			 (double)_file_size / 1.e6 / elapsed_s);
 	}
 
 	onExitMainLoop();
 
+	unmapReplayFile();
+
 	if (!should_exit()) {
-		replay_file.close();
 		px4_shutdown_request();
 		// we need to ensure the shutdown logic gets updated and eventually triggers shutdown
 		hrt_abstime t = hrt_absolute_time();
@@ -1039,17 +1200,16 @@ Replay::run()
 }
 
 void
-Replay::readTopicDataToBuffer(const Subscription &sub, std::ifstream &replay_file)
+Replay::readTopicDataToBuffer(const Subscription &sub)
 {
 	const size_t msg_read_size = sub.orb_meta->o_size_no_padding;
 	const size_t msg_write_size = sub.orb_meta->o_size;
 	_read_buffer.reserve(msg_write_size);
-	replay_file.seekg(sub.next_read_pos + (streamoff)(ULOG_MSG_HEADER_LEN + 2)); //skip header & msg id
-	replay_file.read((char *)_read_buffer.data(), msg_read_size);
+	memcpy(_read_buffer.data(), _file_data + sub.next_read_pos + ULOG_MSG_HEADER_LEN + 2, msg_read_size); //skip header & msg id
 }
 
 bool
-Replay::handleTopicUpdate(Subscription &sub, void *data, std::ifstream &replay_file)
+Replay::handleTopicUpdate(Subscription &sub, void *data)
 {
 	return publishTopic(sub, data);
 }
@@ -51,9 +51,9 @@ namespace px4
 /**
  * @class Replay
  * Parses an ULog file and replays it in 'real-time'. The timestamp of each replayed message is offset
- * to match the starting time of replay. It keeps a stream for each subscription to find the next message
- * to replay. This is necessary because data messages from different subscriptions don't need to be in
- * monotonic increasing order.
+ * to match the starting time of replay. The file is memory mapped and indexed once: each subscription
+ * keeps the file offsets of its data messages to find the next message to replay. This is necessary
+ * because data messages from different subscriptions don't need to be in monotonic increasing order.
  */
 class Replay : public ModuleBase<Replay>
 {
@@ -88,6 +88,7 @@ public:
 	 * Tell the replay module that we want to use replay mode.
 	 * After that, only 'replay start' must be executed (typically the last step after startup).
 	 * @param file_name file name of the used log replay file. Will be copied.
+	 * Compressed logs (.ulgz) are decompressed to a .ulg file next to it first.
 	 */
 	static void setupReplayFile(const char *file_name);
 
@@ -134,9 +135,12 @@ protected:
 
 		bool ignored = false; ///< if true, it will not be considered for publication in the main loop
 
-		std::streampos next_read_pos;
+		uint64_t next_read_pos; ///< file offset of the next data message
 		uint64_t next_timestamp; ///< timestamp of the file
 
+		std::vector<uint64_t> data_message_pos; ///< file offsets of all the data messages of this subscription
+		size_t next_data_message = 0; ///< index of next_read_pos in data_message_pos
+
 		CompatBase *compat = nullptr;
 
 		// statistics
@@ -191,21 +195,18 @@ protected:
 	 * handle the publication of a topic update
 	 * @return true if published, false otherwise
 	 */
-	virtual bool handleTopicUpdate(Subscription &sub, void *data, std::ifstream &replay_file);
+	virtual bool handleTopicUpdate(Subscription &sub, void *data);
 
 	/**
 	 * read a topic from the file (offset given by the subscription) into _read_buffer
 	 */
-	void readTopicDataToBuffer(const Subscription &sub, std::ifstream &replay_file);
+	void readTopicDataToBuffer(const Subscription &sub);
 
 	/**
-	 * Find next data message for this subscription, starting with the stored file offset.
-	 * Skip the first message, and if found, read the timestamp and store the new file offset.
-	 * When reaching EOF, the subscription is set to invalid.
-	 * File seek position is arbitrary after this call.
-	 * @return false on file error
+	 * Advance the subscription to its next data message in the index, and read its timestamp.
+	 * When reaching the last message, the subscription is set to invalid.
 	 */
-	bool nextDataMessage(std::ifstream &file, Subscription &subscription, int msg_id);
+	void nextDataMessage(Subscription &subscription);
 
 	virtual uint64_t getTimestampOffset()
 	{
@@ -242,13 +243,16 @@ private:
 
 	uint64_t _file_start_time;
 	uint64_t _replay_start_time;
-	std::streampos _data_section_start; ///< first ADD_LOGGED_MSG message
-
-	/** keep track of file position to avoid adding a subscription multiple times. */
-	std::streampos _subscription_file_pos = 0;
+	uint64_t _data_section_start; ///< first ADD_LOGGED_MSG message
 
 	int64_t _read_until_file_position = 1ULL << 60; ///< read limit if log contains appended data
 
+	const uint8_t *_file_data{nullptr}; ///< memory mapped replay file
+	size_t _file_size{0};
+
+	std::vector<uint64_t> _additional_message_pos; ///< file offsets of the parameter and dropout messages
+	size_t _next_additional_message{0};
+
 	float _accumulated_delay{0.f};
 
 	bool readFileHeader(std::ifstream &file);
@@ -263,8 +267,11 @@ private:
 	///file parsing methods. They return false, when further parsing should be aborted.
 	bool readFormat(std::ifstream &file, uint16_t msg_size);
 
-	enum class ReadAndAndAddSubResult : uint8_t { kSuccess, kIgnoringMsg, kFailure };
-	ReadAndAndAddSubResult readAndAddSubscription(std::ifstream &file, uint16_t msg_size);
+	/**
+	 * Create the subscription of an ADD_LOGGED_MSG message
+	 * @return nullptr if the topic is ignored
+	 */
+	Subscription *createSubscription(const uint8_t *message, uint16_t msg_size);
 	bool readFlagBits(std::ifstream &file, uint16_t msg_size);
 
 	/**
@@ -274,15 +281,24 @@ private:
 	 */
 	bool readDefinitionsAndApplyParams(std::ifstream &file);
 
+	bool mapReplayFile();
+	void unmapReplayFile();
+
+	/**
+	 * Read the data section once: add the subscriptions and store the file offsets of their data messages,
+	 * and of the parameter and dropout messages.
+	 * @return number of indexed data messages
+	 */
+	size_t indexDataSection();
+
 	/**
-	 * Read and handle additional messages starting at current file position, while position < end_position.
+	 * Handle the additional messages of the index, while the file position < end_position.
 	 * This handles dropout and parameter update messages.
 	 * We need to handle these separately, because they have no timestamp. We look at the file position instead.
-	 * @return false on file error
 	 */
-	bool readAndHandleAdditionalMessages(std::ifstream &file, std::streampos end_position);
-	bool readDropout(std::ifstream &file, uint16_t msg_size);
+	void handleAdditionalMessages(uint64_t end_position);
 	bool readAndApplyParameter(std::ifstream &file, uint16_t msg_size);
+	bool applyParameter(const uint8_t *message, uint16_t msg_size);
 
 	static const orb_metadata *findTopic(const std::string &name);
 
@@ -60,13 +60,13 @@ namespace px4
 {
 
 bool
-ReplayEkf2::handleTopicUpdate(Subscription &sub, void *data, std::ifstream &replay_file)
+ReplayEkf2::handleTopicUpdate(Subscription &sub, void *data)
 {
 	if (sub.orb_meta == ORB_ID(ekf2_timestamps)) {
 		ekf2_timestamps_s ekf2_timestamps;
 		memcpy(&ekf2_timestamps, data, sub.orb_meta->o_size);
 
-		if (!publishEkf2Topics(ekf2_timestamps, replay_file)) {
+		if (!publishEkf2Topics(ekf2_timestamps)) {
 			return false;
 		}
 
@@ -80,7 +80,7 @@ ReplayEkf2::handleTopicUpdate(Subscription &sub, void *data, std::ifstream &repl
 		sensor_combined_s sensor_combined;
 		memcpy(&sensor_combined, data, sub.orb_meta->o_size);
 
-		if (!publishEkf2Topics(sensor_combined, replay_file)) {
+		if (!publishEkf2Topics(sensor_combined)) {
 			return false;
 		}
 
@@ -149,15 +149,15 @@ ReplayEkf2::onSubscriptionAdded(Subscription &sub, uint16_t msg_id)
 }
 
 bool
-ReplayEkf2::publishEkf2Topics(sensor_combined_s &sensor_combined, std::ifstream &replay_file)
+ReplayEkf2::publishEkf2Topics(sensor_combined_s &sensor_combined)
 {
-	findTimestampAndPublish(sensor_combined.timestamp, _airspeed_msg_id, replay_file);
-	findTimestampAndPublish(sensor_combined.timestamp, _distance_sensor_msg_id, replay_file);
-	findTimestampAndPublish(sensor_combined.timestamp, _optical_flow_msg_id, replay_file);
-	findTimestampAndPublish(sensor_combined.timestamp, _vehicle_air_data_msg_id, replay_file);
-	findTimestampAndPublish(sensor_combined.timestamp, _vehicle_magnetometer_msg_id, replay_file);
-	findTimestampAndPublish(sensor_combined.timestamp, _vehicle_visual_odometry_msg_id, replay_file);
-	findTimestampAndPublish(sensor_combined.timestamp, _aux_global_position_msg_id, replay_file);
+	findTimestampAndPublish(sensor_combined.timestamp, _airspeed_msg_id);
+	findTimestampAndPublish(sensor_combined.timestamp, _distance_sensor_msg_id);
+	findTimestampAndPublish(sensor_combined.timestamp, _optical_flow_msg_id);
+	findTimestampAndPublish(sensor_combined.timestamp, _vehicle_air_data_msg_id);
+	findTimestampAndPublish(sensor_combined.timestamp, _vehicle_magnetometer_msg_id);
+	findTimestampAndPublish(sensor_combined.timestamp, _vehicle_visual_odometry_msg_id);
+	findTimestampAndPublish(sensor_combined.timestamp, _aux_global_position_msg_id);
 
 	// sensor_combined: publish last because ekf2 is polling on this
 	if (_last_sensor_combined_timestamp > 0) {
@@ -175,13 +175,13 @@ ReplayEkf2::publishEkf2Topics(sensor_combined_s &sensor_combined, std::ifstream
 }
 
 bool
-ReplayEkf2::publishEkf2Topics(const ekf2_timestamps_s &ekf2_timestamps, std::ifstream &replay_file)
+ReplayEkf2::publishEkf2Topics(const ekf2_timestamps_s &ekf2_timestamps)
 {
 	auto handle_sensor_publication = [&](int16_t timestamp_relative, uint16_t msg_id) {
 		if (timestamp_relative != ekf2_timestamps_s::RELATIVE_TIMESTAMP_INVALID) {
 			// timestamp_relative is given in 0.1 ms
 			uint64_t t = timestamp_relative * 100 + ekf2_timestamps.timestamp;
-			findTimestampAndPublish(t, msg_id, replay_file);
+			findTimestampAndPublish(t, msg_id);
 		}
 	};
 
@@ -198,7 +198,7 @@ ReplayEkf2::publishEkf2Topics(const ekf2_timestamps_s &ekf2_timestamps, std::ifs
 	handle_sensor_publication(0, _vehicle_attitude_groundtruth_msg_id);
 
 	// sensor_combined: publish last because ekf2 is polling on this
-	if (!findTimestampAndPublish(ekf2_timestamps.timestamp, _sensor_combined_msg_id, replay_file)) {
+	if (!findTimestampAndPublish(ekf2_timestamps.timestamp, _sensor_combined_msg_id)) {
 		if (_sensor_combined_msg_id == msg_id_invalid) {
 			// subscription not found yet or sensor_combined not contained in log
 			return false;
@@ -208,7 +208,7 @@ ReplayEkf2::publishEkf2Topics(const ekf2_timestamps_s &ekf2_timestamps, std::ifs
 
 		} else {
 			// we should publish a topic, just publish the same again
-			readTopicDataToBuffer(*_subscriptions[_sensor_combined_msg_id], replay_file);
+			readTopicDataToBuffer(*_subscriptions[_sensor_combined_msg_id]);
 			publishTopic(*_subscriptions[_sensor_combined_msg_id], _read_buffer.data());
 		}
 	}
@@ -217,7 +217,7 @@ ReplayEkf2::publishEkf2Topics(const ekf2_timestamps_s &ekf2_timestamps, std::ifs
 }
 
 bool
-ReplayEkf2::findTimestampAndPublish(uint64_t timestamp, uint16_t msg_id, std::ifstream &replay_file)
+ReplayEkf2::findTimestampAndPublish(uint64_t timestamp, uint16_t msg_id)
 {
 	if (msg_id == msg_id_invalid) {
 		// could happen if a topic is not logged
@@ -238,12 +238,12 @@ ReplayEkf2::findTimestampAndPublish(uint64_t timestamp, uint16_t msg_id, std::if
 				++sub.approx_timestamp_counter;
 			}
 
-			readTopicDataToBuffer(sub, replay_file);
+			readTopicDataToBuffer(sub);
 			publishTopic(sub, _read_buffer.data());
 			topic_published = true;
 		}
 
-		nextDataMessage(replay_file, sub, msg_id);
+		nextDataMessage(sub);
 	}
 
 	return topic_published;
@@ -62,7 +62,11 @@ void DataValidator::put(uint64_t timestamp, const float val[dimensions], uint32_
 	}
 
 	_error_count = error_count_in;
-	_priority = priority_in;
+
+	if (priority_in != _priority) {
+		_priority = priority_in;
+		_vote_changed = true;
+	}
 
 	for (unsigned i = 0; i < dimensions; i++) {
 		if (PX4_ISFINITE(val[i])) {
@@ -77,7 +81,6 @@ void DataValidator::put(uint64_t timestamp, const float val[dimensions], uint32_
 				float delta_val = lp_val - _mean[i];
 				_mean[i] += delta_val / _event_count;
 				_M2[i] += delta_val * (lp_val - _mean[i]);
-				_rms[i] = sqrtf(_M2[i] / (_event_count - 1));
 
 				if (fabsf(_value[i] - val[i]) < 0.000001f) {
 					_value_equal_count++;
@@ -136,11 +139,32 @@ float DataValidator::confidence(uint64_t timestamp)
 		if (ret > 0.0f) {
 			_error_mask = ERROR_FLAG_NO_ERROR;
 		}
+
+		if (ret >= 1.0f) {
+			_time_last_healthy = _time_last;
+		}
+	}
+
+	if (fabsf(ret - _confidence) > 0.f) {
+		_confidence = ret;
+		_vote_changed = true;
 	}
 
 	return ret;
 }
 
+float *DataValidator::rms()
+{
+	// only computed on request, the running sum of squares (_M2) is updated with every sample
+	if (_event_count > 1) {
+		for (unsigned i = 0; i < dimensions; i++) {
+			_rms[i] = sqrtf(_M2[i] / (_event_count - 1));
+		}
+	}
+
+	return _rms;
+}
+
 void DataValidator::print()
 {
 	if (_time_last == 0) {
@@ -148,6 +172,8 @@ void DataValidator::print()
 		return;
 	}
 
+	rms();
+
 	for (unsigned i = 0; i < dimensions; i++) {
 		PX4_INFO_RAW("\tval: %8.4f, lp: %8.4f mean dev: %8.4f RMS: %8.4f conf: %8.4f\n", (double)_value[i],
 			     (double)_lp[i], (double)_mean[i], (double)_rms[i], (double)confidence(hrt_absolute_time()));
@@ -85,6 +85,29 @@ public:
 	 */
 	float confidence(uint64_t timestamp);
 
+	/**
+	 * Get the confidence computed by the last call of confidence()
+	 * @return		the confidence between 0 and 1
+	 */
+	float last_confidence() const { return _confidence; }
+
+	/**
+	 * Check whether the confidence or priority changed since the last call (used by the group to skip the vote)
+	 * @return		true if changed
+	 */
+	bool vote_changed()
+	{
+		const bool changed = _vote_changed;
+		_vote_changed = false;
+		return changed;
+	}
+
+	/**
+	 * Get the timestamp of the last data received with full confidence
+	 * @return		timestamp in microseconds or 0 if never
+	 */
+	uint64_t time_last_healthy() const { return _time_last_healthy; }
+
 	/**
 	 * Get the error count of this validator
 	 * @return		the error count
@@ -124,7 +147,7 @@ public:
 	 * Get the RMS values of this validator
 	 * @return		the stored RMS
 	 */
-	float *rms() { return _rms; }
+	float *rms();
 
 	/**
 	 * Print the validator value
@@ -169,6 +192,7 @@ private:
 	uint32_t _timeout_interval{40000}; /**< interval in which the datastream times out in us */
 
 	uint64_t _time_last{0};   /**< last timestamp */
+	uint64_t _time_last_healthy{0}; /**< last timestamp with full confidence */
 	uint64_t _event_count{0}; /**< total data counter */
 	uint32_t _error_count{0}; /**< error count */
 
@@ -176,6 +200,9 @@ private:
 
 	uint8_t _priority{0}; /**< sensor nominal priority */
 
+	float _confidence{0.f}; /**< confidence of the last confidence() call */
+	bool _vote_changed{true}; /**< confidence or priority changed since the last vote */
+
 	float _mean[dimensions] {}; /**< mean of value */
 	float _lp[dimensions] {};   /**< low pass value */
 	float _M2[dimensions] {};   /**< RMS component value */
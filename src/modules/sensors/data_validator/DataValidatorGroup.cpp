@@ -92,6 +92,7 @@ DataValidator *DataValidatorGroup::add_new_validator()
 	_last->setSibling(validator);
 	_last = validator;
 	_last->set_timeout(_timeout_interval_us);
+	_vote_stable = false;
 	return _last;
 }
 
@@ -139,6 +140,20 @@ void DataValidatorGroup::put(unsigned index, uint64_t timestamp, const float val
 
 float *DataValidatorGroup::get_best(uint64_t timestamp, int *index)
 {
+	// update the confidence of all validators (this also sets their error state, e.g. on timeout)
+	bool vote_changed = false;
+
+	for (DataValidator *next = _first; next != nullptr; next = next->sibling()) {
+		next->confidence(timestamp);
+		vote_changed = next->vote_changed() || vote_changed;
+	}
+
+	// the vote only depends on the confidence and priority of the validators and on the currently best one,
+	// if none of them changed since the last vote (without switch) the result is the same
+	if (!vote_changed && _vote_stable) {
+		*index = _curr_best;
+		return (_best) ? _best->value() : nullptr;
+	}
 
 	DataValidator *next = _first;
 
@@ -150,6 +165,7 @@ float *DataValidatorGroup::get_best(uint64_t timestamp, int *index)
 	int max_priority = -1000;
 	int max_index = -1;
 	DataValidator *best = nullptr;
+	DataValidator *pre_check = nullptr;
 
 	int i = 0;
 
@@ -157,10 +173,11 @@ float *DataValidatorGroup::get_best(uint64_t timestamp, int *index)
 	while (next != nullptr) {
 		if (i == pre_check_best) {
 			const int prio = next->priority();
-			const float confidence = next->confidence(timestamp);
+			const float confidence = next->last_confidence();
 
 			pre_check_prio = prio;
 			pre_check_confidence = confidence;
+			pre_check = next;
 
 			max_index = i;
 			max_confidence = confidence;
@@ -177,7 +194,7 @@ float *DataValidatorGroup::get_best(uint64_t timestamp, int *index)
 	next = _first;
 
 	while (next != nullptr) {
-		float confidence = next->confidence(timestamp);
+		float confidence = next->last_confidence();
 
 		/*
 		 * Switch if:
@@ -198,9 +215,13 @@ float *DataValidatorGroup::get_best(uint64_t timestamp, int *index)
 		i++;
 	}
 
+	_vote_stable = true;
+
 	/* the current best sensor is not matching the previous best sensor,
 	 * or the only sensor went bad */
 	if (max_index != _curr_best || ((max_confidence < FLT_EPSILON) && (_curr_best >= 0))) {
+		_vote_stable = false;
+
 		bool true_failsafe = true;
 
 		/* check whether the switch was a failsafe or preferring a higher priority sensor */
@@ -231,6 +252,14 @@ float *DataValidatorGroup::get_best(uint64_t timestamp, int *index)
 					_first_failover_time = timestamp;
 				}
 
+				/* time from the last data with full confidence of the failed sensor to the failover */
+				if ((pre_check != nullptr) && (pre_check->time_last_healthy() != 0) && (timestamp > pre_check->time_last_healthy())) {
+					_failover_latency_us = timestamp - pre_check->time_last_healthy();
+
+				} else {
+					_failover_latency_us = 0;
+				}
+
 				if (max_confidence < FLT_EPSILON) {
 					max_index = -1;
 				}
@@ -241,6 +270,8 @@ float *DataValidatorGroup::get_best(uint64_t timestamp, int *index)
 		_curr_best = max_index;
 	}
 
+	_best = best;
+
 	*index = max_index;
 	return (best) ? best->value() : nullptr;
 }
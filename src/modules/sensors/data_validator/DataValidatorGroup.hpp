@@ -83,6 +83,13 @@ public:
 	 */
 	unsigned failover_count() const { return _toggle_count; }
 
+	/**
+	 * Get the latency of the last failover decision
+	 *
+	 * @return		time from the last data with full confidence of the failed sensor to the failover in microseconds
+	 */
+	uint64_t failover_latency_us() const { return _failover_latency_us; }
+
 	/**
 	 * Get the index of the failed sensor in the group
 	 *
@@ -140,6 +147,11 @@ private:
 	int _curr_best{-1}; /**< currently best index */
 	int _prev_best{-1}; /**< the previous best index */
 
+	DataValidator *_best{nullptr}; /**< currently best validator */
+	bool _vote_stable{false}; /**< the last vote kept the best index, it can be reused until a confidence or priority changes */
+
+	uint64_t _failover_latency_us{0}; /**< latency of the last failover decision */
+
 	uint64_t _first_failover_time{0}; /**< timestamp where the first failover occured or zero if none occured */
 
 	unsigned _toggle_count{0}; /**< number of back and forth switches between two sensors */
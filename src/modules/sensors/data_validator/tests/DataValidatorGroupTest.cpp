@@ -0,0 +1,213 @@
+/****************************************************************************
+ *
+ *   Copyright (C) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file DataValidatorGroupTest.cpp
+ * Sensor voting of the DataValidatorGroup, and benchmark of a vote
+ * Run this test only using make tests TESTFILTER=DataValidatorGroup
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+#include "../DataValidatorGroup.hpp"
+
+static constexpr uint32_t TIMEOUT_US = 2000;
+static constexpr uint64_t DT_US = 1000;
+
+class DataValidatorGroupTest : public ::testing::Test
+{
+public:
+	DataValidatorGroupTest() : _group(1)
+	{
+		_group.add_new_validator();
+		_group.add_new_validator();
+		_group.add_new_validator();
+		_group.set_timeout(TIMEOUT_US);
+	}
+
+	void put(unsigned index, uint32_t error_count = 0, uint8_t priority = 50)
+	{
+		// changing values, so that the sensor isn't considered stale
+		const float val[3] {0.001f * (_sample++ % 1000) + index, 1.f, 2.f};
+		_group.put(index, _timestamp, val, error_count, priority);
+	}
+
+	DataValidatorGroup _group;
+	uint64_t _timestamp{1000};
+	unsigned _sample{0};
+};
+
+TEST_F(DataValidatorGroupTest, selectFirstHealthy)
+{
+	int best = -1;
+
+	for (int i = 0; i < 10; i++) {
+		_timestamp += DT_US;
+		put(0);
+		put(1);
+		EXPECT_NE(_group.get_best(_timestamp, &best), nullptr);
+		EXPECT_EQ(best, 0);
+	}
+
+	EXPECT_EQ(_group.failover_count(), 0u);
+}
+
+TEST_F(DataValidatorGroupTest, failoverOnTimeout)
+{
+	int best = -1;
+
+	for (int i = 0; i < 10; i++) {
+		_timestamp += DT_US;
+		put(0);
+		put(1);
+		_group.get_best(_timestamp, &best);
+	}
+
+	const uint64_t timestamp_last_data = _timestamp;
+
+	// sensor 0 stops publishing
+	while (_timestamp + DT_US <= timestamp_last_data + TIMEOUT_US) {
+		_timestamp += DT_US;
+		put(1);
+		_group.get_best(_timestamp, &best);
+		EXPECT_EQ(best, 0);
+	}
+
+	_timestamp += DT_US;
+	put(1);
+	_group.get_best(_timestamp, &best);
+
+	EXPECT_EQ(best, 1);
+	EXPECT_EQ(_group.failover_count(), 1u);
+	EXPECT_EQ(_group.failover_index(), 0);
+	EXPECT_TRUE(_group.failover_state() & DataValidator::ERROR_FLAG_TIMEOUT);
+	EXPECT_EQ(_group.failover_latency_us(), _timestamp - timestamp_last_data);
+
+	// the vote is kept while nothing changes
+	for (int i = 0; i < 10; i++) {
+		_timestamp += DT_US;
+		put(1);
+		_group.get_best(_timestamp, &best);
+		EXPECT_EQ(best, 1);
+	}
+
+	EXPECT_EQ(_group.failover_count(), 1u);
+}
+
+TEST_F(DataValidatorGroupTest, failoverOnErrorDensity)
+{
+	int best = -1;
+	uint32_t error_count = 0;
+
+	for (int i = 0; i < 10; i++) {
+		_timestamp += DT_US;
+		put(0);
+		put(1);
+		_group.get_best(_timestamp, &best);
+	}
+
+	const uint64_t timestamp_last_healthy = _timestamp;
+
+	// errors on sensor 0 lower its confidence below the one of sensor 1
+	_timestamp += DT_US;
+	error_count += 2;
+	put(0, error_count);
+	put(1);
+	_group.get_best(_timestamp, &best);
+
+	EXPECT_EQ(best, 1);
+	EXPECT_EQ(_group.failover_count(), 1u);
+	EXPECT_EQ(_group.failover_latency_us(), _timestamp - timestamp_last_healthy);
+}
+
+TEST_F(DataValidatorGroupTest, higherPriorityIsNoFailover)
+{
+	int best = -1;
+
+	for (int i = 0; i < 10; i++) {
+		_timestamp += DT_US;
+		put(0, 0, 50);
+		_group.get_best(_timestamp, &best);
+		EXPECT_EQ(best, 0);
+	}
+
+	// sensor with a higher priority coming online late
+	for (int i = 0; i < 10; i++) {
+		_timestamp += DT_US;
+		put(0, 0, 50);
+		put(2, 0, 75);
+		_group.get_best(_timestamp, &best);
+		EXPECT_EQ(best, 2);
+	}
+
+	EXPECT_EQ(_group.failover_count(), 0u);
+
+	// priority of the selected sensor lowered (e.g. by the user), the vote is redone
+	for (int i = 0; i < 10; i++) {
+		_timestamp += DT_US;
+		put(0, 0, 50);
+		put(2, 0, 25);
+		_group.get_best(_timestamp, &best);
+	}
+
+	EXPECT_EQ(best, 0);
+}
+
+TEST_F(DataValidatorGroupTest, benchmark)
+{
+	// 4 healthy sensors at 1 kHz, cost of putting the samples of all sensors and voting
+	static constexpr int NUM_VOTES = 100000;
+	int best = -1;
+
+	const auto start = std::chrono::steady_clock::now();
+
+	for (int i = 0; i < NUM_VOTES; i++) {
+		_timestamp += DT_US;
+
+		for (unsigned index = 0; index < 4; index++) {
+			put(index);
+		}
+
+		_group.get_best(_timestamp, &best);
+	}
+
+	const auto end = std::chrono::steady_clock::now();
+
+	EXPECT_EQ(best, 0);
+	EXPECT_EQ(_group.failover_count(), 0u);
+
+	printf("put 4 sensors + vote: %.1f ns\n", std::chrono::duration<double, std::nano>(end - start).count() / NUM_VOTES);
+}
@@ -722,8 +722,9 @@ void VehicleAngularVelocity::UpdateDynamicNotchFFT(const hrt_abstime &time_now_u
 #endif // !CONSTRAINED_FLASH
 }
 
-float VehicleAngularVelocity::FilterAngularVelocity(int axis, float data[], int N)
+Vector3f VehicleAngularVelocity::FilterAngularVelocity(math::BiquadBank3::Sample data[], int N)
 {
+	// all 3 axes are filtered together, each filter stage is skipped for the axes where it is disabled
 #if !defined(CONSTRAINED_FLASH)
 
 	// Apply dynamic notch filter from ESC RPM
@@ -731,9 +732,9 @@ float VehicleAngularVelocity::FilterAngularVelocity(int axis, float data[], int
 		for (int esc = 0; esc < MAX_NUM_ESCS; esc++) {
 			if (_esc_available[esc]) {
 				for (int harmonic = 0; harmonic < _esc_rpm_harmonics; harmonic++) {
-					if (_dynamic_notch_filter_esc_rpm[harmonic][axis][esc].getNotchFreq() > 0.f) {
-						_dynamic_notch_filter_esc_rpm[harmonic][axis][esc].applyArray(data, N);
-					}
+					math::BiquadBank3::applyNotch(_dynamic_notch_filter_esc_rpm[harmonic][0][esc],
+								      _dynamic_notch_filter_esc_rpm[harmonic][1][esc],
+								      _dynamic_notch_filter_esc_rpm[harmonic][2][esc], data, N);
 				}
 			}
 		}
@@ -742,40 +743,38 @@ float VehicleAngularVelocity::FilterAngularVelocity(int axis, float data[], int
 	// Apply dynamic notch filter from FFT
 	if (_dynamic_notch_fft_available) {
 		for (int peak = MAX_NUM_FFT_PEAKS - 1; peak >= 0; peak--) {
-			if (_dynamic_notch_filter_fft[axis][peak].getNotchFreq() > 0.f) {
-				_dynamic_notch_filter_fft[axis][peak].applyArray(data, N);
-			}
+			math::BiquadBank3::applyNotch(_dynamic_notch_filter_fft[0][peak], _dynamic_notch_filter_fft[1][peak],
+						      _dynamic_notch_filter_fft[2][peak], data, N);
 		}
 	}
 
 #endif // !CONSTRAINED_FLASH
 
 	// Apply general notch filter 0 (IMU_GYRO_NF0_FRQ)
-	if (_notch_filter0_velocity[axis].getNotchFreq() > 0.f) {
-		_notch_filter0_velocity[axis].applyArray(data, N);
-	}
+	math::BiquadBank3::applyNotch(_notch_filter0_velocity[0], _notch_filter0_velocity[1], _notch_filter0_velocity[2],
+				      data, N);
 
 	// Apply general notch filter 1 (IMU_GYRO_NF1_FRQ)
-	if (_notch_filter1_velocity[axis].getNotchFreq() > 0.f) {
-		_notch_filter1_velocity[axis].applyArray(data, N);
-	}
+	math::BiquadBank3::applyNotch(_notch_filter1_velocity[0], _notch_filter1_velocity[1], _notch_filter1_velocity[2],
+				      data, N);
 
 	// Apply general low-pass filter (IMU_GYRO_CUTOFF)
-	_lp_filter_velocity[axis].applyArray(data, N);
+	math::BiquadBank3::applyLowPass(_lp_filter_velocity, data, N);
 
 	// return last filtered sample
-	return data[N - 1];
+	return Vector3f{data[N - 1][0], data[N - 1][1], data[N - 1][2]};
 }
 
-float VehicleAngularVelocity::FilterAngularAcceleration(int axis, float inverse_dt_s, float data[], int N)
+float VehicleAngularVelocity::FilterAngularAcceleration(int axis, float inverse_dt_s,
+		const math::BiquadBank3::Sample data[], int N)
 {
 	// angular acceleration: Differentiate & apply specific angular acceleration (D-term) low-pass (IMU_DGYRO_CUTOFF)
 	float angular_acceleration_filtered = 0.f;
 
 	for (int n = 0; n < N; n++) {
-		const float angular_acceleration = (data[n] - _angular_velocity_raw_prev(axis)) * inverse_dt_s;
+		const float angular_acceleration = (data[n][axis] - _angular_velocity_raw_prev(axis)) * inverse_dt_s;
 		angular_acceleration_filtered = _lp_filter_acceleration[axis].update(angular_acceleration);
-		_angular_velocity_raw_prev(axis) = data[n];
+		_angular_velocity_raw_prev(axis) = data[n][axis];
 	}
 
 	return angular_acceleration_filtered;
@@ -836,18 +835,19 @@ void VehicleAngularVelocity::Run()
 				Vector3f angular_velocity_uncalibrated;
 				Vector3f angular_acceleration_uncalibrated;
 
-				int16_t *raw_data_array[] {sensor_fifo_data.x, sensor_fifo_data.y, sensor_fifo_data.z};
+				// copy raw int16 sensor samples to interleaved float array for filtering
+				math::BiquadBank3::Sample data[FIFO_SIZE_MAX];
 
-				for (int axis = 0; axis < 3; axis++) {
-					// copy raw int16 sensor samples to float array for filtering
-					float data[FIFO_SIZE_MAX];
+				for (int n = 0; n < N; n++) {
+					data[n] = math::BiquadBank3::Sample{sensor_fifo_data.scale * sensor_fifo_data.x[n],
+									    sensor_fifo_data.scale * sensor_fifo_data.y[n],
+									    sensor_fifo_data.scale * sensor_fifo_data.z[n]};
+				}
 
-					for (int n = 0; n < N; n++) {
-						data[n] = sensor_fifo_data.scale * raw_data_array[axis][n];
-					}
+				// save last filtered sample
+				angular_velocity_uncalibrated = FilterAngularVelocity(data, N);
 
-					// save last filtered sample
-					angular_velocity_uncalibrated(axis) = FilterAngularVelocity(axis, data, N);
+				for (int axis = 0; axis < 3; axis++) {
 					angular_acceleration_uncalibrated(axis) = FilterAngularAcceleration(axis, inverse_dt_s, data, N);
 				}
 
@@ -885,14 +885,13 @@ void VehicleAngularVelocity::Run()
 				Vector3f angular_velocity_uncalibrated;
 				Vector3f angular_acceleration_uncalibrated;
 
-				float raw_data_array[] {sensor_data.x, sensor_data.y, sensor_data.z};
+				// copy sensor sample to float array for filtering
+				math::BiquadBank3::Sample data[1] {{sensor_data.x, sensor_data.y, sensor_data.z}};
 
-				for (int axis = 0; axis < 3; axis++) {
-					// copy sensor sample to float array for filtering
-					float data[1] {raw_data_array[axis]};
+				// save last filtered sample
+				angular_velocity_uncalibrated = FilterAngularVelocity(data);
 
-					// save last filtered sample
-					angular_velocity_uncalibrated(axis) = FilterAngularVelocity(axis, data);
+				for (int axis = 0; axis < 3; axis++) {
 					angular_acceleration_uncalibrated(axis) = FilterAngularAcceleration(axis, inverse_dt_s, data);
 				}
 
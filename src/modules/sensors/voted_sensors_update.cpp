@@ -67,6 +67,12 @@ VotedSensorsUpdate::VotedSensorsUpdate(bool hil_enabled,
 	parametersUpdate();
 }
 
+VotedSensorsUpdate::~VotedSensorsUpdate()
+{
+	perf_free(_voting_perf);
+	perf_free(_failover_latency_perf);
+}
+
 void VotedSensorsUpdate::initializeSensors()
 {
 	initSensorClass(_gyro, MAX_SENSOR_COUNT);
@@ -192,8 +198,10 @@ void VotedSensorsUpdate::imuPoll(struct sensor_combined_s &raw)
 
 	if (!_parameter_update) {
 		// update current accel/gyro selection, skipped on cycles where parameters update
+		perf_begin(_voting_perf);
 		_accel.voter.get_best(time_now_us, &accel_best_index);
 		_gyro.voter.get_best(time_now_us, &gyro_best_index);
+		perf_end(_voting_perf);
 
 		if (!_param_sens_imu_mode.get() && ((_selection.timestamp != 0) || (_sensor_selection_sub.updated()))) {
 			// use sensor_selection to find best
@@ -290,6 +298,8 @@ bool VotedSensorsUpdate::checkFailover(SensorData &sensor, const char *sensor_na
 {
 	if (sensor.last_failover_count != sensor.voter.failover_count() && !_hil_enabled) {
 
+		perf_set_elapsed(_failover_latency_perf, sensor.voter.failover_latency_us());
+
 		uint32_t flags = sensor.voter.failover_state();
 		int failover_index = sensor.voter.failover_index();
 
@@ -394,6 +404,10 @@ void VotedSensorsUpdate::printStatus()
 	PX4_INFO_RAW("\n");
 	PX4_INFO_RAW("selected accel: %" PRIu32 " (%" PRIu8 ")\n", _selection.accel_device_id, _accel.last_best_vote);
 	_accel.voter.print();
+
+	PX4_INFO_RAW("\n");
+	perf_print_counter(_voting_perf);
+	perf_print_counter(_failover_latency_perf);
 }
 
 void VotedSensorsUpdate::sensorsPoll(sensor_combined_s &raw)
@@ -45,6 +45,7 @@
 #include <px4_platform_common/events.h>
 #include <px4_platform_common/module_params.h>
 #include <drivers/drv_hrt.h>
+#include <lib/perf/perf_counter.h>
 #include <mathlib/mathlib.h>
 #include <matrix/math.hpp>
 #include <uORB/Publication.hpp>
@@ -77,6 +78,7 @@ public:
 	 * Only when calling init(), they have to be initialized.
 	 */
 	VotedSensorsUpdate(bool hil_enabled, uORB::SubscriptionCallbackWorkItem(&vehicle_imu_sub)[MAX_SENSOR_COUNT]);
+	~VotedSensorsUpdate();
 
 	/**
 	 * This tries to find new sensor instances. This is called from init(), then it can be called periodically.
@@ -178,6 +180,9 @@ private:
 
 	bool _parameter_update{false};
 
+	perf_counter_t _voting_perf{perf_alloc(PC_ELAPSED, MODULE_NAME": voting")};
+	perf_counter_t _failover_latency_perf{perf_alloc(PC_ELAPSED, MODULE_NAME": failover latency")};
+
 	DEFINE_PARAMETERS(
 		(ParamBool<px4::params::SENS_IMU_MODE>) _param_sens_imu_mode
 	)
@@ -36,15 +36,47 @@
 #include <px4_platform_common/getopt.h>
 #include <px4_platform_common/px4_work_queue/WorkQueueManager.hpp>
 
+#include "work_queue_trace.hpp"
+
 static void	usage();
 
 extern "C" {
 	__EXPORT int work_queue_main(int argc, char *argv[]);
 }
 
+#if defined(CONFIG_PX4_WORK_QUEUE_TRACE)
+static int
+trace_command(int argc, char *argv[])
+{
+	if (argc >= 2 && !strcmp(argv[0], "dump")) {
+		return work_queue_trace_dump(argv[1]);
+
+	} else if (!strcmp(argv[0], "start")) {
+		return WorkQueueTraceStreamer::start();
+
+	} else if (!strcmp(argv[0], "stop")) {
+		return WorkQueueTraceStreamer::stop();
+
+	} else if (!strcmp(argv[0], "status")) {
+		return WorkQueueTraceStreamer::status();
+	}
+
+	usage();
+	return 1;
+}
+#endif // CONFIG_PX4_WORK_QUEUE_TRACE
+
 int
 work_queue_main(int argc, char *argv[])
 {
+#if defined(CONFIG_PX4_WORK_QUEUE_TRACE)
+
+	if (argc >= 3 && !strcmp(argv[1], "trace")) {
+		return trace_command(argc - 2, argv + 2);
+	}
+
+#endif // CONFIG_PX4_WORK_QUEUE_TRACE
+
 	if (argc != 2) {
 		usage();
 		return 1;
@@ -78,9 +110,15 @@ usage()
 
 Command-line tool to show work queue status.
 
+If the work queue tracing is enabled (CONFIG_PX4_WORK_QUEUE_TRACE), the run and wakeup events of all work items
+are recorded in a ring buffer per work queue. The trace can be written to a file in the Chrome trace format
+(POSIX only, open with https://ui.perfetto.dev), or streamed to the log (work_item_trace topic).
+
 )DESCR_STR");
 
 	PRINT_MODULE_USAGE_NAME("work_queue", "system");
 	PRINT_MODULE_USAGE_COMMAND("start");
+	PRINT_MODULE_USAGE_COMMAND_DESCR("trace", "Work item trace (requires CONFIG_PX4_WORK_QUEUE_TRACE)");
+	PRINT_MODULE_USAGE_ARG("dump <file>|start|stop|status", "Dump to a JSON file, or start/stop streaming to the log", false);
 	PRINT_MODULE_USAGE_DEFAULT_COMMANDS();
 }
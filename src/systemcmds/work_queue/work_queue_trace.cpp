@@ -0,0 +1,357 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2025 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "work_queue_trace.hpp"
+
+#if defined(CONFIG_PX4_WORK_QUEUE_TRACE)
+
+#include <px4_platform_common/log.h>
+#include <px4_platform_common/time.h>
+#include <uORB/topics/uORBTopics.hpp>
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+using namespace time_literals;
+using px4::WorkQueue;
+using px4::WorkQueueTrace;
+
+static const char *topic_name(uint16_t orb_id)
+{
+	if (orb_id == WorkQueueTrace::ORB_ID_TIMER) {
+		return "timer";
+	}
+
+	if (orb_id < ORB_TOPICS_COUNT) {
+		return get_orb_meta((ORB_ID)orb_id)->o_name;
+	}
+
+	return "unknown";
+}
+
+#if defined(__PX4_POSIX)
+struct trace_dump_s {
+	FILE *file;
+	bool first;
+	uint32_t events;
+};
+
+static void trace_dump_callback(const WorkQueue &wq, int index, void *user)
+{
+	trace_dump_s *dump = (trace_dump_s *)user;
+	const WorkQueueTrace &trace = wq.trace();
+
+	// name the thread (tid) after the work queue
+	fprintf(dump->file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+		dump->first ? "" : ",\n", index, wq.get_name());
+	dump->first = false;
+
+	const uint32_t head = trace.head();
+
+	for (uint32_t i = trace.tail(); i < head; i++) {
+		WorkQueueTrace::Event event;
+
+		if (!trace.read(i, event)) {
+			continue;
+		}
+
+		const char *item = WorkQueueTrace::item_name(event.item_id);
+
+		switch (event.type) {
+		case WorkQueueTrace::EventType::Wakeup:
+			fprintf(dump->file, ",\n{\"name\":\"%s\",\"cat\":\"wakeup\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%" PRIu64
+				",\"pid\":1,\"tid\":%d,\"args\":{\"item\":\"%s\"}}",
+				topic_name(event.orb_id), event.timestamp, index, item);
+			break;
+
+		case WorkQueueTrace::EventType::RunBegin:
+		case WorkQueueTrace::EventType::RunEnd:
+			fprintf(dump->file, ",\n{\"name\":\"%s\",\"cat\":\"run\",\"ph\":\"%s\",\"ts\":%" PRIu64 ",\"pid\":1,\"tid\":%d}",
+				item, (event.type == WorkQueueTrace::EventType::RunBegin) ? "B" : "E", event.timestamp, index);
+			break;
+		}
+
+		dump->events++;
+	}
+}
+
+int work_queue_trace_dump(const char *path)
+{
+	trace_dump_s dump{};
+	dump.file = fopen(path, "w");
+
+	if (dump.file == nullptr) {
+		PX4_ERR("failed to open %s", path);
+		return -1;
+	}
+
+	dump.first = true;
+
+	fprintf(dump.file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+	px4::WorkQueueManagerTraceIterate(trace_dump_callback, &dump);
+	fprintf(dump.file, "\n]}\n");
+
+	fclose(dump.file);
+
+	PX4_INFO("%" PRIu32 " events written to %s", dump.events, path);
+	return 0;
+}
+
+#else
+
+int work_queue_trace_dump(const char *path)
+{
+	PX4_ERR("not supported, use 'work_queue trace start' to log the trace");
+	return -1;
+}
+
+#endif // __PX4_POSIX
+
+px4::atomic<WorkQueueTraceStreamer *> WorkQueueTraceStreamer::_instance{nullptr};
+pthread_mutex_t WorkQueueTraceStreamer::_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+WorkQueueTraceStreamer::WorkQueueTraceStreamer() :
+	ScheduledWorkItem("wq_trace", px4::wq_configurations::lp_default)
+{
+}
+
+WorkQueueTraceStreamer::~WorkQueueTraceStreamer()
+{
+	ScheduleClear();
+}
+
+int WorkQueueTraceStreamer::start()
+{
+	pthread_mutex_lock(&_mutex);
+
+	int ret = 0;
+
+	if (_instance.load() == nullptr) {
+		WorkQueueTraceStreamer *streamer = new WorkQueueTraceStreamer();
+
+		if (streamer) {
+			_instance.store(streamer);
+			streamer->ScheduleOnInterval(20_ms);
+
+		} else {
+			PX4_ERR("alloc failed");
+			ret = -1;
+		}
+	}
+
+	pthread_mutex_unlock(&_mutex);
+	return ret;
+}
+
+int WorkQueueTraceStreamer::stop()
+{
+	pthread_mutex_lock(&_mutex);
+	WorkQueueTraceStreamer *streamer = _instance.load();
+
+	if (streamer == nullptr) {
+		pthread_mutex_unlock(&_mutex);
+		return 0;
+	}
+
+	// the streamer deletes itself in Run(), deleting it here could race with a Run() in progress
+	streamer->_should_exit.store(true);
+	streamer->ScheduleNow();
+	pthread_mutex_unlock(&_mutex);
+
+	for (int i = 0; i < 100; i++) {
+		if (_instance.load() == nullptr) {
+			return 0;
+		}
+
+		px4_usleep(10_ms);
+	}
+
+	PX4_ERR("timeout stopping");
+	return -1;
+}
+
+int WorkQueueTraceStreamer::status()
+{
+	pthread_mutex_lock(&_mutex);
+	WorkQueueTraceStreamer *streamer = _instance.load();
+
+	if (streamer) {
+		streamer->print_status();
+
+	} else {
+		PX4_INFO("not streaming");
+	}
+
+	pthread_mutex_unlock(&_mutex);
+	return 0;
+}
+
+void WorkQueueTraceStreamer::print_status()
+{
+	PX4_INFO("streaming %d work queues, %" PRIu32 " events", _num_queues, _events_streamed);
+
+	for (int i = 0; i < _num_queues; i++) {
+		PX4_INFO_RAW("  %-24s dropped: %" PRIu32 "\n", _queues[i].name, _queues[i].dropped);
+	}
+}
+
+void WorkQueueTraceStreamer::Run()
+{
+	if (_should_exit.load()) {
+		pthread_mutex_lock(&_mutex);
+		ScheduleClear();
+		_instance.store(nullptr);
+		delete this;
+		pthread_mutex_unlock(&_mutex);
+		return;
+	}
+
+	_publications = 0;
+
+	for (int i = 0; i < _num_queues; i++) {
+		_queues[i].active = false;
+	}
+
+	px4::WorkQueueManagerTraceIterate(stream_callback, this);
+
+	// forget the queues that got deleted, a new queue with the same name starts with a new trace
+	int num_queues = 0;
+
+	for (int i = 0; i < _num_queues; i++) {
+		if (_queues[i].active) {
+			_queues[num_queues++] = _queues[i];
+		}
+	}
+
+	_num_queues = num_queues;
+}
+
+void WorkQueueTraceStreamer::stream_callback(const WorkQueue &wq, int index, void *user)
+{
+	((WorkQueueTraceStreamer *)user)->stream(wq, index);
+}
+
+void WorkQueueTraceStreamer::stream(const WorkQueue &wq, int index)
+{
+	const WorkQueueTrace &trace = wq.trace();
+
+	QueueState *state = nullptr;
+
+	for (int i = 0; i < _num_queues; i++) {
+		if (strncmp(_queues[i].name, wq.get_name(), sizeof(_queues[i].name) - 1) == 0) {
+			state = &_queues[i];
+			break;
+		}
+	}
+
+	if (state == nullptr) {
+		if (_num_queues >= MAX_QUEUES) {
+			return;
+		}
+
+		state = &_queues[_num_queues++];
+		strncpy(state->name, wq.get_name(), sizeof(state->name) - 1);
+		state->name[sizeof(state->name) - 1] = '\0';
+		state->next = trace.head(); // start with new events only
+		state->dropped = 0;
+	}
+
+	state->active = true;
+
+	if (state->next > trace.head()) {
+		// the queue was recreated in between (new trace)
+		state->next = trace.head();
+	}
+
+	const uint32_t head = trace.head();
+
+	while ((state->next < head) && (_publications < MAX_PUBLICATIONS_PER_CYCLE)) {
+		work_item_trace_s msg{};
+		msg.queue = index;
+		strncpy(msg.queue_name, state->name, sizeof(msg.queue_name) - 1);
+
+		while ((state->next < head) && (msg.count < work_item_trace_s::MAX_EVENTS)) {
+			WorkQueueTrace::Event event;
+			const uint32_t requested = state->next;
+
+			if (!trace.read(state->next, event)) {
+				if (state->next != requested) {
+					// overwritten, continue with the oldest available event
+					state->dropped += state->next - requested;
+					continue;
+				}
+
+				break; // still being written
+			}
+
+			if (msg.count == 0) {
+				msg.timestamp_base = event.timestamp;
+			}
+
+			msg.dt[msg.count] = event.timestamp - msg.timestamp_base;
+			msg.item_id[msg.count] = event.item_id;
+			msg.orb_id[msg.count] = event.orb_id;
+			msg.type[msg.count] = (uint8_t)event.type;
+			msg.count++;
+			state->next++;
+		}
+
+		if (msg.count == 0) {
+			break;
+		}
+
+		msg.dropped = state->dropped;
+		publish(msg);
+	}
+}
+
+void WorkQueueTraceStreamer::publish(work_item_trace_s &msg)
+{
+	// cycle through the item names, so the ids can be resolved
+	if (_name_item_id >= WorkQueueTrace::item_count()) {
+		_name_item_id = 0;
+	}
+
+	msg.name_item_id = _name_item_id;
+	strncpy(msg.name, WorkQueueTrace::item_name(_name_item_id), sizeof(msg.name) - 1);
+	_name_item_id++;
+
+	_events_streamed += msg.count;
+
+	msg.timestamp = hrt_absolute_time();
+	_work_item_trace_pub.publish(msg);
+	_publications++;
+}
+
+#endif // CONFIG_PX4_WORK_QUEUE_TRACE
@@ -0,0 +1,107 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2025 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file work_queue_trace.hpp
+ *
+ * Export of the work queue traces (CONFIG_PX4_WORK_QUEUE_TRACE): a Chrome/Perfetto JSON dump,
+ * and a streamer publishing the trace events as work_item_trace so they get logged.
+ */
+
+#pragma once
+
+#include <px4_platform_common/atomic.h>
+#include <px4_platform_common/px4_work_queue/ScheduledWorkItem.hpp>
+#include <px4_platform_common/px4_work_queue/WorkQueue.hpp>
+#include <uORB/Publication.hpp>
+#include <uORB/topics/work_item_trace.h>
+
+#if defined(CONFIG_PX4_WORK_QUEUE_TRACE)
+
+/**
+ * Write the events currently in the trace buffers as a Chrome JSON trace
+ * (load with chrome://tracing or https://ui.perfetto.dev).
+ * @return 0 on success, -1 otherwise
+ */
+int work_queue_trace_dump(const char *path);
+
+class WorkQueueTraceStreamer : public px4::ScheduledWorkItem
+{
+public:
+	/** start streaming (if not running yet) */
+	static int start();
+
+	/** stop streaming, returns once the streamer has exited */
+	static int stop();
+
+	static int status();
+
+private:
+	static constexpr int MAX_QUEUES = 32;
+	static constexpr int MAX_PUBLICATIONS_PER_CYCLE = work_item_trace_s::ORB_QUEUE_LENGTH;
+
+	/* stream state of a queue: keyed by the name, queues can be deleted (and the index shifts) at any time */
+	struct QueueState {
+		char name[sizeof(work_item_trace_s::queue_name)];
+		uint32_t next;		///< index of the next event to stream
+		uint32_t dropped;
+		bool active;		///< queue seen in the current cycle
+	};
+
+	WorkQueueTraceStreamer();
+	~WorkQueueTraceStreamer() override;
+
+	void Run() override;
+
+	void print_status();
+
+	static void stream_callback(const px4::WorkQueue &wq, int index, void *user);
+	void stream(const px4::WorkQueue &wq, int index);
+	void publish(work_item_trace_s &msg);
+
+	QueueState _queues[MAX_QUEUES] {};
+	int _num_queues{0};
+
+	int _publications{0};		///< publications in the current cycle
+	uint16_t _name_item_id{0};
+	uint32_t _events_streamed{0};
+
+	px4::atomic_bool _should_exit{false};
+
+	uORB::Publication<work_item_trace_s> _work_item_trace_pub{ORB_ID(work_item_trace)};
+
+	static px4::atomic<WorkQueueTraceStreamer *> _instance;
+	static pthread_mutex_t _mutex; ///< protects the instance against deletion while accessed from the shell
+};
+
+#endif // CONFIG_PX4_WORK_QUEUE_TRACE